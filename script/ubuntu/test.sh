@@ -40,5 +40,469 @@ for test in $(ls src/test/c/reject/); do
 done
 echo ""
 
+echo "Compiler should accept, evaluating only..."
+echo ""
+
+for test in $(ls src/test/c/accept/); do
+	cat "src/test/c/accept/$test" | build/Compiler --evaluate >/dev/null 2>&1
+	RESULT="$?"
+	if [ "$RESULT" == "0" ]; then
+		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
+	else
+		STATUS=1
+		echo -e "    $test, ${RED}but it rejects${OFF} (status $RESULT)"
+	fi
+done
+echo ""
+
+echo "Compiler should reject, evaluating only..."
+echo ""
+
+for test in $(ls src/test/c/reject/); do
+	cat "src/test/c/reject/$test" | build/Compiler --evaluate >/dev/null 2>&1
+	RESULT="$?"
+	if [ "$RESULT" != "0" ]; then
+		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
+	else
+		STATUS=1
+		echo -e "    $test, ${RED}but it accepts${OFF} (status $RESULT)"
+	fi
+done
+echo ""
+
+echo "Compiler should compile a program file (or a pipe), as from the standard input..."
+echo ""
+
+for program in src/test/c/accept/* src/test/c/reject/*; do
+	test="$(basename "$(dirname "$program")")/$(basename "$program")"
+	for arguments in "" "--evaluate"; do
+		EXPECTED="$(cat "$program" | build/Compiler $arguments 2>/dev/null; echo "status $?")"
+		RESULT="$(build/Compiler $arguments "$program" 2>/dev/null; echo "status $?")"
+		PIPED="$(build/Compiler $arguments <(cat "$program") 2>/dev/null; echo "status $?")"
+		if [ "$RESULT" == "$EXPECTED" ] && [ "$PIPED" == "$EXPECTED" ]; then
+			echo -e "    $test${arguments:+ $arguments}, ${GREEN}and it does${OFF} (${RESULT##*$'\n'})"
+		else
+			STATUS=1
+			echo -e "    $test${arguments:+ $arguments}, ${RED}but it does not${OFF} (${RESULT##*$'\n'})"
+		fi
+	done
+done
+echo ""
+
+echo "Compiler should compile with a pipelined frontend, as with an interleaved one..."
+echo ""
+
+for program in src/test/c/accept/* src/test/c/reject/*; do
+	test="$(basename "$(dirname "$program")")/$(basename "$program")"
+	for arguments in "" "--evaluate"; do
+		EXPECTED="$(PIPELINED_FRONTEND=false build/Compiler $arguments "$program" 2>&1; echo "status $?")"
+		RESULT="$(PIPELINED_FRONTEND=true build/Compiler $arguments "$program" 2>&1; echo "status $?")"
+		if [ "$RESULT" == "$EXPECTED" ]; then
+			echo -e "    $test${arguments:+ $arguments}, ${GREEN}and it does${OFF} (${RESULT##*$'\n'})"
+		else
+			STATUS=1
+			echo -e "    $test${arguments:+ $arguments}, ${RED}but it does not${OFF} (${RESULT##*$'\n'})"
+		fi
+	done
+done
+echo ""
+
+echo "Compiler should stream the output, as it generates it from the tree..."
+echo ""
+
+# Besides the test programs, some whose spilled tree doesn't fit in memory (so
+# it's read back from a temporary file): a balanced one, a long chain
+# ("1 - 1 - ..."), and a right-nested one ("1 + (1 + (...))").
+PROGRAM="$(mktemp)"
+SPILLED="1"
+for level in $(seq 12); do
+	SPILLED="($SPILLED + $level) - ($SPILLED * $level)"
+done
+echo "$SPILLED" > "$PROGRAM"
+CHAIN="$(mktemp)"
+{ echo -n "1"; for term in $(seq 6000); do echo -n " - 1"; done; echo ""; } > "$CHAIN"
+NESTED="$(mktemp)"
+{ for level in $(seq 4000); do echo -n "1 + ("; done; echo -n "1"; for level in $(seq 4000); do echo -n ")"; done; echo ""; } > "$NESTED"
+for program in src/test/c/accept/* src/test/c/reject/* "$PROGRAM" "$CHAIN" "$NESTED"; do
+	test="$(basename "$(dirname "$program")")/$(basename "$program")"
+	[ "$program" == "$PROGRAM" ] && test="spilled-program"
+	[ "$program" == "$CHAIN" ] && test="spilled-chain"
+	[ "$program" == "$NESTED" ] && test="spilled-nested"
+	EXPECTED="$(build/Compiler "$program" 2>/dev/null | md5sum; echo "status ${PIPESTATUS[0]}")"
+	RESULT="$(STREAM_OUTPUT=true build/Compiler "$program" 2>/dev/null | md5sum; echo "status ${PIPESTATUS[0]}")"
+	if [ "$RESULT" == "$EXPECTED" ]; then
+		echo -e "    $test, ${GREEN}and it does${OFF} (${RESULT##*$'\n'})"
+	else
+		STATUS=1
+		echo -e "    $test, ${RED}but it does not${OFF} (${RESULT##*$'\n'})"
+	fi
+done
+rm -f "$PROGRAM" "$CHAIN" "$NESTED"
+echo ""
+
+echo "Compiler should compile a saved tree, as the program itself..."
+echo ""
+
+TREE="$(mktemp)"
+for program in src/test/c/accept/* src/test/c/reject/*; do
+	test="$(basename "$(dirname "$program")")/$(basename "$program")"
+	for arguments in "" "--evaluate"; do
+		rm -f "$TREE"
+		EXPECTED="$(build/Compiler $arguments "$program" 2>/dev/null; echo "status $?")"
+		RESULT="$(build/Compiler --save-tree="$TREE" "$program" 2>/dev/null && build/Compiler $arguments --load-tree="$TREE" 2>/dev/null; echo "status $?")"
+		if [ "$RESULT" == "$EXPECTED" ]; then
+			echo -e "    $test${arguments:+ $arguments}, ${GREEN}and it does${OFF} (${RESULT##*$'\n'})"
+		else
+			STATUS=1
+			echo -e "    $test${arguments:+ $arguments}, ${RED}but it does not${OFF} (${RESULT##*$'\n'})"
+		fi
+	done
+done
+rm -f "$TREE"
+echo ""
+
+echo "Compiler should reject a corrupted tree..."
+echo ""
+
+# Each case is a program, and the bytes written over its tree file, at an
+# offset: the nodes start after the header (24 bytes), in post-order, and
+# each one has its pointers first, its parentheses at 16 and its type at 20.
+TREE="$(mktemp)"
+CORRUPTIONS=(
+	"unknown-type|24 + 2|92|\x7f"
+	"missing-relocation|24 + 2|104|\x20"
+	"cycle|24 + 2|80|\x48"
+	"unterminated-name|abc * 99999999999999999999999999|27|xxxxx"
+	"truncated-constant|abc * 99999999999999999999999999|64|\x40"
+)
+for corruption in "${CORRUPTIONS[@]}"; do
+	IFS="|" read -r test program offset bytes <<< "$corruption"
+	echo "$program" | build/Compiler --save-tree="$TREE" 2>/dev/null
+	printf "$bytes" | dd of="$TREE" bs=1 seek="$offset" conv=notrunc status=none
+	RESULT="$(build/Compiler --load-tree="$TREE" 2>&1 >/dev/null)"
+	if [[ "$RESULT" == *"cannot be loaded"* ]]; then
+		echo -e "    $test, ${GREEN}and it does${OFF}"
+	else
+		STATUS=1
+		echo -e "    $test, ${RED}but it does not${OFF}"
+	fi
+done
+rm -f "$TREE"
+echo ""
+
+echo "Compiler should accept, in batch..."
+echo ""
+
+for arguments in "" "--evaluate" "--jobs=4"; do
+	RESULTS=0
+	while IFS=$'\t' read -r program RESULT value; do
+		RESULTS=$((RESULTS + 1))
+		if [ "$RESULT" == "0" ]; then
+			echo -e "    $(basename "$program")${arguments:+ $arguments}, ${GREEN}and it does${OFF} (status $RESULT)"
+		else
+			STATUS=1
+			echo -e "    $(basename "$program")${arguments:+ $arguments}, ${RED}but it rejects${OFF} (status $RESULT)"
+		fi
+	done < <(build/Compiler --batch $arguments src/test/c/accept/* 2>/dev/null)
+	if [ "$RESULTS" != "$(ls src/test/c/accept/ | wc --lines)" ]; then
+		STATUS=1
+		echo -e "    ${RED}Missing results${OFF} (only $RESULTS)"
+	fi
+done
+echo ""
+
+echo "Compiler should reject, in batch..."
+echo ""
+
+for arguments in "" "--evaluate" "--jobs=4"; do
+	RESULTS=0
+	while IFS=$'\t' read -r program RESULT value; do
+		RESULTS=$((RESULTS + 1))
+		if [ "$RESULT" != "0" ]; then
+			echo -e "    $(basename "$program")${arguments:+ $arguments}, ${GREEN}and it does${OFF} (status $RESULT)"
+		else
+			STATUS=1
+			echo -e "    $(basename "$program")${arguments:+ $arguments}, ${RED}but it accepts${OFF} (status $RESULT)"
+		fi
+	done < <(build/Compiler --batch $arguments src/test/c/reject/* 2>/dev/null)
+	if [ "$RESULTS" != "$(ls src/test/c/reject/ | wc --lines)" ]; then
+		STATUS=1
+		echo -e "    ${RED}Missing results${OFF} (only $RESULTS)"
+	fi
+done
+echo ""
+
+echo "Compiler should reject a batch whose programs have the same output..."
+echo ""
+
+# Two programs with the same name, in different directories, would write the
+# same file of the output directory.
+DIRECTORY="$(mktemp --directory)"
+mkdir "$DIRECTORY/a" "$DIRECTORY/b" "$DIRECTORY/output"
+PROGRAM="$(ls src/test/c/accept/ | head --lines=1)"
+cp "src/test/c/accept/$PROGRAM" "$DIRECTORY/a/"
+cp "src/test/c/accept/$PROGRAM" "$DIRECTORY/b/"
+build/Compiler --batch --output-directory="$DIRECTORY/output" "$DIRECTORY/a/$PROGRAM" "$DIRECTORY/b/$PROGRAM" >/dev/null 2>&1
+RESULT="$?"
+if [ "$RESULT" != "0" ] && [ -z "$(ls "$DIRECTORY/output")" ]; then
+	echo -e "    a/$PROGRAM b/$PROGRAM, ${GREEN}and it does${OFF} (status $RESULT)"
+else
+	STATUS=1
+	echo -e "    a/$PROGRAM b/$PROGRAM, ${RED}but it does not${OFF} (status $RESULT)"
+fi
+rm -rf "$DIRECTORY"
+echo ""
+
+echo "Compiler should accept and reject, in a delimited stream..."
+echo ""
+
+# Every rejected program is followed by an accepted one, to check that the
+# failures leave nothing behind (e.g., an unterminated comment).
+PROGRAMS=()
+for test in $(ls src/test/c/reject/); do
+	PROGRAMS+=("src/test/c/reject/$test" "src/test/c/accept/$(ls src/test/c/accept/ | head --lines=1)")
+done
+RESULTS=0
+while IFS=$'\t' read -r position RESULT value; do
+	RESULTS=$((RESULTS + 1))
+	program="${PROGRAMS[$((position - 1))]}"
+	test="$(basename "$(dirname "$program")")/$(basename "$program")"
+	if [[ "$program" == src/test/c/accept/* ]] && [ "$RESULT" == "0" ]; then
+		echo -e "    $test, ${GREEN}and it accepts${OFF} (status $RESULT)"
+	elif [[ "$program" == src/test/c/reject/* ]] && [ "$RESULT" != "0" ]; then
+		echo -e "    $test, ${GREEN}and it rejects${OFF} (status $RESULT)"
+	else
+		STATUS=1
+		echo -e "    $test, ${RED}but it does not${OFF} (status $RESULT)"
+	fi
+done < <(for program in "${PROGRAMS[@]}"; do cat "$program"; printf "\0"; done | build/Compiler --batch --delimiter='\0' 2>/dev/null)
+if [ "$RESULTS" != "${#PROGRAMS[@]}" ]; then
+	STATUS=1
+	echo -e "    ${RED}Missing results${OFF} (only $RESULTS)"
+fi
+echo ""
+
+echo "Compiler should compute exact values, beyond 64 bits..."
+echo ""
+
+# Each line holds a program and its expected value. The batch mode reports the
+# value in every mode, and with every evaluator.
+while IFS=$'\t' read -r PROGRAM EXPECTED; do
+	for evaluator in bytecode native tree; do
+		for arguments in "" "--evaluate"; do
+			RESULT="$(printf "%s" "$PROGRAM" | EVALUATOR=$evaluator build/Compiler --batch $arguments 2>/dev/null | cut --fields=3)"
+			if [ "$RESULT" == "$EXPECTED" ]; then
+				echo -e "    $PROGRAM ($evaluator${arguments:+ $arguments}), ${GREEN}and it does${OFF} ($RESULT)"
+			else
+				STATUS=1
+				echo -e "    $PROGRAM ($evaluator${arguments:+ $arguments}), ${RED}but it does not${OFF} ($RESULT instead of $EXPECTED)"
+			fi
+		done
+	done
+done <<EOF
+9223372036854775807 + 1	9223372036854775808
+0 - 9223372036854775807 - 1	-9223372036854775808
+0 - 9223372036854775807 - 2	-9223372036854775809
+(0 - 9223372036854775807 - 1) / (0 - 1)	9223372036854775808
+4294967296 * 4294967296 - 1	18446744073709551615
+340282366920938463463374607431768211456 / 18446744073709551616	18446744073709551616
+99999999999999999999 * 99999999999999999999 / 99999999999999999999	99999999999999999999
+123456789012345678901234567890 - 123456789012345678901234567889	1
+EOF
+echo ""
+
+echo "Compiler should reject a division by zero, with every evaluator..."
+echo ""
+
+for evaluator in bytecode native tree; do
+	for test in 05-division-by-zero 07-big-division-by-zero; do
+		cat "src/test/c/reject/$test" | EVALUATOR=$evaluator build/Compiler >/dev/null 2>&1
+		RESULT="$?"
+		if [ "$RESULT" != "0" ]; then
+			echo -e "    $test ($evaluator), ${GREEN}and it does${OFF} (status $RESULT)"
+		else
+			STATUS=1
+			echo -e "    $test ($evaluator), ${RED}but it accepts${OFF} (status $RESULT)"
+		fi
+	done
+done
+echo ""
+
+echo "Compiler should evaluate a program over columns, row by row..."
+echo ""
+
+# The same table as CSV, and as binary columns (of native 64-bit integers).
+# The second row divides by zero, and the third one overflows, so they're
+# invalid: empty in decimal, and unset in the validity mask (9 = 0b1001).
+TABLE="$(mktemp --directory)"
+printf "x, y\n6, 3\n-4, 0\n9223372036854775807, 1\n-7, 2\n" > "$TABLE/table.csv"
+printf "\006\0\0\0\0\0\0\0\374\377\377\377\377\377\377\377\377\377\377\377\377\377\377\177\371\377\377\377\377\377\377\377" > "$TABLE/x"
+printf "\003\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\001\0\0\0\0\0\0\0\002\0\0\0\0\0\0\0" > "$TABLE/y"
+PROGRAM="2 * x / y - 1"
+for arguments in "--csv=$TABLE/table.csv" "--bind=x=$TABLE/x --bind=y=$TABLE/y" "--bind=x=$TABLE/x --bind=y=$TABLE/y --result=$TABLE/result"; do
+	RESULT="$(printf "%s" "$PROGRAM" | build/Compiler $arguments 2>/dev/null | paste --serial --delimiters=,)"
+	if [[ "$arguments" == *--result=* ]]; then
+		RESULT="$(od --address-radix=n --format=d8 --output-duplicates "$TABLE/result" | xargs | cut --delimiter=" " --fields=1,4) $(od --address-radix=n --format=u8 "$TABLE/result.validity" | xargs)"
+		EXPECTED="3 -8 9"
+	else
+		EXPECTED="3,,,-8"
+	fi
+	if [ "$RESULT" == "$EXPECTED" ]; then
+		echo -e "    $PROGRAM (${arguments//$TABLE\//}), ${GREEN}and it does${OFF} ($RESULT)"
+	else
+		STATUS=1
+		echo -e "    $PROGRAM (${arguments//$TABLE\//}), ${RED}but it does not${OFF} ($RESULT instead of $EXPECTED)"
+	fi
+done
+printf "%s" "x + z" | build/Compiler --csv="$TABLE/table.csv" >/dev/null 2>&1
+RESULT="$?"
+if [ "$RESULT" != "0" ]; then
+	echo -e "    x + z (unbound), ${GREEN}and it rejects${OFF} (status $RESULT)"
+else
+	STATUS=1
+	echo -e "    x + z (unbound), ${RED}but it accepts${OFF} (status $RESULT)"
+fi
+rm --recursive "$TABLE"
+echo ""
+
+echo "Compiler should replay a cached compilation, as if it compiles it again..."
+echo ""
+
+# Many processes fill the cache at once (from the standard input), and then
+# another one replays it (from the program file, with the same content).
+CACHE="$(mktemp --directory)"
+for file in src/test/c/accept/* src/test/c/reject/*; do
+	test="$(basename "$file")"
+	for arguments in "" "--evaluate"; do
+		build/Compiler $arguments < "$file" > "$CACHE/.expected" 2>/dev/null
+		EXPECTED="$?"
+		for process in 1 2 3 4; do
+			CACHE_DIRECTORY="$CACHE" build/Compiler $arguments < "$file" > "$CACHE/.concurrent-$process" 2>/dev/null &
+		done
+		wait
+		CACHE_DIRECTORY="$CACHE" build/Compiler $arguments "$file" > "$CACHE/.replayed" 2>/dev/null
+		RESULT="$?"
+		SAME="true"
+		for output in "$CACHE"/.concurrent-* "$CACHE/.replayed"; do
+			cmp --silent "$CACHE/.expected" "$output" || SAME="false"
+		done
+		if [ "$RESULT" == "$EXPECTED" ] && [ "$SAME" == "true" ]; then
+			echo -e "    $test${arguments:+ $arguments}, ${GREEN}and it does${OFF} (status $RESULT)"
+		else
+			STATUS=1
+			echo -e "    $test${arguments:+ $arguments}, ${RED}but it does not${OFF} (status $RESULT instead of $EXPECTED)"
+		fi
+	done
+done
+rm --recursive "$CACHE"
+echo ""
+
+echo "Compiler should serve many clients, as if it compiles alone..."
+echo ""
+
+# A server with 4 workers receives every program from many clients at once,
+# and then stops on SIGTERM (removing its socket).
+SERVER="$(mktemp --directory)"
+build/Compiler --server="$SERVER/socket" --jobs=4 >/dev/null 2>&1 &
+SERVER_PID="$!"
+for attempt in $(seq 1 100); do
+	[ -S "$SERVER/socket" ] && break
+	sleep 0.1
+done
+for file in src/test/c/accept/* src/test/c/reject/*; do
+	test="$(basename "$file")"
+	for arguments in "" "--evaluate"; do
+		build/Compiler $arguments < "$file" > "$SERVER/expected" 2>/dev/null
+		EXPECTED="$?"
+		for client in 1 2 3 4 5 6 7 8; do
+			build/CompilerClient "$SERVER/socket" $arguments "$file" > "$SERVER/served-$client" 2>/dev/null &
+		done
+		build/CompilerClient "$SERVER/socket" $arguments < "$file" > "$SERVER/served-0" 2>/dev/null
+		RESULT="$?"
+		wait $(jobs -p | grep --invert-match --line-regexp "$SERVER_PID")
+		SAME="true"
+		for output in "$SERVER"/served-*; do
+			cmp --silent "$SERVER/expected" "$output" || SAME="false"
+		done
+		if [ "$RESULT" == "$EXPECTED" ] && [ "$SAME" == "true" ]; then
+			echo -e "    $test${arguments:+ $arguments}, ${GREEN}and it does${OFF} (status $RESULT)"
+		else
+			STATUS=1
+			echo -e "    $test${arguments:+ $arguments}, ${RED}but it does not${OFF} (status $RESULT instead of $EXPECTED)"
+		fi
+	done
+done
+RESULT="$(build/CompilerClient "$SERVER/socket" --statistics 2>/dev/null)"
+if [[ "$RESULT" == *'"p50":'*'"p99":'* ]]; then
+	echo -e "    statistics, ${GREEN}and it does${OFF} (with latency percentiles)"
+else
+	STATUS=1
+	echo -e "    statistics, ${RED}but it does not${OFF} ($RESULT)"
+fi
+kill -TERM "$SERVER_PID"
+wait "$SERVER_PID"
+RESULT="$?"
+if [ "$RESULT" == "0" ] && [ ! -e "$SERVER/socket" ]; then
+	echo -e "    stop, ${GREEN}and it does${OFF} (status $RESULT)"
+else
+	STATUS=1
+	echo -e "    stop, ${RED}but it does not${OFF} (status $RESULT)"
+fi
+rm --recursive "$SERVER"
+echo ""
+
+echo "Compiler should accept deep programs (without generating the output)..."
+echo ""
+
+DEPTH=1000000
+for test in deep-parenthesis long-subtraction; do
+	case "$test" in
+		deep-parenthesis)
+			PROGRAM="$(yes "(" | head --lines=$DEPTH | tr --delete '\n')1$(yes ")" | head --lines=$DEPTH | tr --delete '\n')"
+			;;
+		long-subtraction)
+			PROGRAM="1$(yes " - 1" | head --lines=$DEPTH | tr --delete '\n')"
+			;;
+	esac
+	for arguments in "" "--evaluate"; do
+		printf "%s" "$PROGRAM" | GENERATE_OUTPUT=false build/Compiler $arguments >/dev/null 2>&1
+		RESULT="$?"
+		if [ "$RESULT" == "0" ]; then
+			echo -e "    $test (depth $DEPTH)${arguments:+ $arguments}, ${GREEN}and it does${OFF} (status $RESULT)"
+		else
+			STATUS=1
+			echo -e "    $test (depth $DEPTH)${arguments:+ $arguments}, ${RED}but it rejects${OFF} (status $RESULT)"
+		fi
+	done
+done
+echo ""
+
+echo "Compiler should evaluate a long program within a bounded memory..."
+echo ""
+
+# Ten million terms (about 40 MiB), read from a pipe by a compiler limited to
+# 64 MiB of virtual memory, where neither the program nor its tree would fit.
+LENGTH=10000000
+RESULT="$({ yes "1 +" | head --lines=$LENGTH; echo "1"; } | (ulimit -v 65536; build/Compiler --evaluate 2>/dev/null); echo "status $?")"
+if [ "$RESULT" == "$((LENGTH + 1))"$'\n'"status 0" ]; then
+	echo -e "    long-addition (length $LENGTH) --evaluate, ${GREEN}and it does${OFF} (${RESULT##*$'\n'})"
+else
+	STATUS=1
+	echo -e "    long-addition (length $LENGTH) --evaluate, ${RED}but it does not${OFF} (${RESULT##*$'\n'})"
+fi
+echo ""
+
+echo "Compiler should compile concurrently, as in a single thread..."
+echo ""
+
+RESULT="$(build/CompilerStressTest 8 src/test/c/accept/* src/test/c/reject/* 2>/dev/null)"
+if [ "$?" == "0" ]; then
+	echo -e "    ${GREEN}and it does${OFF} ($RESULT)"
+else
+	STATUS=1
+	echo -e "    ${RED}but it does not${OFF} ($RESULT)"
+fi
+echo ""
+
 echo "All done."
 exit $STATUS
@@ -0,0 +1,113 @@
+#include "Benchmark.h"
+#include <string.h>
+
+/**
+ * A named group of related benchmarks.
+ */
+typedef struct {
+	const char * name;
+	void (*run)(void);
+} BenchmarkSuite;
+
+/* MODULE INTERNAL STATE */
+
+static boolean _json = false;
+
+static const BenchmarkSuite _suites[] = {
+	{ "end-to-end", benchmarkEndToEnd },
+	{ "evaluation", benchmarkEvaluation },
+	{ "input", benchmarkInput },
+	{ "lexical-analysis", benchmarkLexicalAnalysis }
+};
+
+static const unsigned int _suitesCount = sizeof(_suites) / sizeof(BenchmarkSuite);
+
+/* PUBLIC FUNCTIONS */
+
+double currentSeconds(void) {
+	struct timespec timespec;
+	clock_gettime(CLOCK_MONOTONIC, &timespec);
+	return timespec.tv_sec + timespec.tv_nsec / 1e9;
+}
+
+void reportBenchmark(const char * suite, const char * name, const size_t operations, const char * unit, const double seconds) {
+	if (_json) {
+		fprintf(stdout, "{\"suite\":\"%s\",\"name\":\"%s\",\"operations\":%zu,\"unit\":\"%s\",\"seconds\":%.9f,\"throughput\":%.3f}\n",
+			suite,
+			name,
+			operations,
+			unit,
+			seconds,
+			operations / seconds);
+		fflush(stdout);
+		return;
+	}
+	fprintf(stdout, "%-20s %-28s %12zu %-8s %10.3f ms %14.0f %s/s %10.2f ns/%s\n",
+		suite,
+		name,
+		operations,
+		unit,
+		1e3 * seconds,
+		operations / seconds,
+		unit,
+		1e9 * seconds / operations,
+		unit);
+	fflush(stdout);
+}
+
+void reportMetric(const char * suite, const char * name, const char * metric, const double value, const char * unit) {
+	if (_json) {
+		fprintf(stdout, "{\"suite\":\"%s\",\"name\":\"%s\",\"metric\":\"%s\",\"value\":%.3f,\"unit\":\"%s\"}\n",
+			suite,
+			name,
+			metric,
+			value,
+			unit);
+	}
+	else {
+		fprintf(stdout, "%-20s %-28s %12.0f %s of %s\n", suite, name, value, unit, metric);
+	}
+	fflush(stdout);
+}
+
+/**
+ * Runs the suites specified by name in the arguments, or every suite if none
+ * was specified. With the "--json" argument, every result is reported as a
+ * JSON object in a line of its own, to compare them across revisions.
+ */
+int main(const int count, const char ** arguments) {
+	int status = 0;
+	int suitesSelected = 0;
+	for (int j = 1; j < count; ++j) {
+		if (strcmp(arguments[j], "--json") == 0) {
+			_json = true;
+		}
+		else {
+			++suitesSelected;
+		}
+	}
+	for (unsigned int k = 0; k < _suitesCount; ++k) {
+		boolean selected = suitesSelected == 0 ? true : false;
+		for (int j = 1; j < count; ++j) {
+			if (strcmp(arguments[j], _suites[k].name) == 0) {
+				selected = true;
+			}
+		}
+		if (selected) {
+			_suites[k].run();
+		}
+	}
+	for (int j = 1; j < count; ++j) {
+		boolean known = strcmp(arguments[j], "--json") == 0;
+		for (unsigned int k = 0; k < _suitesCount; ++k) {
+			if (strcmp(arguments[j], _suites[k].name) == 0) {
+				known = true;
+			}
+		}
+		if (!known) {
+			fprintf(stderr, "Unknown benchmark suite: \"%s\".\n", arguments[j]);
+			status = 1;
+		}
+	}
+	return status;
+}
@@ -0,0 +1,39 @@
+#ifndef BENCHMARK_HEADER
+#define BENCHMARK_HEADER
+
+#include "../../main/c/shared/Type.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * Reads a monotonic clock, in seconds. Only the difference between two
+ * readings is meaningful.
+ *
+ * @see https://man7.org/linux/man-pages/man3/clock_gettime.3.html
+ */
+double currentSeconds(void);
+
+/**
+ * Reports the result of a benchmark in the standard output: the amount of
+ * operations executed (measured in the specified unit), the elapsed time, the
+ * throughput and the average cost of each operation.
+ */
+void reportBenchmark(const char * suite, const char * name, const size_t operations, const char * unit, const double seconds);
+
+/**
+ * Reports a single measurement of a benchmark in the standard output, that is
+ * not a duration (e.g., the peak memory).
+ */
+void reportMetric(const char * suite, const char * name, const char * metric, const double value, const char * unit);
+
+/**
+ * Benchmark suites.
+ */
+
+void benchmarkEndToEnd(void);
+void benchmarkEvaluation(void);
+void benchmarkInput(void);
+void benchmarkLexicalAnalysis(void);
+
+#endif
@@ -0,0 +1,302 @@
+#include "../../main/c/backend/code-generation/Generator.h"
+#include "../../main/c/backend/domain-specific/Calculator.h"
+#include "../../main/c/driver/Compilation.h"
+#include "../../main/c/frontend/lexical-analysis/FlexActions.h"
+#include "../../main/c/frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../main/c/frontend/syntactic-analysis/BisonActions.h"
+#include "../../main/c/frontend/syntactic-analysis/SyntacticAnalyzer.h"
+#include "../../main/c/shared/Arena.h"
+#include "../../main/c/shared/Stack.h"
+#include "Benchmark.h"
+#include "ProgramGenerator.h"
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * The approximate size of every synthetic program, in bytes (the output is
+ * about a thousand times larger).
+ */
+#define WORKLOAD_LENGTH (4 * 1024 * 1024)
+
+/**
+ * A named shape of synthetic program.
+ */
+typedef struct {
+	const char * name;
+	ProgramShape programShape;
+} Workload;
+
+/**
+ * The shapes are alike, except in one dimension each.
+ */
+static const Workload _workloads[] = {
+	{ "balanced", { .additions = 1, .commentPercentage = 0, .depth = 4, .divisions = 1, .length = WORKLOAD_LENGTH, .literalWidth = 3, .multiplications = 1, .seed = 42, .subtractions = 1 } },
+	{ "shallow", { .additions = 1, .commentPercentage = 0, .depth = 0, .divisions = 1, .length = WORKLOAD_LENGTH, .literalWidth = 3, .multiplications = 1, .seed = 42, .subtractions = 1 } },
+	{ "deep", { .additions = 1, .commentPercentage = 0, .depth = 64, .divisions = 1, .length = WORKLOAD_LENGTH, .literalWidth = 3, .multiplications = 1, .seed = 42, .subtractions = 1 } },
+	{ "additive", { .additions = 1, .commentPercentage = 0, .depth = 4, .divisions = 0, .length = WORKLOAD_LENGTH, .literalWidth = 3, .multiplications = 0, .seed = 42, .subtractions = 1 } },
+	{ "commented", { .additions = 1, .commentPercentage = 50, .depth = 4, .divisions = 1, .length = WORKLOAD_LENGTH, .literalWidth = 3, .multiplications = 1, .seed = 42, .subtractions = 1 } },
+	{ "wide-literals", { .additions = 1, .commentPercentage = 0, .depth = 4, .divisions = 1, .length = WORKLOAD_LENGTH, .literalWidth = 9, .multiplications = 1, .seed = 42, .subtractions = 1 } }
+};
+
+static const unsigned int _workloadsCount = sizeof(_workloads) / sizeof(Workload);
+
+/* PRIVATE FUNCTIONS */
+
+/**
+ * Compiles a workload in some way, and reports its cost. Returns false if the
+ * program is rejected.
+ */
+typedef boolean (*WorkloadCompiler)(const Workload * workload, char * source, const size_t length);
+
+static void _benchmarkWorkload(const Workload * workload);
+static boolean _compileWorkload(const Workload * workload, char * source, const size_t length);
+static double _parsePipelined(char * source, const size_t length);
+static void _reportPhase(const Workload * workload, const char * phase, const size_t operations, const char * unit, const double seconds);
+static boolean _streamWorkload(const Workload * workload, char * source, const size_t length);
+static size_t _traverseTree(const Expression * expression);
+
+/**
+ * Compiles a synthetic program in a child process per compiler (the one
+ * phase by phase, and the streamed one), so the peak memory of each one is
+ * measured in isolation.
+ */
+static void _benchmarkWorkload(const Workload * workload) {
+	static const WorkloadCompiler workloadCompilers[] = { _compileWorkload, _streamWorkload };
+	size_t length = 0;
+	char * source = generateProgram(&workload->programShape, &length);
+	for (unsigned int k = 0; k < sizeof(workloadCompilers) / sizeof(WorkloadCompiler); ++k) {
+		fflush(stdout);
+		const pid_t child = fork();
+		if (child == 0) {
+			_exit(workloadCompilers[k](workload, source, length) ? 0 : 1);
+		}
+		int status = 0;
+		if (child < 0 || waitpid(child, &status, 0) != child) {
+			fprintf(stderr, "The \"%s\" workload cannot be executed.\n", workload->name);
+		}
+		else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			fprintf(stderr, "The \"%s\" workload is rejected.\n", workload->name);
+		}
+	}
+	free(source);
+}
+
+/**
+ * Compiles the program phase by phase (as in the generation mode, with the
+ * tree-walking calculator), and reports the cost of each one.
+ */
+static boolean _compileWorkload(const Workload * workload, char * source, const size_t length) {
+	setenv("LOGGING_LEVEL", "ERROR", 1);
+	setenv("PIPELINED_FRONTEND", "false", 1);
+	initializeFlexActionsModule();
+	initializeBisonActionsModule();
+	initializeSyntacticAnalyzerModule();
+	initializeAbstractSyntaxTreeModule();
+	initializeCalculatorModule();
+	initializeGeneratorModule();
+	// The counters of hash-consing are only reported to a telemetry (which
+	// also counts the tokens).
+	Telemetry telemetry = { 0 };
+	CompilerState compilerState = {
+		.abstractSyntaxtTree = NULL,
+		.arena = createArena(ARENA_DEFAULT_BLOCK_SIZE),
+		.computed = false,
+		.input = NULL,
+		.mode = GENERATION_MODE,
+		.nodeTable = NULL,
+		.output = fopen("/dev/null", "w"),
+		.scanInPlace = true,
+		.scanner = NULL,
+		.source = source,
+		.sourceLength = length,
+		.spilledTree = NULL,
+		.succeed = false,
+		.telemetry = &telemetry,
+		.tokenRing = NULL,
+		.value = {
+			.big = NULL,
+			.small = 0
+		}
+	};
+	const double start = currentSeconds();
+	if (parse(&compilerState) != ACCEPT) {
+		return false;
+	}
+	const double parsed = currentSeconds();
+	const Program * program = compilerState.abstractSyntaxtTree;
+	const ComputationResult computationResult = computeExpression(compilerState.arena, program->expression);
+	if (!computationResult.succeed) {
+		return false;
+	}
+	compilerState.computed = true;
+	compilerState.value = computationResult.value;
+	const double computed = currentSeconds();
+	if (!generate(&compilerState)) {
+		return false;
+	}
+	fflush(compilerState.output);
+	const double generated = currentSeconds();
+	const size_t visits = _traverseTree(program->expression);
+	const double traversed = currentSeconds();
+	// Every shared node is still a node of the tree, and a step of each phase.
+	const HashConsingCounters hashConsing = telemetry.hashConsing;
+	const size_t nodes = compilerState.arena->allocations + hashConsing.sharedNodes;
+	const size_t allocatedBytes = compilerState.arena->allocatedBytes;
+	const size_t reservedBytes = compilerState.arena->reservedBytes;
+	destroyArena(compilerState.arena);
+	const double released = currentSeconds();
+	fclose(compilerState.output);
+	const double pipelinedSeconds = _parsePipelined(source, length);
+	if (pipelinedSeconds < 0) {
+		return false;
+	}
+
+	_reportPhase(workload, "lex+parse", length, "byte", parsed - start);
+	_reportPhase(workload, "lex+parse", nodes, "node", parsed - start);
+	_reportPhase(workload, "compute", nodes, "node", computed - parsed);
+	_reportPhase(workload, "generate", nodes, "node", generated - computed);
+	_reportPhase(workload, "traverse", visits, "node", traversed - generated);
+	_reportPhase(workload, "release", nodes, "node", released - traversed);
+	_reportPhase(workload, "total", length, "byte", released - start);
+	_reportPhase(workload, "lex|parse", length, "byte", pipelinedSeconds);
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	reportMetric("end-to-end", workload->name, "tree memory", reservedBytes / 1024, "KiB");
+	reportMetric("end-to-end", workload->name, "tree memory per node", nodes == 0 ? 0.0 : (double) allocatedBytes / nodes, "byte");
+	reportMetric("end-to-end", workload->name, "peak resident memory", usage.ru_maxrss, "KiB");
+	reportMetric("end-to-end", workload->name, "shared nodes", hashConsing.nodes == 0 ? 0.0 : 100.0 * hashConsing.sharedNodes / hashConsing.nodes, "%");
+	reportMetric("end-to-end", workload->name, "dedup savings", hashConsing.savedBytes / 1024, "KiB");
+	// The pipeline can only be faster with another core for the lexer thread.
+	reportMetric("end-to-end", workload->name, "pipelined speedup", 100.0 * (parsed - start) / pipelinedSeconds, "%");
+	reportMetric("end-to-end", workload->name, "parallelism", (double) sysconf(_SC_NPROCESSORS_ONLN), "core");
+	return true;
+}
+
+/**
+ * Parses the program again (with the same telemetry as before), but with the
+ * lexer on a thread of its own, ahead of the parser. Returns the elapsed
+ * time, or a negative value if the program is rejected.
+ */
+static double _parsePipelined(char * source, const size_t length) {
+	setenv("PIPELINED_FRONTEND", "true", 1);
+	shutdownSyntacticAnalyzerModule();
+	initializeSyntacticAnalyzerModule();
+	Telemetry telemetry = { 0 };
+	CompilerState compilerState = {
+		.abstractSyntaxtTree = NULL,
+		.arena = createArena(ARENA_DEFAULT_BLOCK_SIZE),
+		.computed = false,
+		.input = NULL,
+		.mode = GENERATION_MODE,
+		.nodeTable = NULL,
+		.output = NULL,
+		.scanInPlace = true,
+		.scanner = NULL,
+		.source = source,
+		.sourceLength = length,
+		.spilledTree = NULL,
+		.succeed = false,
+		.telemetry = &telemetry,
+		.tokenRing = NULL,
+		.value = {
+			.big = NULL,
+			.small = 0
+		}
+	};
+	const double start = currentSeconds();
+	const SyntacticAnalysisStatus syntacticAnalysisStatus = parse(&compilerState);
+	const double seconds = currentSeconds() - start;
+	destroyArena(compilerState.arena);
+	return syntacticAnalysisStatus == ACCEPT ? seconds : -1.0;
+}
+
+/**
+ * Reports a phase of a workload, named after both.
+ */
+static void _reportPhase(const Workload * workload, const char * phase, const size_t operations, const char * unit, const double seconds) {
+	char name[64];
+	snprintf(name, sizeof(name), "%s/%s", workload->name, phase);
+	reportBenchmark("end-to-end", name, operations, unit, seconds);
+}
+
+/**
+ * Compiles the program in streaming mode (computing while parsing, and
+ * generating from the spilled tree), and reports its time and its peak
+ * memory, which depend on the depth of the program, but not on its length.
+ */
+static boolean _streamWorkload(const Workload * workload, char * source, const size_t length) {
+	setenv("LOGGING_LEVEL", "ERROR", 1);
+	setenv("PIPELINED_FRONTEND", "false", 1);
+	initializeFlexActionsModule();
+	initializeBisonActionsModule();
+	initializeSyntacticAnalyzerModule();
+	initializeCalculatorModule();
+	initializeGeneratorModule();
+	initializeCompilationModule();
+	CompilerState compilerState = {
+		.abstractSyntaxtTree = NULL,
+		.arena = createArena(ARENA_DEFAULT_BLOCK_SIZE),
+		.computed = false,
+		.input = NULL,
+		.mode = STREAMING_MODE,
+		.nodeTable = NULL,
+		.output = fopen("/dev/null", "w"),
+		.scanInPlace = true,
+		.scanner = NULL,
+		.source = source,
+		.sourceLength = length,
+		.spilledTree = NULL,
+		.succeed = false,
+		.telemetry = NULL,
+		.tokenRing = NULL,
+		.value = {
+			.big = NULL,
+			.small = 0
+		}
+	};
+	const double start = currentSeconds();
+	const CompilationStatus compilationStatus = compile(&compilerState);
+	fflush(compilerState.output);
+	const double streamed = currentSeconds();
+	destroyArena(compilerState.arena);
+	fclose(compilerState.output);
+	if (compilationStatus != SUCCEED) {
+		return false;
+	}
+
+	_reportPhase(workload, "stream", length, "byte", streamed - start);
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	reportMetric("end-to-end", workload->name, "streamed peak resident memory", usage.ru_maxrss, "KiB");
+	return true;
+}
+
+/**
+ * Visits every node of the tree (the shared ones, once per parent), in
+ * pre-order, without computing anything, so it measures how fast the nodes
+ * can be reached. Returns the amount of visits.
+ */
+static size_t _traverseTree(const Expression * expression) {
+	Stack * stack = createStack(sizeof(const Expression *), 1024);
+	size_t visits = 0;
+	pushStack(stack, &expression);
+	while (!isEmptyStack(stack)) {
+		popStack(stack, &expression);
+		++visits;
+		if (expression->type != CONSTANT && expression->type != VARIABLE) {
+			pushStack(stack, &expression->rightExpression);
+			pushStack(stack, &expression->leftExpression);
+		}
+	}
+	destroyStack(stack);
+	return visits;
+}
+
+/* PUBLIC FUNCTIONS */
+
+void benchmarkEndToEnd(void) {
+	for (unsigned int k = 0; k < _workloadsCount; ++k) {
+		_benchmarkWorkload(&_workloads[k]);
+	}
+}
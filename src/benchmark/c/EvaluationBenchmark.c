@@ -0,0 +1,231 @@
+#include "../../main/c/backend/columnar-evaluation/ColumnarEvaluator.h"
+#include "../../main/c/backend/domain-specific/Calculator.h"
+#include "../../main/c/backend/native-code/NativeCode.h"
+#include "../../main/c/backend/virtual-machine/Bytecode.h"
+#include "../../main/c/backend/virtual-machine/VirtualMachine.h"
+#include "../../main/c/shared/Arena.h"
+#include "Benchmark.h"
+
+/**
+ * The amount of times a small program is evaluated, to compare the speed of
+ * the evaluators in evaluations per second.
+ */
+#define EVALUATIONS 1000000
+
+/* PRIVATE FUNCTIONS */
+
+static void _compareResults(const char * evaluator, const ComputationResult expected, const ComputationResult actual);
+static Expression * _createConstantExpression(Arena * arena, unsigned int * seed, size_t * nodes);
+static Expression * _createExpression(Arena * arena, const unsigned int depth, unsigned int * seed, size_t * nodes);
+static Expression * _createProduct(Arena * arena, const unsigned int depth, size_t * nodes);
+static Expression * _createVariableExpression(Arena * arena, char * name);
+
+/**
+ * Reports if an evaluator disagrees with the tree-walker.
+ */
+static void _compareResults(const char * evaluator, const ComputationResult expected, const ComputationResult actual) {
+	if (expected.succeed != actual.succeed || !equalIntegers(expected.value, actual.value)) {
+		char * expectedValue = integerToString(expected.value);
+		char * actualValue = integerToString(actual.value);
+		fprintf(stderr, "The evaluators disagree: %s (tree) vs. %s (%s).\n", expectedValue, actualValue, evaluator);
+		releaseMemory(expectedValue);
+		releaseMemory(actualValue);
+	}
+}
+
+/**
+ * Creates a constant in the range 1-9.
+ */
+static Expression * _createConstantExpression(Arena * arena, unsigned int * seed, size_t * nodes) {
+	Expression * expression = allocateInArena(arena, sizeof(Expression));
+	expression->type = CONSTANT;
+	expression->value.small = 1 + rand_r(seed) % 9;
+	*nodes += 1;
+	return expression;
+}
+
+/**
+ * Creates a pseudo-random balanced expression of the specified depth. The
+ * divisors are always constants, so the computation never fails, and so are
+ * the multipliers, so the values fit in 64 bits. Some subexpressions are
+ * parenthesized.
+ */
+static Expression * _createExpression(Arena * arena, const unsigned int depth, unsigned int * seed, size_t * nodes) {
+	if (depth == 0) {
+		return _createConstantExpression(arena, seed, nodes);
+	}
+	static const ExpressionType types[] = { ADDITION, DIVISION, MULTIPLICATION, SUBTRACTION };
+	Expression * expression = allocateInArena(arena, sizeof(Expression));
+	expression->type = types[rand_r(seed) % 4];
+	expression->leftExpression = _createExpression(arena, depth - 1, seed, nodes);
+	expression->rightExpression = expression->type == DIVISION || expression->type == MULTIPLICATION
+		? _createConstantExpression(arena, seed, nodes)
+		: _createExpression(arena, depth - 1, seed, nodes);
+	expression->parentheses = rand_r(seed) % 8 == 0 ? 1 : 0;
+	*nodes += 1;
+	return expression;
+}
+
+/**
+ * Creates a balanced product of the specified depth, whose constants have 9
+ * digits, so it overflows 64 bits after the first levels.
+ */
+static Expression * _createProduct(Arena * arena, const unsigned int depth, size_t * nodes) {
+	if (depth == 0) {
+		unsigned int seed = 0;
+		Expression * expression = _createConstantExpression(arena, &seed, nodes);
+		expression->value.small = 999999937;
+		return expression;
+	}
+	Expression * expression = allocateInArena(arena, sizeof(Expression));
+	expression->type = MULTIPLICATION;
+	expression->leftExpression = _createProduct(arena, depth - 1, nodes);
+	expression->rightExpression = _createProduct(arena, depth - 1, nodes);
+	*nodes += 1;
+	return expression;
+}
+
+/**
+ * Creates a variable.
+ */
+static Expression * _createVariableExpression(Arena * arena, char * name) {
+	Expression * expression = allocateInArena(arena, sizeof(Expression));
+	expression->name = name;
+	expression->type = VARIABLE;
+	return expression;
+}
+
+/* PUBLIC FUNCTIONS */
+
+void benchmarkEvaluation(void) {
+	initializeCalculatorModule();
+	initializeBytecodeModule();
+	initializeVirtualMachineModule();
+	initializeNativeCodeModule();
+	initializeColumnarEvaluatorModule();
+	Arena * arena = createArena(ARENA_DEFAULT_BLOCK_SIZE);
+	unsigned int seed = 42;
+	size_t nodes = 0;
+	Program program = {
+		.expression = _createExpression(arena, 32, &seed, &nodes)
+	};
+	const unsigned int repetitions = 10;
+
+	double start = currentSeconds();
+	ComputationResult treeResult;
+	for (unsigned int k = 0; k < repetitions; ++k) {
+		treeResult = computeExpression(arena, program.expression);
+	}
+	reportBenchmark("evaluation", "tree-walker", repetitions * nodes, "node", currentSeconds() - start);
+
+	start = currentSeconds();
+	Bytecode * bytecode = lowerProgram(&program);
+	reportBenchmark("evaluation", "bytecode-lowering", nodes, "node", currentSeconds() - start);
+
+	start = currentSeconds();
+	ComputationResult bytecodeResult;
+	for (unsigned int k = 0; k < repetitions; ++k) {
+		bytecodeResult = executeBytecode(arena, bytecode);
+	}
+	reportBenchmark("evaluation", "bytecode-execution", repetitions * nodes, "node", currentSeconds() - start);
+	_compareResults("bytecode", treeResult, bytecodeResult);
+
+	start = currentSeconds();
+	NativeCode * nativeCode = compileNativeCode(bytecode);
+	reportBenchmark("evaluation", "native-code-compilation", nodes, "node", currentSeconds() - start);
+	if (nativeCode != NULL) {
+		start = currentSeconds();
+		ComputationResult nativeResult;
+		for (unsigned int k = 0; k < repetitions; ++k) {
+			nativeResult = executeNativeCode(arena, nativeCode);
+		}
+		reportBenchmark("evaluation", "native-code-execution", repetitions * nodes, "node", currentSeconds() - start);
+		_compareResults("native", treeResult, nativeResult);
+		destroyNativeCode(nativeCode);
+	}
+	destroyBytecode(bytecode);
+
+	// A small program evaluated many times, as a formula over many inputs.
+	nodes = 0;
+	Program formula = {
+		.expression = _createExpression(arena, 8, &seed, &nodes)
+	};
+	start = currentSeconds();
+	for (unsigned int k = 0; k < EVALUATIONS; ++k) {
+		treeResult = computeExpression(arena, formula.expression);
+	}
+	reportBenchmark("evaluation", "tree-walker-formula", EVALUATIONS, "evaluation", currentSeconds() - start);
+	bytecode = lowerProgram(&formula);
+	start = currentSeconds();
+	for (unsigned int k = 0; k < EVALUATIONS; ++k) {
+		bytecodeResult = executeBytecode(arena, bytecode);
+	}
+	reportBenchmark("evaluation", "bytecode-formula", EVALUATIONS, "evaluation", currentSeconds() - start);
+	_compareResults("bytecode", treeResult, bytecodeResult);
+	nativeCode = compileNativeCode(bytecode);
+	if (nativeCode != NULL) {
+		ComputationResult nativeResult;
+		start = currentSeconds();
+		for (unsigned int k = 0; k < EVALUATIONS; ++k) {
+			nativeResult = executeNativeCode(arena, nativeCode);
+		}
+		reportBenchmark("evaluation", "native-code-formula", EVALUATIONS, "evaluation", currentSeconds() - start);
+		_compareResults("native", treeResult, nativeResult);
+		destroyNativeCode(nativeCode);
+	}
+	destroyBytecode(bytecode);
+
+	// The same formula plus "x * y", evaluated once per row of the columns.
+	Expression * variables = allocateInArena(arena, sizeof(Expression));
+	variables->type = MULTIPLICATION;
+	variables->leftExpression = _createVariableExpression(arena, "x");
+	variables->rightExpression = _createVariableExpression(arena, "y");
+	Expression * sum = allocateInArena(arena, sizeof(Expression));
+	sum->type = ADDITION;
+	sum->leftExpression = formula.expression;
+	sum->rightExpression = variables;
+	formula.expression = sum;
+	int64_t * x = malloc(EVALUATIONS * sizeof(int64_t));
+	int64_t * y = malloc(EVALUATIONS * sizeof(int64_t));
+	for (size_t k = 0; k < EVALUATIONS; ++k) {
+		x[k] = (int64_t) (k % 1000);
+		y[k] = (int64_t) (k % 7) - 3;
+	}
+	const Column columns[] = {
+		{ .name = "x", .values = x },
+		{ .name = "y", .values = y }
+	};
+	bytecode = lowerProgram(&formula);
+	start = currentSeconds();
+	ColumnarResult * columnarResult = evaluateColumns(bytecode, columns, 2, EVALUATIONS);
+	reportBenchmark("evaluation", "columnar-formula", EVALUATIONS, "evaluation", currentSeconds() - start);
+	for (size_t k = 0; columnarResult != NULL && k < EVALUATIONS; ++k) {
+		if (columnarResult->values[k] != treeResult.value.small + x[k] * y[k]) {
+			fprintf(stderr, "The columnar evaluation disagrees on the row %zu.\n", k);
+			break;
+		}
+	}
+	destroyColumnarResult(columnarResult);
+	destroyBytecode(bytecode);
+	free(x);
+	free(y);
+
+	// Most of the operations of the products run on big integers.
+	nodes = 0;
+	Program product = {
+		.expression = _createProduct(arena, 12, &nodes)
+	};
+	bytecode = lowerProgram(&product);
+	start = currentSeconds();
+	for (unsigned int k = 0; k < repetitions; ++k) {
+		bytecodeResult = executeBytecode(arena, bytecode);
+	}
+	reportBenchmark("evaluation", "big-integer-products", repetitions * nodes, "node", currentSeconds() - start);
+	destroyBytecode(bytecode);
+	destroyArena(arena);
+	shutdownColumnarEvaluatorModule();
+	shutdownNativeCodeModule();
+	shutdownVirtualMachineModule();
+	shutdownBytecodeModule();
+	shutdownCalculatorModule();
+}
@@ -0,0 +1,128 @@
+#include "../../main/c/driver/Compilation.h"
+#include "../../main/c/frontend/lexical-analysis/FlexActions.h"
+#include "../../main/c/frontend/syntactic-analysis/BisonActions.h"
+#include "../../main/c/frontend/syntactic-analysis/SyntacticAnalyzer.h"
+#include "../../main/c/shared/Arena.h"
+#include "../../main/c/shared/MappedFile.h"
+#include "Benchmark.h"
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/**
+ * The size of the program file scanned by every benchmark, in bytes.
+ */
+#define INPUT_LENGTH (64 * 1024 * 1024)
+
+/* PRIVATE FUNCTIONS */
+
+static void _benchmarkInput(const char * name, const char * path, const boolean mapped);
+static boolean _compileFile(const char * path, const boolean mapped);
+static boolean _createInput(const char * path);
+
+/**
+ * Compiles the program file in a child process (so the peak memory of each
+ * way of reading the input is measured in isolation), and reports the
+ * throughput and the peak resident memory of the child.
+ */
+static void _benchmarkInput(const char * name, const char * path, const boolean mapped) {
+	fflush(stdout);
+	const double start = currentSeconds();
+	const pid_t child = fork();
+	if (child == 0) {
+		_exit(_compileFile(path, mapped) ? 0 : 1);
+	}
+	int status = 0;
+	struct rusage usage;
+	if (child < 0 || wait4(child, &status, 0, &usage) != child) {
+		fprintf(stderr, "The \"%s\" benchmark cannot be executed.\n", name);
+		return;
+	}
+	const double seconds = currentSeconds() - start;
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		fprintf(stderr, "The \"%s\" benchmark rejects the input program.\n", name);
+		return;
+	}
+	reportBenchmark("input", name, INPUT_LENGTH, "byte", seconds);
+	reportMetric("input", name, "peak resident memory", usage.ru_maxrss, "KiB");
+}
+
+/**
+ * Compiles the program file in evaluation mode, reading it through a stream
+ * or scanning it in place through a memory mapping.
+ */
+static boolean _compileFile(const char * path, const boolean mapped) {
+	setenv("LOGGING_LEVEL", "ERROR", 1);
+	initializeFlexActionsModule();
+	initializeBisonActionsModule();
+	initializeSyntacticAnalyzerModule();
+	initializeCompilationModule();
+	MappedFile * mappedFile = mapped ? createMappedFile(path) : NULL;
+	FILE * input = mapped ? NULL : fopen(path, "rb");
+	if (mappedFile == NULL && input == NULL) {
+		return false;
+	}
+	CompilerState compilerState = {
+		.abstractSyntaxtTree = NULL,
+		.arena = createArena(ARENA_DEFAULT_BLOCK_SIZE),
+		.computed = false,
+		.input = input,
+		.mode = EVALUATION_MODE,
+		.nodeTable = NULL,
+		.output = NULL,
+		.scanInPlace = mapped,
+		.scanner = NULL,
+		.source = mapped ? mappedFile->bytes : NULL,
+		.sourceLength = mapped ? mappedFile->length : 0,
+		.spilledTree = NULL,
+		.succeed = false,
+		.telemetry = NULL,
+		.tokenRing = NULL,
+		.value = {
+			.big = NULL,
+			.small = 0
+		}
+	};
+	const CompilationStatus compilationStatus = compile(&compilerState);
+	destroyArena(compilerState.arena);
+	if (input != NULL) {
+		fclose(input);
+	}
+	destroyMappedFile(mappedFile);
+	return compilationStatus == SUCCEED;
+}
+
+/**
+ * Writes a long program, made of a chain of small additions and subtractions
+ * with comments in between (its value never grows).
+ */
+static boolean _createInput(const char * path) {
+	static const char pattern[] = "12 + 345 - 345 /* a comment */ - 12 +\n";
+	const size_t patternLength = sizeof(pattern) - 1;
+	FILE * file = fopen(path, "wb");
+	if (file == NULL) {
+		return false;
+	}
+	size_t length = 0;
+	while (length + patternLength < INPUT_LENGTH) {
+		length += fwrite(pattern, 1, patternLength, file);
+	}
+	for (; length < INPUT_LENGTH - 1; ++length) {
+		fputc(' ', file);
+	}
+	fputc('0', file);
+	return fclose(file) == 0;
+}
+
+/* PUBLIC FUNCTIONS */
+
+void benchmarkInput(void) {
+	char path[] = "/tmp/CompilerBenchmarkXXXXXX";
+	const int file = mkstemp(path);
+	if (file < 0 || close(file) != 0 || !_createInput(path)) {
+		fprintf(stderr, "The input program of the benchmark cannot be created.\n");
+		return;
+	}
+	_benchmarkInput("stream", path, false);
+	_benchmarkInput("memory-map", path, true);
+	unlink(path);
+}
@@ -0,0 +1,134 @@
+#include "../../main/c/frontend/lexical-analysis/FlexActions.h"
+#include "../../main/c/frontend/lexical-analysis/IgnoredLexemes.h"
+#include "../../main/c/frontend/syntactic-analysis/SyntacticAnalyzer.h"
+#include "Benchmark.h"
+#include "ProgramGenerator.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * Flex exported functions, to scan an in-memory buffer with a scanner of its
+ * own (without a parser).
+ *
+ * @see https://westes.github.io/flex/manual/Reentrant.html
+ */
+extern int flexLex(union SemanticValue * semanticValue, void * scanner);
+extern void flexScanBytes(void * scanner, const char * bytes, const size_t length);
+extern int yylex_destroy(void * scanner);
+extern int yylex_init_extra(LexicalAnalyzerContext * lexicalAnalyzerContext, void ** scanner);
+
+/* PRIVATE FUNCTIONS */
+
+static void _benchmarkComments(const char * name, const char * skipIgnoredLexemes);
+static void _benchmarkScanner(const char * name, const char * loggingLevel, const size_t repetitions);
+static char * _createInput(const size_t repetitions, size_t * length);
+static size_t _scan(const char * input, const size_t length);
+
+/**
+ * Measures the cost per byte of the scanner over a program with 90% of its
+ * bytes inside comments, with and without skipping them with vector
+ * instructions.
+ */
+static void _benchmarkComments(const char * name, const char * skipIgnoredLexemes) {
+	setenv("LOGGING_LEVEL", "INFORMATION", 1);
+	setenv("SKIP_IGNORED_LEXEMES", skipIgnoredLexemes, 1);
+	initializeFlexActionsModule();
+	initializeIgnoredLexemesModule();
+	const ProgramShape programShape = {
+		.additions = 1,
+		.commentPercentage = 90,
+		.depth = 2,
+		.divisions = 1,
+		.length = 32 * 1024 * 1024,
+		.literalWidth = 3,
+		.multiplications = 1,
+		.seed = 42,
+		.subtractions = 1
+	};
+	size_t length = 0;
+	char * input = generateProgram(&programShape, &length);
+	_scan(input, length);
+	const double start = currentSeconds();
+	_scan(input, length);
+	reportBenchmark("lexical-analysis", name, length, "byte", currentSeconds() - start);
+	free(input);
+	shutdownIgnoredLexemesModule();
+	shutdownFlexActionsModule();
+}
+
+/**
+ * A sequence of 11 tokens (and 10 ignored whitespace lexemes), repeated as
+ * many times as requested.
+ */
+static char * _createInput(const size_t repetitions, size_t * length) {
+	static const char pattern[] = "(12 + 345) * 6 - 7 / 89 + ";
+	const size_t patternLength = sizeof(pattern) - 1;
+	char * input = malloc(repetitions * patternLength + 2);
+	for (size_t k = 0; k < repetitions; ++k) {
+		memcpy(input + k * patternLength, pattern, patternLength);
+	}
+	*length = repetitions * patternLength;
+	input[(*length)++] = '0';
+	input[*length] = '\0';
+	return input;
+}
+
+/**
+ * Scans the whole input, and returns the amount of tokens found.
+ */
+static size_t _scan(const char * input, const size_t length) {
+	Arena * arena = createArena(ARENA_DEFAULT_BLOCK_SIZE);
+	LexicalAnalyzerContext lexicalAnalyzerContext = {
+		.arena = arena,
+		.compilerState = NULL,
+		.startToken = 0
+	};
+	void * scanner = NULL;
+	yylex_init_extra(&lexicalAnalyzerContext, &scanner);
+	flexScanBytes(scanner, input, length);
+	union SemanticValue semanticValue;
+	size_t tokens = 0;
+	while (flexLex(&semanticValue, scanner) != 0) {
+		++tokens;
+	}
+	yylex_destroy(scanner);
+	destroyArena(arena);
+	return tokens;
+}
+
+/**
+ * Measures the cost per token of the scanner with the specified logging
+ * level. The logs are discarded, so only their formatting is measured.
+ */
+static void _benchmarkScanner(const char * name, const char * loggingLevel, const size_t repetitions) {
+	setenv("LOGGING_LEVEL", loggingLevel, 1);
+	initializeFlexActionsModule();
+	size_t length = 0;
+	char * input = _createInput(repetitions, &length);
+	fflush(stdout);
+	const int standardOutput = dup(STDOUT_FILENO);
+	const int discardedOutput = open("/dev/null", O_WRONLY);
+	dup2(discardedOutput, STDOUT_FILENO);
+	_scan(input, length);
+	const double start = currentSeconds();
+	const size_t tokens = _scan(input, length);
+	const double seconds = currentSeconds() - start;
+	fflush(stdout);
+	dup2(standardOutput, STDOUT_FILENO);
+	close(discardedOutput);
+	close(standardOutput);
+	reportBenchmark("lexical-analysis", name, tokens, "token", seconds);
+	free(input);
+	shutdownFlexActionsModule();
+}
+
+/* PUBLIC FUNCTIONS */
+
+void benchmarkLexicalAnalysis(void) {
+	_benchmarkScanner("logging-off", "INFORMATION", 1000000);
+#ifndef DISABLE_DEBUGGING_LOGS
+	_benchmarkScanner("logging-debugging", "DEBUGGING", 20000);
+#endif
+	_benchmarkComments("comments-90%-matched", "false");
+	_benchmarkComments("comments-90%-skipped", "true");
+}
@@ -0,0 +1,157 @@
+#include "ProgramGenerator.h"
+
+/**
+ * A growable buffer, with the state of the generator.
+ */
+typedef struct {
+	char * bytes;
+	size_t capacity;
+	size_t commentBytes;
+	size_t length;
+	const ProgramShape * programShape;
+	unsigned int seed;
+} Generation;
+
+/* PRIVATE FUNCTIONS */
+
+static void _append(Generation * generation, const char * string, const size_t length);
+static char _chooseOperator(Generation * generation);
+static void _generateBalancedTerms(Generation * generation, const size_t terms);
+static void _generateComments(Generation * generation);
+static void _generateLiteral(Generation * generation, const boolean divisor);
+static void _generateOperator(Generation * generation, const char operator);
+static void _generateTerm(Generation * generation, const unsigned int depth);
+
+/**
+ * Appends a string to the program, keeping room for the final null bytes.
+ */
+static void _append(Generation * generation, const char * string, const size_t length) {
+	if (generation->capacity < generation->length + length + 2) {
+		generation->capacity = 2 * (generation->length + length + 2);
+		generation->bytes = realloc(generation->bytes, generation->capacity);
+	}
+	memcpy(generation->bytes + generation->length, string, length);
+	generation->length += length;
+}
+
+/**
+ * Chooses an operator at random, according to the weights of the shape.
+ */
+static char _chooseOperator(Generation * generation) {
+	const ProgramShape * programShape = generation->programShape;
+	const unsigned int total = programShape->additions + programShape->divisions + programShape->multiplications + programShape->subtractions;
+	unsigned int choice = total == 0 ? 0 : rand_r(&generation->seed) % total;
+	if (choice < programShape->additions) {
+		return '+';
+	}
+	choice -= programShape->additions;
+	if (choice < programShape->divisions) {
+		return '/';
+	}
+	choice -= programShape->divisions;
+	return choice < programShape->multiplications ? '*' : '-';
+}
+
+/**
+ * Appends a balanced tree with the requested amount of terms. A division
+ * divides the entire tree by a literal, instead of splitting it in two.
+ */
+static void _generateBalancedTerms(Generation * generation, const size_t terms) {
+	if (terms == 1) {
+		_generateTerm(generation, generation->programShape->depth);
+		return;
+	}
+	const char operator = _chooseOperator(generation);
+	_append(generation, "(", 1);
+	if (operator == '/') {
+		_generateBalancedTerms(generation, terms);
+		_generateOperator(generation, operator);
+		_generateLiteral(generation, true);
+	}
+	else {
+		_generateBalancedTerms(generation, terms / 2);
+		_generateOperator(generation, operator);
+		_generateBalancedTerms(generation, terms - terms / 2);
+	}
+	_append(generation, ")", 1);
+}
+
+/**
+ * Appends as many comments as needed to keep the requested density.
+ */
+static void _generateComments(Generation * generation) {
+	static const char comment[] = "/* A comment, with\n two lines. */ ";
+	const size_t commentLength = sizeof(comment) - 1;
+	while (100 * generation->commentBytes < generation->programShape->commentPercentage * (generation->length + commentLength)) {
+		_append(generation, comment, commentLength);
+		generation->commentBytes += commentLength;
+	}
+}
+
+/**
+ * Appends a literal with the requested amount of digits, without leading
+ * zeros (and without any zero, if it's a divisor).
+ */
+static void _generateLiteral(Generation * generation, const boolean divisor) {
+	char literal[16];
+	const unsigned int width = generation->programShape->literalWidth < 1 ? 1
+		: generation->programShape->literalWidth > 9 ? 9
+		: generation->programShape->literalWidth;
+	for (unsigned int k = 0; k < width; ++k) {
+		literal[k] = k == 0 || divisor
+			? '1' + rand_r(&generation->seed) % 9
+			: '0' + rand_r(&generation->seed) % 10;
+	}
+	_append(generation, literal, width);
+}
+
+/**
+ * Appends an operator surrounded by spaces (and comments, if needed).
+ */
+static void _generateOperator(Generation * generation, const char operator) {
+	const char string[] = { ' ', operator, ' ' };
+	_append(generation, string, 3);
+	_generateComments(generation);
+}
+
+/**
+ * Appends a term nested exactly "depth" parentheses deep.
+ */
+static void _generateTerm(Generation * generation, const unsigned int depth) {
+	if (depth == 0) {
+		_generateLiteral(generation, false);
+		return;
+	}
+	_append(generation, "(", 1);
+	_generateTerm(generation, depth - 1);
+	_generateOperator(generation, _chooseOperator(generation));
+	_generateLiteral(generation, true);
+	_append(generation, ")", 1);
+}
+
+/* PUBLIC FUNCTIONS */
+
+char * generateProgram(const ProgramShape * programShape, size_t * length) {
+	Generation generation = {
+		.bytes = NULL,
+		.capacity = 0,
+		.commentBytes = 0,
+		.length = 0,
+		.programShape = programShape,
+		.seed = programShape->seed
+	};
+	// Measures the length of a single term, to estimate how many of them the
+	// program needs.
+	_generateTerm(&generation, programShape->depth);
+	_generateOperator(&generation, '+');
+	const size_t terms = programShape->length / generation.length;
+	generation.commentBytes = 0;
+	generation.length = 0;
+	generation.seed = programShape->seed;
+	_generateBalancedTerms(&generation, terms < 1 ? 1 : terms);
+	_append(&generation, "\n", 1);
+	generation.bytes[generation.length] = '\0';
+	generation.bytes[generation.length + 1] = '\0';
+	*length = generation.length;
+	return generation.bytes;
+}
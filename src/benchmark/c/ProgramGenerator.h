@@ -0,0 +1,48 @@
+#ifndef PROGRAM_GENERATOR_HEADER
+#define PROGRAM_GENERATOR_HEADER
+
+#include "../../main/c/shared/Type.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The shape of a synthetic program. Every term of the program is nested
+ * exactly "depth" parentheses deep, and the terms are combined in a balanced
+ * tree (the output of the compiler is indented by depth, so it would grow
+ * quadratically with a long chain of terms). The right operand of a division
+ * is always a literal without zeros, so the programs never divide by zero.
+ */
+typedef struct {
+	// The relative weights of each operator (e.g., 1, 1, 0, 0 only adds and
+	// subtracts, in the same proportion).
+	unsigned int additions;
+	unsigned int divisions;
+	unsigned int multiplications;
+	unsigned int subtractions;
+
+	// The percentage of bytes inside comments (0 to 99).
+	unsigned int commentPercentage;
+
+	// The nesting depth of the parentheses of each term.
+	unsigned int depth;
+
+	// The approximate length of the program, in bytes.
+	size_t length;
+
+	// The amount of digits of every literal (1 to 9, so they fit in an int).
+	unsigned int literalWidth;
+
+	// The seed of the pseudo-random generator (the same seed and shape always
+	// generate the same program).
+	unsigned int seed;
+} ProgramShape;
+
+/**
+ * Generates a synthetic program with the specified shape. The program is
+ * followed by two null bytes, so it can be scanned in place, and it must be
+ * released with "free".
+ */
+char * generateProgram(const ProgramShape * programShape, size_t * length);
+
+#endif
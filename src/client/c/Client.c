@@ -0,0 +1,118 @@
+#include "../../main/c/driver/Server.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Reads an entire stream in memory. Returns NULL if it cannot be read, or if
+ * the system ran out of memory.
+ */
+static char * _readStream(FILE * stream, size_t * length) {
+	size_t capacity = 64 * 1024;
+	char * bytes = malloc(capacity);
+	*length = 0;
+	while (bytes != NULL) {
+		*length += fread(bytes + *length, 1, capacity - *length, stream);
+		if (*length < capacity) {
+			break;
+		}
+		capacity *= 2;
+		char * grown = realloc(bytes, capacity);
+		if (grown == NULL) {
+			free(bytes);
+		}
+		bytes = grown;
+	}
+	if (bytes != NULL && ferror(stream)) {
+		free(bytes);
+		return NULL;
+	}
+	return bytes;
+}
+
+/**
+ * Sends (or receives) exactly the specified amount of bytes.
+ */
+static int _transfer(const int socket, void * bytes, size_t length, const int sending) {
+	char * next = bytes;
+	while (0 < length) {
+		const ssize_t transferred = sending ? send(socket, next, length, MSG_NOSIGNAL) : recv(socket, next, length, 0);
+		if (transferred < 0 && errno == EINTR) {
+			continue;
+		}
+		if (transferred <= 0) {
+			return 0;
+		}
+		next += transferred;
+		length -= (size_t) transferred;
+	}
+	return 1;
+}
+
+/**
+ * A tiny client of the compile server, for testing. Sends a single request
+ * with the program of a file (or the standard input), prints the output of
+ * the response into the standard output, and exits with its status (as if
+ * the program was compiled by the compiler itself).
+ *
+ * Usage: CompilerClient <socket> [--evaluate | --statistics] [<program>]
+ */
+int main(const int count, const char ** arguments) {
+	if (count < 2) {
+		fprintf(stderr, "Usage: %s <socket> [--evaluate | --statistics] [<program>]\n", arguments[0]);
+		return 2;
+	}
+	ServerFrame request = {
+		.code = GENERATE_REQUEST,
+		.length = 0,
+		.reserved = 0
+	};
+	const char * path = NULL;
+	for (int k = 2; k < count; ++k) {
+		if (strcmp(arguments[k], "--evaluate") == 0) request.code = EVALUATE_REQUEST;
+		else if (strcmp(arguments[k], "--statistics") == 0) request.code = STATISTICS_REQUEST;
+		else path = arguments[k];
+	}
+	size_t length = 0;
+	char * program = NULL;
+	if (request.code != STATISTICS_REQUEST) {
+		FILE * stream = path == NULL ? stdin : fopen(path, "rb");
+		program = stream == NULL ? NULL : _readStream(stream, &length);
+		if (program == NULL) {
+			fprintf(stderr, "The program cannot be read: %s.\n", strerror(errno));
+			return 2;
+		}
+		if (stream != stdin) {
+			fclose(stream);
+		}
+	}
+	request.length = length;
+
+	struct sockaddr_un address = {
+		.sun_family = AF_UNIX
+	};
+	strncpy(address.sun_path, arguments[1], sizeof(address.sun_path) - 1);
+	const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (server < 0 || connect(server, (struct sockaddr *) &address, sizeof(address)) != 0) {
+		fprintf(stderr, "The server \"%s\" is not available: %s.\n", arguments[1], strerror(errno));
+		free(program);
+		return 2;
+	}
+	ServerFrame response;
+	int succeed = _transfer(server, &request, sizeof(request), 1)
+		&& _transfer(server, program, length, 1)
+		&& _transfer(server, &response, sizeof(response), 0);
+	free(program);
+	char buffer[64 * 1024];
+	for (uint64_t remaining = succeed ? response.length : 0; succeed && 0 < remaining;) {
+		const size_t chunk = remaining < sizeof(buffer) ? (size_t) remaining : sizeof(buffer);
+		succeed = _transfer(server, buffer, chunk, 0) && fwrite(buffer, 1, chunk, stdout) == chunk;
+		remaining -= chunk;
+	}
+	close(server);
+	if (!succeed || fflush(stdout) != 0) {
+		fprintf(stderr, "The response of the server is incomplete.\n");
+		return 2;
+	}
+	return (int) response.code;
+}
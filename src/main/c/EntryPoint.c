@@ -1,13 +1,132 @@
 #include "backend/code-generation/Generator.h"
+#include "backend/columnar-evaluation/ColumnarEvaluator.h"
 #include "backend/domain-specific/Calculator.h"
+#include "backend/native-code/NativeCode.h"
+#include "backend/virtual-machine/Bytecode.h"
+#include "backend/virtual-machine/VirtualMachine.h"
+#include "driver/Batch.h"
+#include "driver/Compilation.h"
+#include "driver/CompilationCache.h"
+#include "driver/Server.h"
+#include "driver/Table.h"
 #include "frontend/lexical-analysis/FlexActions.h"
+#include "frontend/lexical-analysis/IgnoredLexemes.h"
 #include "frontend/syntactic-analysis/AbstractSyntaxTree.h"
 #include "frontend/syntactic-analysis/BisonActions.h"
 #include "frontend/syntactic-analysis/SyntacticAnalyzer.h"
+#include "frontend/syntactic-analysis/TreeFile.h"
 #include "shared/CompilerState.h"
 #include "shared/Environment.h"
 #include "shared/Logger.h"
+#include "shared/MappedFile.h"
+#include "shared/Memory.h"
 #include "shared/String.h"
+#include "shared/Telemetry.h"
+
+/**
+ * Parses the value of the "--delimiter" argument: a single character, or one
+ * of the escape sequences "\0", "\n" and "\t". Returns false if the value is
+ * invalid.
+ */
+static boolean _parseDelimiter(const char * value, char * delimiter) {
+	if (strlen(value) == 1) {
+		*delimiter = value[0];
+		return true;
+	}
+	if (strcmp(value, "\\0") == 0) *delimiter = '\0';
+	else if (strcmp(value, "\\n") == 0) *delimiter = '\n';
+	else if (strcmp(value, "\\t") == 0) *delimiter = '\t';
+	else return false;
+	return true;
+}
+
+/**
+ * Compiles a single program (or its AST, if it was already loaded) and, in
+ * evaluation mode, outputs its value into the output stream of the compiler
+ * state.
+ */
+static CompilationStatus _compileProgram(CompilerState * compilerState, Logger * logger) {
+	CompilationStatus compilationStatus = compilerState->abstractSyntaxtTree == NULL ? compile(compilerState) : compileTree(compilerState);
+	if (compilationStatus == SUCCEED && compilerState->mode == EVALUATION_MODE) {
+		char * value = integerToString(compilerState->value);
+		if (value == NULL) {
+			logError(logger, "There is no memory left to print the value.");
+			compilationStatus = FAILED;
+		}
+		else {
+			fprintf(compilerState->output, "%s\n", value);
+			releaseMemory(value);
+		}
+	}
+	return compilationStatus;
+}
+
+/**
+ * Loads the AST of a tree file (written with the "--save-tree" argument), and
+ * compiles it without parsing anything, as a single program.
+ */
+static CompilationStatus _compileTreeFile(const char * path, const CompilationMode mode, Telemetry * telemetry, Logger * logger) {
+	TreeFile * treeFile = createTreeFile(path);
+	if (treeFile == NULL) {
+		return FAILED;
+	}
+	CompilerState compilerState = {
+		.abstractSyntaxtTree = treeFile->program,
+		.arena = createArena(ARENA_DEFAULT_BLOCK_SIZE),
+		.computed = false,
+		.input = NULL,
+		.mode = mode == EVALUATION_MODE ? EVALUATION_MODE : GENERATION_MODE,
+		.nodeTable = NULL,
+		.output = stdout,
+		.scanInPlace = false,
+		.scanner = NULL,
+		.source = NULL,
+		.sourceLength = 0,
+		.spilledTree = NULL,
+		.succeed = false,
+		.telemetry = telemetry,
+		.tokenRing = NULL,
+		.value = {
+			.big = NULL,
+			.small = 0
+		}
+	};
+	const CompilationStatus compilationStatus = _compileProgram(&compilerState, logger);
+	setMemoryPhase(RELEASE_PHASE);
+	destroyArena(compilerState.arena);
+	destroyTreeFile(treeFile);
+	setMemoryPhase(DRIVER_PHASE);
+	return compilationStatus;
+}
+
+/**
+ * Reads an entire stream in memory, followed by the padding of a mapped file
+ * (so it can be scanned in place). Returns NULL if the stream cannot be read,
+ * or if the system ran out of memory.
+ */
+static char * _readStream(FILE * stream, size_t * length) {
+	size_t capacity = 64 * 1024;
+	char * bytes = allocateMemory(capacity);
+	*length = 0;
+	while (bytes != NULL) {
+		*length += fread(bytes + *length, 1, capacity - *length - MAPPED_FILE_PADDING, stream);
+		if (*length < capacity - MAPPED_FILE_PADDING) {
+			break;
+		}
+		capacity *= 2;
+		char * grown = reallocateMemory(bytes, capacity);
+		if (grown == NULL) {
+			releaseMemory(bytes);
+		}
+		bytes = grown;
+	}
+	if (bytes == NULL || ferror(stream)) {
+		releaseMemory(bytes);
+		return NULL;
+	}
+	memset(bytes + *length, 0, MAPPED_FILE_PADDING);
+	return bytes;
+}
 
 /**
  * The main entry-point of the entire application. If you use "strtok" to
@@ -16,58 +135,261 @@
  */
 const int main(const int count, const char ** arguments) {
 	Logger * logger = createLogger("EntryPoint");
+	initializeTelemetryModule();
 	initializeFlexActionsModule();
+	initializeIgnoredLexemesModule();
 	initializeBisonActionsModule();
 	initializeSyntacticAnalyzerModule();
 	initializeAbstractSyntaxTreeModule();
 	initializeCalculatorModule();
+	initializeBytecodeModule();
+	initializeVirtualMachineModule();
+	initializeNativeCodeModule();
+	initializeColumnarEvaluatorModule();
 	initializeGeneratorModule();
+	initializeCompilationModule();
+	initializeCompilationCacheModule();
+	initializeBatchModule();
+	initializeTableModule();
+	initializeServerModule();
+	initializeTreeFileModule();
 
 	// Logs the arguments of the application.
 	for (int k = 0; k < count; ++k) {
 		logDebugging(logger, "Argument %d: \"%s\"", k, arguments[k]);
 	}
 
-	// Begin compilation process.
-	CompilerState compilerState = {
-		.abstractSyntaxtTree = NULL,
-		.succeed = false,
-		.value = 0
+	// Measures the compilation, if requested by the "TELEMETRY" variable.
+	Telemetry * telemetry = createTelemetry();
+
+	// Selects what the compilation must produce, and how many programs.
+	CompilationMode mode = getBooleanOrDefault("EVALUATE_ONLY", false) ? EVALUATION_MODE
+		: getBooleanOrDefault("STREAM_OUTPUT", false) ? STREAMING_MODE
+		: GENERATION_MODE;
+	boolean batch = false;
+	BatchConfiguration batchConfiguration = {
+		.delimiter = '\n',
+		.jobs = 0,
+		.outputDirectory = NULL,
+		.paths = allocateZeroedMemory(count, sizeof(const char *)),
+		.pathsCount = 0,
+		.telemetry = telemetry
 	};
-	const SyntacticAnalysisStatus syntacticAnalysisStatus = parse(&compilerState);
-	CompilationStatus compilationStatus = SUCCEED;
-	if (syntacticAnalysisStatus == ACCEPT) {
-		// ----------------------------------------------------------------------------------------
-		// Beginning of the Backend... ------------------------------------------------------------
-		logDebugging(logger, "Computing expression value...");
-		Program * program = compilerState.abstractSyntaxtTree;
-		ComputationResult computationResult = computeExpression(program->expression);
-		if (computationResult.succeed) {
-			compilerState.value = computationResult.value;
-			generate(&compilerState);
+	ServerConfiguration serverConfiguration = {
+		.jobs = 0,
+		.socketPath = NULL
+	};
+	TableConfiguration tableConfiguration = {
+		.bindings = allocateZeroedMemory(count, sizeof(const char *)),
+		.bindingsCount = 0,
+		.csvPath = NULL,
+		.programPath = NULL,
+		.resultPath = NULL
+	};
+	const char * loadTreePath = NULL;
+	const char * saveTreePath = NULL;
+	for (int k = 1; k < count; ++k) {
+		if (strcmp(arguments[k], "--evaluate") == 0) {
+			mode = EVALUATION_MODE;
+		}
+		else if (strcmp(arguments[k], "--stream") == 0) {
+			mode = mode == EVALUATION_MODE ? mode : STREAMING_MODE;
+		}
+		else if (strcmp(arguments[k], "--batch") == 0) {
+			batch = true;
+		}
+		else if (strncmp(arguments[k], "--delimiter=", 12) == 0) {
+			if (!_parseDelimiter(arguments[k] + 12, &batchConfiguration.delimiter)) {
+				logWarning(logger, "Ignoring invalid delimiter: \"%s\".", arguments[k] + 12);
+			}
+		}
+		else if (strncmp(arguments[k], "--jobs=", 7) == 0) {
+			batchConfiguration.jobs = (unsigned int) atoi(arguments[k] + 7);
+			serverConfiguration.jobs = batchConfiguration.jobs;
+		}
+		else if (strncmp(arguments[k], "--output-directory=", 19) == 0) {
+			batchConfiguration.outputDirectory = arguments[k] + 19;
+		}
+		else if (strncmp(arguments[k], "--bind=", 7) == 0) {
+			tableConfiguration.bindings[tableConfiguration.bindingsCount++] = arguments[k] + 7;
+		}
+		else if (strncmp(arguments[k], "--csv=", 6) == 0) {
+			tableConfiguration.csvPath = arguments[k] + 6;
+		}
+		else if (strncmp(arguments[k], "--result=", 9) == 0) {
+			tableConfiguration.resultPath = arguments[k] + 9;
+		}
+		else if (strncmp(arguments[k], "--server=", 9) == 0) {
+			serverConfiguration.socketPath = arguments[k] + 9;
+		}
+		else if (strncmp(arguments[k], "--load-tree=", 12) == 0) {
+			loadTreePath = arguments[k] + 12;
+		}
+		else if (strncmp(arguments[k], "--save-tree=", 12) == 0) {
+			saveTreePath = arguments[k] + 12;
+		}
+		else if (strncmp(arguments[k], "--", 2) != 0) {
+			batchConfiguration.paths[batchConfiguration.pathsCount++] = arguments[k];
 		}
 		else {
-			logError(logger, "The computation phase rejects the input program.");
-			compilationStatus = FAILED;
+			logWarning(logger, "Ignoring unknown argument: \"%s\".", arguments[k]);
 		}
-		// ...end of the Backend. -----------------------------------------------------------------
-		// ----------------------------------------------------------------------------------------
-		logDebugging(logger, "Releasing AST resources...");
-		releaseProgram(program);
+	}
+	batchConfiguration.mode = mode;
+	// The program is evaluated over columns if any variable is bound.
+	const boolean table = 0 < tableConfiguration.bindingsCount || tableConfiguration.csvPath != NULL;
+	tableConfiguration.programPath = 0 < batchConfiguration.pathsCount ? batchConfiguration.paths[0] : NULL;
+	const boolean server = serverConfiguration.socketPath != NULL;
+	if (server && (batch || table || 0 < batchConfiguration.pathsCount)) {
+		logWarning(logger, "Ignoring the programs, because the server receives them from its clients.");
+		batch = false;
+	}
+	if (table && batch) {
+		logWarning(logger, "Ignoring the batch mode, because there are bound variables.");
+		batch = false;
+	}
+	if (loadTreePath != NULL && (server || batch || table || saveTreePath != NULL || 0 < batchConfiguration.pathsCount)) {
+		logWarning(logger, "Ignoring the other programs and modes, because the program is loaded from a tree file.");
+	}
+	for (unsigned int k = 1; loadTreePath == NULL && !server && !batch && k < batchConfiguration.pathsCount; ++k) {
+		logWarning(logger, "Ignoring an extra program path outside of batch mode: \"%s\".", batchConfiguration.paths[k]);
+	}
+
+	// Begin compilation process.
+	CompilationStatus compilationStatus = SUCCEED;
+	if (loadTreePath != NULL) {
+		compilationStatus = _compileTreeFile(loadTreePath, mode, telemetry, logger);
+	}
+	else if (server) {
+		compilationStatus = serve(&serverConfiguration);
+	}
+	else if (batch) {
+		compilationStatus = compileBatch(&batchConfiguration);
+	}
+	else if (table) {
+		compilationStatus = evaluateTable(&tableConfiguration);
 	}
 	else {
-		logError(logger, "The syntactic-analysis phase rejects the input program.");
-		compilationStatus = FAILED;
+		// A program file is mapped in memory, and scanned in place. Any other
+		// file (e.g., a pipe) is scanned as a stream, as the standard input.
+		const char * path = 0 < batchConfiguration.pathsCount ? batchConfiguration.paths[0] : NULL;
+		MappedFile * mappedFile = NULL;
+		FILE * stream = path == NULL ? stdin : NULL;
+		if (path != NULL) {
+			mappedFile = createMappedFile(path);
+			if (mappedFile == NULL && errno == ENODEV) {
+				stream = fopen(path, "r");
+			}
+			if (mappedFile == NULL && stream == NULL) {
+				logError(logger, "The program \"%s\" cannot be read: %s.", path, strerror(errno));
+			}
+		}
+		// With a cache, a stream is read in advance, because its content is
+		// part of the key.
+		char * input = NULL;
+		size_t inputLength = 0;
+		const boolean caching = isCompilationCacheEnabled();
+		if (caching && stream != NULL) {
+			input = _readStream(stream, &inputLength);
+			if (input == NULL) {
+				logError(logger, "The program cannot be read from the stream: %s.", strerror(errno));
+			}
+		}
+		CompilerState compilerState = {
+			.abstractSyntaxtTree = NULL,
+			.arena = createArena(ARENA_DEFAULT_BLOCK_SIZE),
+			.computed = false,
+			.input = mappedFile == NULL && input == NULL ? stream : NULL,
+			.mode = mode,
+			.nodeTable = NULL,
+			.output = stdout,
+			.scanInPlace = mappedFile != NULL || input != NULL,
+			.scanner = NULL,
+			.source = mappedFile == NULL ? input : mappedFile->bytes,
+			.sourceLength = mappedFile == NULL ? inputLength : mappedFile->length,
+			.spilledTree = NULL,
+			.succeed = false,
+			.telemetry = telemetry,
+			.tokenRing = NULL,
+			.value = {
+				.big = NULL,
+				.small = 0
+			}
+		};
+		if (compilerState.source == NULL && (stream == NULL || caching)) {
+			compilationStatus = FAILED;
+		}
+		else if (saveTreePath != NULL) {
+			// The tree is only built in generation mode.
+			compilerState.mode = GENERATION_MODE;
+			compilationStatus = saveTree(&compilerState, saveTreePath);
+		}
+		else if (!caching) {
+			compilationStatus = _compileProgram(&compilerState, logger);
+		}
+		else {
+			// On a hit, the output and the status of a previous compilation
+			// are replayed, without compiling anything. On a miss, the output
+			// is captured in a new entry of the cache.
+			CacheKey cacheKey;
+			// Streaming only changes how the same output is generated.
+			computeCacheKey(compilerState.source, compilerState.sourceLength, mode == STREAMING_MODE ? GENERATION_MODE : mode, cacheKey);
+			if (!replayCacheEntry(cacheKey, stdout, &compilationStatus)) {
+				CacheEntry * cacheEntry = createCacheEntry(cacheKey);
+				compilerState.output = cacheEntry == NULL ? stdout : cacheEntry->stream;
+				compilationStatus = _compileProgram(&compilerState, logger);
+				if (cacheEntry != NULL && !commitCacheEntry(cacheEntry, compilationStatus, stdout)) {
+					compilationStatus = FAILED;
+				}
+			}
+		}
+		logDebugging(logger, "Releasing AST resources (%zu nodes, %zu bytes allocated, %zu bytes reserved)...",
+			compilerState.arena->allocations,
+			compilerState.arena->allocatedBytes,
+			compilerState.arena->reservedBytes);
+		const double start = telemetry == NULL ? 0 : telemetrySeconds();
+		setMemoryPhase(RELEASE_PHASE);
+		destroyArena(compilerState.arena);
+		setMemoryPhase(DRIVER_PHASE);
+		if (telemetry != NULL) {
+			telemetry->releaseSeconds += telemetrySeconds() - start;
+		}
+		if (mappedFile != NULL) {
+			destroyMappedFile(mappedFile);
+		}
+		if (stream != NULL && stream != stdin) {
+			fclose(stream);
+		}
+		releaseMemory(input);
+	}
+	releaseMemory(batchConfiguration.paths);
+	releaseMemory(tableConfiguration.bindings);
+	if (telemetry != NULL) {
+		reportTelemetry(telemetry);
+		destroyTelemetry(telemetry);
 	}
 
 	logDebugging(logger, "Releasing modules resources...");
+	shutdownTreeFileModule();
+	shutdownServerModule();
+	shutdownTableModule();
+	shutdownBatchModule();
+	shutdownCompilationCacheModule();
+	shutdownCompilationModule();
 	shutdownGeneratorModule();
+	shutdownColumnarEvaluatorModule();
+	shutdownNativeCodeModule();
+	shutdownVirtualMachineModule();
+	shutdownBytecodeModule();
 	shutdownCalculatorModule();
 	shutdownAbstractSyntaxTreeModule();
 	shutdownSyntacticAnalyzerModule();
 	shutdownBisonActionsModule();
+	shutdownIgnoredLexemesModule();
 	shutdownFlexActionsModule();
+	shutdownTelemetryModule();
 	logDebugging(logger, "Compilation is done.");
 	destroyLogger(logger);
+	reportMemory(stderr);
 	return compilationStatus;
 }
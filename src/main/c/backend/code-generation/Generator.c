@@ -4,9 +4,15 @@
 
 const char _indentationCharacter = ' ';
 const char _indentationSize = 4;
+static boolean _flushEveryLine = false;
+static boolean _generateOutput = true;
+static char _indentationTable[256];
 static Logger * _logger = NULL;
 
 void initializeGeneratorModule() {
+	_flushEveryLine = getBooleanOrDefault("FLUSH_EVERY_LINE", _flushEveryLine);
+	_generateOutput = getBooleanOrDefault("GENERATE_OUTPUT", _generateOutput);
+	memset(_indentationTable, _indentationCharacter, sizeof(_indentationTable));
 	_logger = createLogger("Generator");
 }
 
@@ -18,21 +24,54 @@ void shutdownGeneratorModule() {
 
 /** PRIVATE FUNCTIONS */
 
-static const char _expressionTypeToCharacter(const ExpressionType type);
-static void _generateConstant(const unsigned int indentationLevel, Constant * constant);
-static void _generateEpilogue(const int value);
-static void _generateExpression(const unsigned int indentationLevel, Expression * expression);
-static void _generateFactor(const unsigned int indentationLevel, Factor * factor);
-static void _generateProgram(Program * program);
-static void _generatePrologue(void);
-static char * _indentation(const unsigned int indentationLevel);
-static void _output(const unsigned int indentationLevel, const char * const format, ...);
+/**
+ * A pending step of the generation of an expression.
+ */
+typedef enum {
+	GENERATE_EXPRESSION,
+	GENERATE_SPILLED_EXPRESSION,
+	OUTPUT_OPERATOR,
+	OUTPUT_STRING
+} GenerationStepType;
+
+typedef struct {
+	union {
+		Expression * expression;
+		const char * string;
+
+		// The end of a spilled expression, inside its tree.
+		size_t end;
+
+		// The type of the expression of an operator.
+		ExpressionType operatorType;
+	};
+	unsigned int indentationLevel;
+	GenerationStepType type;
+} GenerationStep;
+
+static char _expressionTypeToCharacter(const ExpressionType type);
+static void _generateConstant(Writer * writer, const unsigned int indentationLevel, const Integer value);
+static void _generateEpilogue(Writer * writer, const Integer value);
+static boolean _generateExpressionStep(Writer * writer, Stack * steps, unsigned int indentationLevel, Expression * expression);
+static boolean _generateParentheses(Writer * writer, Stack * steps, const unsigned int indentationLevel);
+static boolean _generateProgram(Writer * writer, Program * program);
+static void _generatePrologue(Writer * writer);
+static boolean _generateSpilledExpressionStep(Writer * writer, SpilledTree * spilledTree, Stack * steps, const unsigned int indentationLevel, const size_t end);
+static boolean _generateSpilledLeaf(Writer * writer, SpilledTree * spilledTree, const unsigned int indentationLevel, const char * opening, const size_t start, const size_t length);
+static boolean _generateSpilledProgram(Writer * writer, SpilledTree * spilledTree);
+static boolean _generateSteps(Writer * writer, SpilledTree * spilledTree, Stack * steps);
+static void _generateVariable(Writer * writer, const unsigned int indentationLevel, const char * name);
+static void _indentation(Writer * writer, const unsigned int indentationLevel);
+static void _output(Writer * writer, const unsigned int indentationLevel, const char * const string);
+static boolean _pushOperatorStep(Stack * steps, const unsigned int indentationLevel, const ExpressionType type);
+static boolean _pushSpilledStep(Stack * steps, const unsigned int indentationLevel, const size_t end);
+static boolean _pushStep(Stack * steps, const GenerationStepType type, const unsigned int indentationLevel, const void * target);
 
 /**
  * Converts and expression type to the proper character of the operation
  * involved, or returns '\0' if that's not possible.
  */
-static const char _expressionTypeToCharacter(const ExpressionType type) {
+static char _expressionTypeToCharacter(const ExpressionType type) {
 	switch (type) {
 		case ADDITION: return '+';
 		case DIVISION: return '/';
@@ -45,21 +84,27 @@ static const char _expressionTypeToCharacter(const ExpressionType type) {
 }
 
 /**
- * Generates the output of a constant.
+ * Generates the output of a constant, inside its factor.
  */
-static void _generateConstant(const unsigned int indentationLevel, Constant * constant) {
-	_output(indentationLevel, "%s", "[ $C$, circle, draw, black!20\n");
-	_output(1 + indentationLevel, "%s%d%s", "[ $", constant->value, "$, circle, draw ]\n");
-	_output(indentationLevel, "%s", "]\n");
+static void _generateConstant(Writer * writer, const unsigned int indentationLevel, const Integer value) {
+	_output(writer, indentationLevel, "[ $F$, circle, draw, black!20\n");
+	_output(writer, 1 + indentationLevel, "[ $C$, circle, draw, black!20\n");
+	_output(writer, 2 + indentationLevel, "[ $");
+	writeLargeInteger(writer, value);
+	writeString(writer, "$, circle, draw ]\n");
+	_output(writer, 1 + indentationLevel, "]\n");
+	_output(writer, indentationLevel, "]\n");
 }
 
 /**
  * Creates the epilogue of the generated output, that is, the final lines that
  * completes a valid Latex document.
  */
-static void _generateEpilogue(const int value) {
-	_output(0, "%s%d%s",
-		"            [ $", value, "$, circle, draw, blue ]\n"
+static void _generateEpilogue(Writer * writer, const Integer value) {
+	_output(writer, 0, "            [ $");
+	writeLargeInteger(writer, value);
+	writeString(writer,
+		"$, circle, draw, blue ]\n"
 		"        ]\n"
 		"    \\end{forest}\n"
 		"\\end{document}\n\n"
@@ -67,55 +112,67 @@ static void _generateEpilogue(const int value) {
 }
 
 /**
- * Generates the output of an expression.
+ * Opens the output of an expression, and pushes the steps that complete it,
+ * in reverse order. Its parentheses are opened first, each one as the
+ * expression and the factor that enclose it in the grammar. Returns false if
+ * the stack couldn't grow.
  */
-static void _generateExpression(const unsigned int indentationLevel, Expression * expression) {
-	_output(indentationLevel, "%s", "[ $E$, circle, draw, black!20\n");
+static boolean _generateExpressionStep(Writer * writer, Stack * steps, unsigned int indentationLevel, Expression * expression) {
+	boolean succeed = true;
+	for (uint32_t k = 0; succeed && k < expression->parentheses; ++k) {
+		succeed = _generateParentheses(writer, steps, indentationLevel);
+		indentationLevel += 2;
+	}
+	_output(writer, indentationLevel, "[ $E$, circle, draw, black!20\n");
+	succeed = succeed && _pushStep(steps, OUTPUT_STRING, indentationLevel, "]\n");
 	switch (expression->type) {
 		case ADDITION:
 		case DIVISION:
 		case MULTIPLICATION:
 		case SUBTRACTION:
-			_generateExpression(1 + indentationLevel, expression->leftExpression);
-			_output(1 + indentationLevel, "%s%c%s", "[ $", _expressionTypeToCharacter(expression->type), "$, circle, draw, purple ]\n");
-			_generateExpression(1 + indentationLevel, expression->rightExpression);
-			break;
-		case FACTOR:
-			_generateFactor(1 + indentationLevel, expression->factor);
-			break;
+			return succeed
+				&& _pushStep(steps, GENERATE_EXPRESSION, 1 + indentationLevel, expression->rightExpression)
+				&& _pushOperatorStep(steps, 1 + indentationLevel, expression->type)
+				&& _pushStep(steps, GENERATE_EXPRESSION, 1 + indentationLevel, expression->leftExpression);
+		case CONSTANT:
+			_generateConstant(writer, 1 + indentationLevel, expression->value);
+			return succeed;
+		case VARIABLE:
+			_generateVariable(writer, 1 + indentationLevel, expression->name);
+			return succeed;
 		default:
+			flushWriter(writer);
 			logError(_logger, "The specified expression type is unknown: %d", expression->type);
-			break;
+			return succeed;
 	}
-	_output(indentationLevel, "%s", "]\n");
 }
 
 /**
- * Generates the output of a factor.
+ * Opens the output of a pair of parentheses, that is, an expression with a
+ * factor with the parentheses, and pushes the steps that close it. The
+ * expression inside goes two levels deeper. Returns false if the stack
+ * couldn't grow.
  */
-static void _generateFactor(const unsigned int indentationLevel, Factor * factor) {
-	_output(indentationLevel, "%s", "[ $F$, circle, draw, black!20\n");
-	switch (factor->type) {
-		case CONSTANT:
-			_generateConstant(1 + indentationLevel, factor->constant);
-			break;
-		case EXPRESSION:
-			_output(1 + indentationLevel, "%s", "[ $($, circle, draw, purple ]\n");
-			_generateExpression(1 + indentationLevel, factor->expression);
-			_output(1 + indentationLevel, "%s", "[ $)$, circle, draw, purple ]\n");
-			break;
-		default:
-			logError(_logger, "The specified factor type is unknown: %d", factor->type);
-			break;
-	}
-	_output(indentationLevel, "%s", "]\n");
+static boolean _generateParentheses(Writer * writer, Stack * steps, const unsigned int indentationLevel) {
+	_output(writer, indentationLevel, "[ $E$, circle, draw, black!20\n");
+	_output(writer, 1 + indentationLevel, "[ $F$, circle, draw, black!20\n");
+	_output(writer, 2 + indentationLevel, "[ $($, circle, draw, purple ]\n");
+	return _pushStep(steps, OUTPUT_STRING, indentationLevel, "]\n")
+		&& _pushStep(steps, OUTPUT_STRING, 1 + indentationLevel, "]\n")
+		&& _pushStep(steps, OUTPUT_STRING, 2 + indentationLevel, "[ $)$, circle, draw, purple ]\n");
 }
 
 /**
- * Generates the output of the program.
+ * Generates the output of the program. The pending steps are kept in an
+ * explicit stack instead of the native one, so the depth of the expression is
+ * only limited by the available memory. Returns false if a step fails.
  */
-static void _generateProgram(Program * program) {
-	_generateExpression(3, program->expression);
+static boolean _generateProgram(Writer * writer, Program * program) {
+	Stack * steps = createStack(sizeof(GenerationStep), 64);
+	const boolean succeed = _pushStep(steps, GENERATE_EXPRESSION, 3, program->expression)
+		&& _generateSteps(writer, NULL, steps);
+	destroyStack(steps);
+	return succeed;
 }
 
 /**
@@ -124,8 +181,8 @@ static void _generateProgram(Program * program) {
  *
  * @see https://ctan.dcc.uchile.cl/graphics/pgf/contrib/forest/forest-doc.pdf
  */
-static void _generatePrologue(void) {
-	_output(0, "%s",
+static void _generatePrologue(Writer * writer) {
+	_output(writer, 0,
 		"\\documentclass{standalone}\n\n"
 		"\\usepackage[utf8]{inputenc}\n"
 		"\\usepackage[T1]{fontenc}\n"
@@ -140,35 +197,229 @@ static void _generatePrologue(void) {
 }
 
 /**
- * Generates an indentation string for the specified level.
+ * Opens the output of a spilled expression (with its factor, if any), and
+ * pushes the steps that complete it, in reverse order. The operands of an
+ * arithmetic expression (or the expression inside parentheses) are the
+ * subtrees right before its record. Returns false if the stack couldn't grow,
+ * or if the spilled tree couldn't be read.
+ */
+static boolean _generateSpilledExpressionStep(Writer * writer, SpilledTree * spilledTree, Stack * steps, const unsigned int indentationLevel, const size_t end) {
+	const char * record = readSpilledTree(spilledTree, end - sizeof(SpilledExpression), sizeof(SpilledExpression));
+	if (record == NULL) {
+		flushWriter(writer);
+		logError(_logger, "The spilled tree cannot be read.");
+		return false;
+	}
+	SpilledExpression spilledExpression;
+	memcpy(&spilledExpression, record, sizeof(SpilledExpression));
+	const size_t start = end - sizeof(SpilledExpression) - spilledExpression.payloadLength;
+	if (spilledExpression.parenthesized) {
+		return _generateParentheses(writer, steps, indentationLevel)
+			&& _pushSpilledStep(steps, 2 + indentationLevel, start);
+	}
+	_output(writer, indentationLevel, "[ $E$, circle, draw, black!20\n");
+	boolean succeed = _pushStep(steps, OUTPUT_STRING, indentationLevel, "]\n");
+	switch (spilledExpression.type) {
+		case ADDITION:
+		case DIVISION:
+		case MULTIPLICATION:
+		case SUBTRACTION:
+			return succeed
+				&& _pushSpilledStep(steps, 1 + indentationLevel, start)
+				&& _pushOperatorStep(steps, 1 + indentationLevel, spilledExpression.type)
+				&& _pushSpilledStep(steps, 1 + indentationLevel, spilledExpression.leftEnd);
+		case CONSTANT:
+			return succeed
+				&& _generateSpilledLeaf(writer, spilledTree, 1 + indentationLevel, "[ $C$, circle, draw, black!20\n", start, spilledExpression.payloadLength);
+		case VARIABLE:
+			return succeed
+				&& _generateSpilledLeaf(writer, spilledTree, 1 + indentationLevel, "[ $V$, circle, draw, black!20\n", start, spilledExpression.payloadLength);
+		default:
+			flushWriter(writer);
+			logError(_logger, "The specified expression type is unknown: %d", spilledExpression.type);
+			return succeed;
+	}
+}
+
+/**
+ * Generates the output of a spilled constant or variable, inside its factor,
+ * as the ones of the AST. Its payload is the text of the leaf, which is read
+ * with its record, so both are in the same window of the spilled tree.
+ * Returns false if the spilled tree couldn't be read.
+ */
+static boolean _generateSpilledLeaf(Writer * writer, SpilledTree * spilledTree, const unsigned int indentationLevel, const char * opening, const size_t start, const size_t length) {
+	const char * payload = readSpilledTree(spilledTree, start, length + sizeof(SpilledExpression));
+	if (payload == NULL) {
+		flushWriter(writer);
+		logError(_logger, "The spilled tree cannot be read.");
+		return false;
+	}
+	_output(writer, indentationLevel, "[ $F$, circle, draw, black!20\n");
+	_output(writer, 1 + indentationLevel, opening);
+	_output(writer, 2 + indentationLevel, "[ $");
+	writeBytes(writer, payload, length);
+	writeString(writer, "$, circle, draw ]\n");
+	_output(writer, 1 + indentationLevel, "]\n");
+	_output(writer, indentationLevel, "]\n");
+	return true;
+}
+
+/**
+ * Generates the output of the program from its spilled tree, whose root is
+ * the last expression written. Returns false if a step fails.
+ */
+static boolean _generateSpilledProgram(Writer * writer, SpilledTree * spilledTree) {
+	Stack * steps = createStack(sizeof(GenerationStep), 64);
+	const boolean succeed = _pushSpilledStep(steps, 3, spilledTree->length)
+		&& _generateSteps(writer, spilledTree, steps);
+	destroyStack(steps);
+	return succeed;
+}
+
+/**
+ * Executes the pending steps of the generation until there are none left (or
+ * until a step fails). Returns false if a step fails.
+ */
+static boolean _generateSteps(Writer * writer, SpilledTree * spilledTree, Stack * steps) {
+	boolean succeed = true;
+	while (succeed && !isEmptyStack(steps)) {
+		GenerationStep step;
+		popStack(steps, &step);
+		switch (step.type) {
+			case GENERATE_EXPRESSION:
+				succeed = _generateExpressionStep(writer, steps, step.indentationLevel, step.expression);
+				break;
+			case GENERATE_SPILLED_EXPRESSION:
+				succeed = _generateSpilledExpressionStep(writer, spilledTree, steps, step.indentationLevel, step.end);
+				break;
+			case OUTPUT_OPERATOR:
+				_output(writer, step.indentationLevel, "[ $");
+				writeCharacter(writer, _expressionTypeToCharacter(step.operatorType));
+				writeString(writer, "$, circle, draw, purple ]\n");
+				break;
+			case OUTPUT_STRING:
+				_output(writer, step.indentationLevel, step.string);
+				break;
+		}
+	}
+	return succeed;
+}
+
+/**
+ * Generates the output of a variable, inside its factor.
+ */
+static void _generateVariable(Writer * writer, const unsigned int indentationLevel, const char * name) {
+	_output(writer, indentationLevel, "[ $F$, circle, draw, black!20\n");
+	_output(writer, 1 + indentationLevel, "[ $V$, circle, draw, black!20\n");
+	_output(writer, 2 + indentationLevel, "[ $");
+	writeString(writer, name);
+	writeString(writer, "$, circle, draw ]\n");
+	_output(writer, 1 + indentationLevel, "]\n");
+	_output(writer, indentationLevel, "]\n");
+}
+
+/**
+ * Writes the indentation for the specified level, in chunks taken from a
+ * precomputed table (so it doesn't allocate any memory).
+ */
+static void _indentation(Writer * writer, const unsigned int indentationLevel) {
+	size_t pending = (size_t) indentationLevel * _indentationSize;
+	while (0 < pending) {
+		const size_t chunk = pending < sizeof(_indentationTable) ? pending : sizeof(_indentationTable);
+		writeBytes(writer, _indentationTable, chunk);
+		pending -= chunk;
+	}
+}
+
+/**
+ * Pushes a new pending step that outputs the operator of an expression.
+ * Returns false if the stack couldn't grow.
+ */
+static boolean _pushOperatorStep(Stack * steps, const unsigned int indentationLevel, const ExpressionType type) {
+	GenerationStep step = {
+		.indentationLevel = indentationLevel,
+		.operatorType = type,
+		.type = OUTPUT_OPERATOR
+	};
+	if (pushStack(steps, &step)) {
+		return true;
+	}
+	logError(_logger, "The generation ran out of memory.");
+	return false;
+}
+
+/**
+ * Pushes a new pending step over the spilled expression that ends at the
+ * specified offset of its tree. Returns false if the stack couldn't grow.
+ */
+static boolean _pushSpilledStep(Stack * steps, const unsigned int indentationLevel, const size_t end) {
+	GenerationStep step = {
+		.end = end,
+		.indentationLevel = indentationLevel,
+		.type = GENERATE_SPILLED_EXPRESSION
+	};
+	if (pushStack(steps, &step)) {
+		return true;
+	}
+	logError(_logger, "The generation ran out of memory.");
+	return false;
+}
+
+/**
+ * Pushes a new pending step over the specified node or string. Returns false
+ * if the stack couldn't grow.
  */
-static char * _indentation(const unsigned int level) {
-	return indentation(_indentationCharacter, level, _indentationSize);
+static boolean _pushStep(Stack * steps, const GenerationStepType type, const unsigned int indentationLevel, const void * target) {
+	GenerationStep step = {
+		.indentationLevel = indentationLevel,
+		.string = target,
+		.type = type
+	};
+	if (pushStack(steps, &step)) {
+		return true;
+	}
+	logError(_logger, "The generation ran out of memory.");
+	return false;
 }
 
 /**
- * Outputs a formatted string to standard output. The "fflush" instruction
- * allows to see the output even close to a failure, because it drops the
- * buffering.
+ * Outputs an indented string through the writer. The output is buffered, and
+ * it's flushed at the end of the generation or before logging an error,
+ * unless the "FLUSH_EVERY_LINE" variable asks to flush it after every line,
+ * which allows to see the output even close to a failure.
  */
-static void _output(const unsigned int indentationLevel, const char * const format, ...) {
-	va_list arguments;
-	va_start(arguments, format);
-	char * indentation = _indentation(indentationLevel);
-	char * effectiveFormat = concatenate(2, indentation, format);
-	vfprintf(stdout, effectiveFormat, arguments);
-	fflush(stdout);
-	free(effectiveFormat);
-	free(indentation);
-	va_end(arguments);
+static void _output(Writer * writer, const unsigned int indentationLevel, const char * const string) {
+	_indentation(writer, indentationLevel);
+	writeString(writer, string);
 }
 
 /** PUBLIC FUNCTIONS */
 
-void generate(CompilerState * compilerState) {
+boolean generate(CompilerState * compilerState) {
+	if (!_generateOutput) {
+		logDebugging(_logger, "The generation of the final output is disabled.");
+		return true;
+	}
 	logDebugging(_logger, "Generating final output...");
-	_generatePrologue();
-	_generateProgram(compilerState->abstractSyntaxtTree);
-	_generateEpilogue(compilerState->value);
+	Writer * writer = createWriter(compilerState->output, WRITER_DEFAULT_CAPACITY, _flushEveryLine);
+	_generatePrologue(writer);
+	const boolean generated = compilerState->spilledTree == NULL
+		? _generateProgram(writer, compilerState->abstractSyntaxtTree)
+		: _generateSpilledProgram(writer, compilerState->spilledTree);
+	if (generated) {
+		_generateEpilogue(writer, compilerState->value);
+	}
+	if (compilerState->telemetry != NULL) {
+		compilerState->telemetry->emittedBytes += writer->writtenBytes;
+	}
+	const boolean written = destroyWriter(writer);
+	if (!written) {
+		logError(_logger, "The output could not be written completely.");
+	}
 	logDebugging(_logger, "Generation is done.");
+	return generated && written;
+}
+
+boolean isGenerationEnabled(void) {
+	return _generateOutput;
 }
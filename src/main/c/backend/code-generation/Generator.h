@@ -3,10 +3,13 @@
 
 #include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
 #include "../../shared/CompilerState.h"
+#include "../../shared/Environment.h"
 #include "../../shared/Logger.h"
-#include "../../shared/String.h"
-#include <stdarg.h>
+#include "../../shared/Stack.h"
+#include "../../shared/Writer.h"
+#include "SpilledTree.h"
 #include <stdio.h>
+#include <string.h>
 
 /** Initialize module's internal state. */
 void initializeGeneratorModule();
@@ -15,8 +18,17 @@ void initializeGeneratorModule();
 void shutdownGeneratorModule();
 
 /**
- * Generates the final output using the current compiler state.
+ * Generates the final output using the current compiler state, into its
+ * output stream. In streaming mode, the tree is read from the spilled tree
+ * of the compiler state, instead of from the AST. Returns false if the output
+ * could not be generated or written completely.
  */
-void generate(CompilerState * compilerState);
+boolean generate(CompilerState * compilerState);
+
+/**
+ * Returns true unless the "GENERATE_OUTPUT" variable disables the generation
+ * of the final output.
+ */
+boolean isGenerationEnabled(void);
 
 #endif
@@ -0,0 +1,236 @@
+#include "SpilledTree.h"
+
+/* PRIVATE FUNCTIONS */
+
+static void _append(SpilledTree * spilledTree, const void * bytes, const size_t length);
+static boolean _readFile(SpilledTree * spilledTree, char * bytes, const size_t start, const size_t length);
+static void _spillExpression(SpilledTree * spilledTree, const ExpressionType type, const boolean parenthesized, const size_t leftEnd, const char * payload);
+static boolean _startSubtree(SpilledTree * spilledTree);
+static boolean _writeFile(SpilledTree * spilledTree, const void * bytes, const size_t length);
+
+/**
+ * Appends bytes to the tree. When the buffer is full, its bytes are moved
+ * into the temporary file (and the new ones too, if they don't fit in it).
+ */
+static void _append(SpilledTree * spilledTree, const void * bytes, const size_t length) {
+	if (spilledTree->bufferCapacity - spilledTree->bufferLength < length) {
+		if (!_writeFile(spilledTree, spilledTree->buffer, spilledTree->bufferLength)) {
+			spilledTree->failed = true;
+		}
+		spilledTree->bufferStart += spilledTree->bufferLength;
+		spilledTree->bufferLength = 0;
+	}
+	if (spilledTree->bufferCapacity < length) {
+		if (!_writeFile(spilledTree, bytes, length)) {
+			spilledTree->failed = true;
+		}
+		spilledTree->bufferStart += length;
+	}
+	else {
+		memcpy(spilledTree->buffer + spilledTree->bufferLength, bytes, length);
+		spilledTree->bufferLength += length;
+	}
+	spilledTree->length += length;
+}
+
+/**
+ * Reads a range of the temporary file into some bytes. Returns false if the
+ * range cannot be read completely.
+ */
+static boolean _readFile(SpilledTree * spilledTree, char * bytes, const size_t start, const size_t length) {
+	const int file = fileno(spilledTree->file);
+	size_t read = 0;
+	while (read < length) {
+		const ssize_t result = pread(file, bytes + read, length - read, (off_t) (start + read));
+		if (result < 0 && errno == EINTR) {
+			continue;
+		}
+		if (result <= 0) {
+			return false;
+		}
+		read += (size_t) result;
+	}
+	return true;
+}
+
+/**
+ * Writes the record of an expression, after its payload (if any).
+ */
+static void _spillExpression(SpilledTree * spilledTree, const ExpressionType type, const boolean parenthesized, const size_t leftEnd, const char * payload) {
+	const SpilledExpression spilledExpression = {
+		.leftEnd = leftEnd,
+		.parenthesized = parenthesized,
+		.payloadLength = payload == NULL ? 0 : strlen(payload),
+		.type = type
+	};
+	if (payload != NULL) {
+		_append(spilledTree, payload, spilledExpression.payloadLength);
+	}
+	_append(spilledTree, &spilledExpression, sizeof(SpilledExpression));
+}
+
+/**
+ * Keeps the beginning of a new subtree, which starts at the end of the tree.
+ * Returns false if there is no memory left.
+ */
+static boolean _startSubtree(SpilledTree * spilledTree) {
+	if (pushStack(spilledTree->starts, &spilledTree->length)) {
+		return true;
+	}
+	spilledTree->failed = true;
+	return false;
+}
+
+/**
+ * Appends bytes to the temporary file, which is created on the first write.
+ * Returns false if they cannot be written.
+ */
+static boolean _writeFile(SpilledTree * spilledTree, const void * bytes, const size_t length) {
+	if (spilledTree->file == NULL) {
+		spilledTree->file = tmpfile();
+	}
+	return spilledTree->file != NULL && fwrite(bytes, sizeof(char), length, spilledTree->file) == length;
+}
+
+/* PUBLIC FUNCTIONS */
+
+SpilledTree * createSpilledTree(void) {
+	SpilledTree * spilledTree = allocateZeroedMemory(1, sizeof(SpilledTree));
+	if (spilledTree == NULL) {
+		return NULL;
+	}
+	spilledTree->buffer = allocateMemory(SPILLED_TREE_BUFFER_CAPACITY);
+	spilledTree->bufferCapacity = SPILLED_TREE_BUFFER_CAPACITY;
+	spilledTree->starts = createStack(sizeof(size_t), 64);
+	if (spilledTree->buffer == NULL || spilledTree->starts == NULL) {
+		destroySpilledTree(spilledTree);
+		return NULL;
+	}
+	return spilledTree;
+}
+
+void destroySpilledTree(SpilledTree * spilledTree) {
+	if (spilledTree != NULL) {
+		if (spilledTree->file != NULL) {
+			fclose(spilledTree->file);
+		}
+		if (spilledTree->starts != NULL) {
+			destroyStack(spilledTree->starts);
+		}
+		releaseMemory(spilledTree->buffer);
+		releaseMemory(spilledTree);
+	}
+}
+
+const char * readSpilledTree(SpilledTree * spilledTree, const size_t offset, const size_t length) {
+	if (spilledTree->failed || spilledTree->length < offset + length) {
+		return NULL;
+	}
+	if (spilledTree->file == NULL) {
+		// The entire tree is in the buffer.
+		spilledTree->reading = true;
+		return spilledTree->buffer + offset;
+	}
+	if (!spilledTree->reading) {
+		// The pending bytes complete the file, and the windows start empty.
+		spilledTree->failed = !_writeFile(spilledTree, spilledTree->buffer, spilledTree->bufferLength) || fflush(spilledTree->file) != 0;
+		spilledTree->bufferLength = 0;
+		spilledTree->reading = true;
+		spilledTree->windowCapacity = spilledTree->bufferCapacity / SPILLED_TREE_WINDOWS;
+		if (spilledTree->failed) {
+			return NULL;
+		}
+	}
+	spilledTree->reads += 1;
+	unsigned int replaced = 0;
+	for (unsigned int k = 0; k < SPILLED_TREE_WINDOWS; ++k) {
+		SpilledTreeWindow * window = &spilledTree->windows[k];
+		if (window->start <= offset && offset + length <= window->start + window->length) {
+			window->lastRead = spilledTree->reads;
+			return spilledTree->buffer + k * spilledTree->windowCapacity + (offset - window->start);
+		}
+		if (window->lastRead < spilledTree->windows[replaced].lastRead) {
+			replaced = k;
+		}
+	}
+	if (spilledTree->windowCapacity < length) {
+		// Every window grows, so they are all read again.
+		char * buffer = reallocateMemory(spilledTree->buffer, SPILLED_TREE_WINDOWS * length);
+		if (buffer == NULL) {
+			spilledTree->failed = true;
+			return NULL;
+		}
+		spilledTree->buffer = buffer;
+		spilledTree->bufferCapacity = SPILLED_TREE_WINDOWS * length;
+		spilledTree->windowCapacity = length;
+		memset(spilledTree->windows, 0, sizeof(spilledTree->windows));
+		replaced = 0;
+	}
+	// The window is centered on the bytes requested, since the traversal can
+	// continue on either side of them (the operands come before their
+	// expression, but the right one after the left one).
+	const size_t capacity = spilledTree->windowCapacity;
+	size_t start = offset + length / 2 < capacity / 2 ? 0 : offset + length / 2 - capacity / 2;
+	if (spilledTree->length - start < capacity) {
+		start = spilledTree->length < capacity ? 0 : spilledTree->length - capacity;
+	}
+	const size_t remaining = spilledTree->length - start;
+	SpilledTreeWindow * window = &spilledTree->windows[replaced];
+	char * bytes = spilledTree->buffer + replaced * capacity;
+	window->length = 0;
+	if (!_readFile(spilledTree, bytes, start, remaining < capacity ? remaining : capacity)) {
+		spilledTree->failed = true;
+		return NULL;
+	}
+	window->start = start;
+	window->length = remaining < capacity ? remaining : capacity;
+	window->lastRead = spilledTree->reads;
+	return bytes + (offset - start);
+}
+
+void spillArithmeticExpression(SpilledTree * spilledTree, const ExpressionType type) {
+	if (spilledTree->failed || spilledTree->starts->size < 2) {
+		spilledTree->failed = true;
+		return;
+	}
+	// The beginning of the left operand becomes the one of the expression.
+	size_t rightStart;
+	popStack(spilledTree->starts, &rightStart);
+	_spillExpression(spilledTree, type, false, rightStart, NULL);
+}
+
+void spillConstant(SpilledTree * spilledTree, const Integer value) {
+	if (spilledTree->failed || !_startSubtree(spilledTree)) {
+		return;
+	}
+	if (value.big == NULL) {
+		char digits[24];
+		snprintf(digits, sizeof(digits), "%" PRId64, value.small);
+		_spillExpression(spilledTree, CONSTANT, false, 0, digits);
+	}
+	else {
+		char * digits = integerToString(value);
+		if (digits == NULL) {
+			spilledTree->failed = true;
+			return;
+		}
+		_spillExpression(spilledTree, CONSTANT, false, 0, digits);
+		releaseMemory(digits);
+	}
+}
+
+void spillParenthesizedExpression(SpilledTree * spilledTree) {
+	if (spilledTree->failed || isEmptyStack(spilledTree->starts)) {
+		spilledTree->failed = true;
+		return;
+	}
+	// The expression inside is the beginning of the parentheses too.
+	_spillExpression(spilledTree, ADDITION, true, 0, NULL);
+}
+
+void spillVariable(SpilledTree * spilledTree, const char * name) {
+	if (spilledTree->failed || !_startSubtree(spilledTree)) {
+		return;
+	}
+	_spillExpression(spilledTree, VARIABLE, false, 0, name);
+}
@@ -0,0 +1,125 @@
+#ifndef SPILLED_TREE_HEADER
+#define SPILLED_TREE_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Integer.h"
+#include "../../shared/Memory.h"
+#include "../../shared/Stack.h"
+#include "../../shared/Type.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * The size of the buffer of a spilled tree, in bytes. A tree that doesn't fit
+ * in it is moved into a temporary file, and the buffer is split in windows
+ * over that file when the tree is read back. There are two, since a traversal
+ * can move through two distant ranges at once (e.g., the leaves and the
+ * records of their parents, in a right-nested expression).
+ */
+#define SPILLED_TREE_BUFFER_CAPACITY (256 * 1024)
+#define SPILLED_TREE_WINDOWS 2
+
+/**
+ * The record of a spilled expression, right after its payload (the digits of
+ * a constant, or the name of a variable). The expression is an arithmetic
+ * one, a constant, a variable, or a pair of parentheses around the subtree
+ * right before the record (since it's already written when the parentheses
+ * close).
+ */
+typedef struct {
+	// The end of the left operand, which is the beginning of the right one
+	// (only for the arithmetic expressions).
+	size_t leftEnd;
+
+	// The length of the payload before the record.
+	size_t payloadLength;
+
+	// The type of the expression (unless it's a pair of parentheses).
+	ExpressionType type;
+	boolean parenthesized;
+} SpilledExpression;
+
+/**
+ * A range of the temporary file, read into a part of the buffer.
+ */
+typedef struct {
+	size_t start;
+	size_t length;
+
+	// When it was read last (to replace the least recently read window).
+	size_t lastRead;
+} SpilledTreeWindow;
+
+/**
+ * An AST written in post-order while it's parsed, as a sequence of spilled
+ * expressions, instead of being built in memory. Every subtree occupies a
+ * contiguous range, which ends with the record of its root: the operands of
+ * an arithmetic expression (and the expression inside parentheses) are the
+ * ranges right before it. So it can be traversed in any order from the end of
+ * the last record, reading only the records visited. While it's written, it
+ * only keeps in memory the beginning of every subtree without a parent yet.
+ */
+typedef struct {
+	// The bytes of the tree that are in memory, and where they start in the
+	// tree (i.e., the ones not written yet).
+	char * buffer;
+	size_t bufferCapacity;
+	size_t bufferLength;
+	size_t bufferStart;
+
+	// The windows read from the temporary file, each one over its own part of
+	// the buffer, and the amount of reads.
+	SpilledTreeWindow windows[SPILLED_TREE_WINDOWS];
+	size_t windowCapacity;
+	size_t reads;
+
+	// The temporary file, only if the tree didn't fit in the buffer.
+	FILE * file;
+
+	// The length of the entire tree, in bytes.
+	size_t length;
+
+	// If true, the tree is complete, and it can only be read.
+	boolean reading;
+
+	// The beginnings of the subtrees without a parent yet.
+	Stack * starts;
+
+	// If true, the tree could not be written (or read) completely.
+	boolean failed;
+} SpilledTree;
+
+/**
+ * Creates an empty spilled tree. The temporary file is only created if the
+ * tree doesn't fit in the buffer. Returns NULL if there is no memory left.
+ */
+SpilledTree * createSpilledTree(void);
+
+/**
+ * Destroys a spilled tree, and removes its temporary file.
+ */
+void destroySpilledTree(SpilledTree * spilledTree);
+
+/**
+ * Reads a range of the complete tree. The returned bytes are only valid until
+ * the next read, and they may be unaligned. Returns NULL if they cannot be
+ * read.
+ */
+const char * readSpilledTree(SpilledTree * spilledTree, const size_t offset, const size_t length);
+
+/**
+ * Spill functions: each one writes a complete subtree, whose children (if
+ * any) are the subtrees written just before (left to right). A failure is
+ * kept in the tree.
+ */
+
+void spillArithmeticExpression(SpilledTree * spilledTree, const ExpressionType type);
+void spillConstant(SpilledTree * spilledTree, const Integer value);
+void spillParenthesizedExpression(SpilledTree * spilledTree);
+void spillVariable(SpilledTree * spilledTree, const char * name);
+
+#endif
@@ -0,0 +1,222 @@
+#include "ColumnarEvaluator.h"
+
+/**
+ * The kernels that the compiler vectorizes are cloned for AVX2 (4 rows per
+ * instruction) and for the baseline of x86-64 (SSE2, with 2 rows), and the
+ * loader picks the best one for the host. Elsewhere, they're compiled once.
+ */
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__)
+	#define COLUMNAR_KERNEL __attribute__((target_clones("avx2", "default")))
+#else
+	#define COLUMNAR_KERNEL
+#endif
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeColumnarEvaluatorModule() {
+	_logger = createLogger("ColumnarEvaluator");
+}
+
+void shutdownColumnarEvaluatorModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The failures of a row, accumulated over every operator of a block.
+ */
+typedef enum {
+	COLUMNAR_DIVISION_BY_ZERO = 1,
+	COLUMNAR_OVERFLOW = 2
+} ColumnarFault;
+
+static void _addBlock(int64_t * restrict left, const int64_t * restrict right, uint8_t * restrict faults, const size_t length);
+static const int64_t ** _bindVariables(const Bytecode * bytecode, const Column * columns, const size_t columnsCount);
+static void _divideBlock(int64_t * restrict left, const int64_t * restrict right, uint8_t * restrict faults, const size_t length);
+static void _multiplyBlock(int64_t * restrict left, const int64_t * restrict right, uint8_t * restrict faults, const size_t length);
+static void _storeBlock(ColumnarResult * columnarResult, const int64_t * values, const uint8_t * faults, const size_t start, const size_t length);
+static void _subtractBlock(int64_t * restrict left, const int64_t * restrict right, uint8_t * restrict faults, const size_t length);
+
+/**
+ * Adds two blocks. The sum overflows if its sign differs from the signs of
+ * both addends, which is computed without branches.
+ */
+COLUMNAR_KERNEL
+static void _addBlock(int64_t * restrict left, const int64_t * restrict right, uint8_t * restrict faults, const size_t length) {
+	for (size_t k = 0; k < length; ++k) {
+		const int64_t sum = (int64_t) ((uint64_t) left[k] + (uint64_t) right[k]);
+		faults[k] |= (uint8_t) (((uint64_t) ((left[k] ^ sum) & (right[k] ^ sum)) >> 63) * COLUMNAR_OVERFLOW);
+		left[k] = sum;
+	}
+}
+
+/**
+ * Finds the column of every variable of the bytecode. Returns NULL if any of
+ * them is not bound, or if the system ran out of memory.
+ */
+static const int64_t ** _bindVariables(const Bytecode * bytecode, const Column * columns, const size_t columnsCount) {
+	const int64_t ** bindings = allocateZeroedMemory(1 + bytecode->variablesLength, sizeof(const int64_t *));
+	if (bindings == NULL) {
+		logError(_logger, "The columnar evaluation ran out of memory.");
+		return NULL;
+	}
+	for (size_t k = 0; k < bytecode->variablesLength; ++k) {
+		for (size_t c = 0; bindings[k] == NULL && c < columnsCount; ++c) {
+			if (strcmp(bytecode->variables[k], columns[c].name) == 0) {
+				bindings[k] = columns[c].values;
+			}
+		}
+		if (bindings[k] == NULL) {
+			logError(_logger, "The variable \"%s\" is not bound to any column.", bytecode->variables[k]);
+			releaseMemory(bindings);
+			return NULL;
+		}
+	}
+	return bindings;
+}
+
+/**
+ * Divides two blocks, truncating toward zero. The rows that divide by zero,
+ * or the minimum by -1 (which overflows), are divided by 1 instead, so the
+ * loop never traps.
+ */
+static void _divideBlock(int64_t * restrict left, const int64_t * restrict right, uint8_t * restrict faults, const size_t length) {
+	for (size_t k = 0; k < length; ++k) {
+		const uint8_t byZero = right[k] == 0;
+		const uint8_t overflow = left[k] == INT64_MIN && right[k] == -1;
+		faults[k] |= (uint8_t) (byZero * COLUMNAR_DIVISION_BY_ZERO | overflow * COLUMNAR_OVERFLOW);
+		left[k] /= (byZero | overflow) ? 1 : right[k];
+	}
+}
+
+/**
+ * Multiplies two blocks (x86-64 has no vector multiplication of 64-bit
+ * integers that detects the overflow, so this loop is scalar).
+ */
+static void _multiplyBlock(int64_t * restrict left, const int64_t * restrict right, uint8_t * restrict faults, const size_t length) {
+	for (size_t k = 0; k < length; ++k) {
+		faults[k] |= (uint8_t) (__builtin_mul_overflow(left[k], right[k], &left[k]) * COLUMNAR_OVERFLOW);
+	}
+}
+
+/**
+ * Copies the values of a block into the result, and packs its faults into the
+ * validity mask. The start of a block is always a multiple of 64.
+ */
+static void _storeBlock(ColumnarResult * columnarResult, const int64_t * values, const uint8_t * faults, const size_t start, const size_t length) {
+	memcpy(columnarResult->values + start, values, length * sizeof(int64_t));
+	for (size_t k = 0; k < length; k += 64) {
+		uint64_t word = 0;
+		const size_t end = length < k + 64 ? length : k + 64;
+		for (size_t j = k; j < end; ++j) {
+			word |= (uint64_t) (faults[j] == 0) << (j - k);
+			columnarResult->divisionsByZero += (faults[j] & COLUMNAR_DIVISION_BY_ZERO) != 0;
+			columnarResult->overflows += (faults[j] & COLUMNAR_OVERFLOW) != 0;
+		}
+		columnarResult->validity[(start + k) / 64] = word;
+		columnarResult->invalidRows += (end - k) - (size_t) __builtin_popcountll(word);
+	}
+}
+
+/**
+ * Subtracts two blocks. The difference overflows if the operands have
+ * different signs, and the sign of the difference is not the one of the
+ * minuend.
+ */
+COLUMNAR_KERNEL
+static void _subtractBlock(int64_t * restrict left, const int64_t * restrict right, uint8_t * restrict faults, const size_t length) {
+	for (size_t k = 0; k < length; ++k) {
+		const int64_t difference = (int64_t) ((uint64_t) left[k] - (uint64_t) right[k]);
+		faults[k] |= (uint8_t) (((uint64_t) ((left[k] ^ right[k]) & (left[k] ^ difference)) >> 63) * COLUMNAR_OVERFLOW);
+		left[k] = difference;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+ColumnarResult * evaluateColumns(const Bytecode * bytecode, const Column * columns, const size_t columnsCount, const size_t rows) {
+	for (size_t k = 0; k < bytecode->length; ++k) {
+		if (bytecode->instructions[k].opcode == PUSH_INTEGER && bytecode->instructions[k].operand.big != NULL) {
+			logError(_logger, "The program has a constant bigger than 64 bits, which cannot be evaluated over columns.");
+			return NULL;
+		}
+	}
+	const int64_t ** bindings = _bindVariables(bytecode, columns, columnsCount);
+	if (bindings == NULL) {
+		return NULL;
+	}
+	ColumnarResult * columnarResult = allocateZeroedMemory(1, sizeof(ColumnarResult));
+	int64_t * stack = allocateMemory((1 + bytecode->stackDepth) * COLUMNAR_BLOCK_SIZE * sizeof(int64_t));
+	uint8_t * faults = allocateMemory(COLUMNAR_BLOCK_SIZE);
+	if (columnarResult != NULL) {
+		columnarResult->rows = rows;
+		columnarResult->values = allocateMemory((rows == 0 ? 1 : rows) * sizeof(int64_t));
+		columnarResult->validity = allocateZeroedMemory(COLUMNAR_VALIDITY_WORDS(rows) + 1, sizeof(uint64_t));
+	}
+	if (columnarResult == NULL || columnarResult->values == NULL || columnarResult->validity == NULL || stack == NULL || faults == NULL) {
+		logError(_logger, "The columnar evaluation ran out of memory.");
+		destroyColumnarResult(columnarResult);
+		releaseMemory(bindings);
+		releaseMemory(stack);
+		releaseMemory(faults);
+		return NULL;
+	}
+	logDebugging(_logger, "Evaluating %zu rows in blocks of %d...", rows, COLUMNAR_BLOCK_SIZE);
+	for (size_t start = 0; start < rows; start += COLUMNAR_BLOCK_SIZE) {
+		const size_t length = rows - start < COLUMNAR_BLOCK_SIZE ? rows - start : COLUMNAR_BLOCK_SIZE;
+		memset(faults, 0, length);
+		// The block "k" of the stack starts at "k * COLUMNAR_BLOCK_SIZE", and
+		// every operator leaves its result in the block of its left operand.
+		size_t size = 0;
+		for (size_t k = 0; k < bytecode->length; ++k) {
+			const Instruction * instruction = bytecode->instructions + k;
+			switch (instruction->opcode) {
+				case ADD_INTEGERS:
+					--size;
+					_addBlock(stack + (size - 1) * COLUMNAR_BLOCK_SIZE, stack + size * COLUMNAR_BLOCK_SIZE, faults, length);
+					break;
+				case DIVIDE_INTEGERS:
+					--size;
+					_divideBlock(stack + (size - 1) * COLUMNAR_BLOCK_SIZE, stack + size * COLUMNAR_BLOCK_SIZE, faults, length);
+					break;
+				case MULTIPLY_INTEGERS:
+					--size;
+					_multiplyBlock(stack + (size - 1) * COLUMNAR_BLOCK_SIZE, stack + size * COLUMNAR_BLOCK_SIZE, faults, length);
+					break;
+				case PUSH_INTEGER: {
+					int64_t * block = stack + size++ * COLUMNAR_BLOCK_SIZE;
+					for (size_t j = 0; j < length; ++j) {
+						block[j] = instruction->operand.small;
+					}
+					break;
+				}
+				case PUSH_VARIABLE:
+					memcpy(stack + size++ * COLUMNAR_BLOCK_SIZE, bindings[instruction->operand.small] + start, length * sizeof(int64_t));
+					break;
+				case SUBTRACT_INTEGERS:
+					--size;
+					_subtractBlock(stack + (size - 1) * COLUMNAR_BLOCK_SIZE, stack + size * COLUMNAR_BLOCK_SIZE, faults, length);
+					break;
+			}
+		}
+		_storeBlock(columnarResult, stack, faults, start, length);
+	}
+	logDebugging(_logger, "Columnar evaluation is done (%zu invalid rows).", columnarResult->invalidRows);
+	releaseMemory(bindings);
+	releaseMemory(stack);
+	releaseMemory(faults);
+	return columnarResult;
+}
+
+void destroyColumnarResult(ColumnarResult * columnarResult) {
+	if (columnarResult != NULL) {
+		releaseMemory(columnarResult->values);
+		releaseMemory(columnarResult->validity);
+		releaseMemory(columnarResult);
+	}
+}
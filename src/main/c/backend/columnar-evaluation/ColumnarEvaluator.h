@@ -0,0 +1,71 @@
+#ifndef COLUMNAR_EVALUATOR_HEADER
+#define COLUMNAR_EVALUATOR_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Memory.h"
+#include "../../shared/Type.h"
+#include "../virtual-machine/Bytecode.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeColumnarEvaluatorModule();
+
+/** Shutdown module's internal state. */
+void shutdownColumnarEvaluatorModule();
+
+/**
+ * The amount of rows evaluated at once by every operator. Each slot of the
+ * value stack holds a block of this size, so the loops of the operators are
+ * long enough to be vectorized, and the stack still fits in the cache.
+ */
+#define COLUMNAR_BLOCK_SIZE 512
+
+/**
+ * An input column, which binds a variable to one value per row.
+ */
+typedef struct {
+	const char * name;
+	const int64_t * values;
+} Column;
+
+/**
+ * The result column of a columnar evaluation, with its validity mask: the bit
+ * "k % 64" of the word "k / 64" is set if the row "k" succeed. The value of
+ * an invalid row is meaningless.
+ */
+typedef struct {
+	int64_t * values;
+	uint64_t * validity;
+	size_t rows;
+
+	// The amount of invalid rows, and of the rows with each kind of failure
+	// (a row can fail in both ways).
+	size_t invalidRows;
+	size_t divisionsByZero;
+	size_t overflows;
+} ColumnarResult;
+
+/**
+ * The length of the validity mask of a result, in 64-bit words.
+ */
+#define COLUMNAR_VALIDITY_WORDS(rows) (((rows) + 63) / 64)
+
+/**
+ * Evaluates a bytecode once per row of its input columns, binding each
+ * variable to the first column with the same name. The rows are evaluated in
+ * blocks, one operator at a time over the entire block, on 64-bit integers:
+ * a row that divides by zero or overflows is marked as invalid instead of
+ * stopping the evaluation (or being promoted to arbitrary-precision). Returns
+ * NULL if a variable is not bound, if a constant doesn't fit in 64 bits, or if
+ * the system ran out of memory.
+ */
+ColumnarResult * evaluateColumns(const Bytecode * bytecode, const Column * columns, const size_t columnsCount, const size_t rows);
+
+/**
+ * Destroy a columnar result, and its columns.
+ */
+void destroyColumnarResult(ColumnarResult * columnarResult);
+
+#endif
@@ -16,9 +16,130 @@ void shutdownCalculatorModule() {
 
 /** PRIVATE FUNCTIONS */
 
+/**
+ * A pending step of a computation. The steps are kept in an explicit stack
+ * instead of the native one, so the depth of the expressions is only limited
+ * by the available memory.
+ */
+typedef enum {
+	APPLY_OPERATOR,
+	EVALUATE_EXPRESSION
+} ComputationStepType;
+
+typedef struct {
+	Expression * expression;
+	ComputationStepType type;
+} ComputationStep;
+
+/**
+ * The values of the shared expressions already computed (so each one is
+ * computed only once), in an open-addressing hash table keyed on their
+ * addresses.
+ */
+typedef struct {
+	const Expression * expression;
+	Integer value;
+} MemoizedValue;
+
+typedef struct {
+	MemoizedValue * values;
+	size_t capacity;
+	size_t length;
+} Memo;
+
+static ComputationResult _compute(Arena * arena, const ComputationStep initialStep);
+static boolean _enoughMemory(const boolean succeed);
 static BinaryOperator _expressionTypeToBinaryOperator(const ExpressionType type);
-static ComputationResult _invalidBinaryOperator(const int x, const int y);
+static ComputationResult _invalidBinaryOperator(Arena * arena, const Integer x, const Integer y);
 static ComputationResult _invalidComputation();
+static size_t _memoSlot(const Memo * memo, const Expression * expression);
+static void _memoize(Memo * memo, const Expression * expression, const Integer value);
+static boolean _pushStep(Stack * steps, const ComputationStepType type, Expression * expression);
+static boolean _recall(const Memo * memo, const Expression * expression, Integer * value);
+
+/**
+ * Computes the value of a node in post-order, using a stack of pending steps
+ * and a stack of intermediate values. The value of a shared expression is
+ * memoized, so the next occurrences reuse it. The computation stops at the
+ * first failure.
+ */
+static ComputationResult _compute(Arena * arena, const ComputationStep initialStep) {
+	Memo memo = {
+		.capacity = 0,
+		.length = 0,
+		.values = NULL
+	};
+	Stack * steps = createStack(sizeof(ComputationStep), 64);
+	Stack * values = createStack(sizeof(Integer), 64);
+	boolean succeed = pushStack(steps, &initialStep);
+	while (succeed && !isEmptyStack(steps)) {
+		ComputationStep step;
+		popStack(steps, &step);
+		switch (step.type) {
+			case APPLY_OPERATOR: {
+				Integer leftValue;
+				Integer rightValue;
+				popStack(values, &rightValue);
+				popStack(values, &leftValue);
+				BinaryOperator binaryOperator = _expressionTypeToBinaryOperator(step.expression->type);
+				ComputationResult computationResult = binaryOperator(arena, leftValue, rightValue);
+				succeed = computationResult.succeed && pushStack(values, &computationResult.value);
+				if (succeed && step.expression->shared) {
+					_memoize(&memo, step.expression, computationResult.value);
+				}
+				break;
+			}
+			case EVALUATE_EXPRESSION:
+				switch (step.expression->type) {
+					case ADDITION:
+					case DIVISION:
+					case MULTIPLICATION:
+					case SUBTRACTION: {
+						Integer value;
+						if (step.expression->shared && _recall(&memo, step.expression, &value)) {
+							succeed = pushStack(values, &value);
+							break;
+						}
+						succeed = _pushStep(steps, APPLY_OPERATOR, step.expression)
+							&& _pushStep(steps, EVALUATE_EXPRESSION, step.expression->rightExpression)
+							&& _pushStep(steps, EVALUATE_EXPRESSION, step.expression->leftExpression);
+						break;
+					}
+					case CONSTANT:
+						succeed = pushStack(values, &step.expression->value);
+						break;
+					case VARIABLE:
+						// Only a columnar evaluation binds the variables.
+						logError(_logger, "The variable \"%s\" is not bound.", step.expression->name);
+						succeed = false;
+						break;
+					default:
+						succeed = false;
+				}
+				break;
+		}
+	}
+	ComputationResult computationResult = _invalidComputation();
+	if (succeed) {
+		computationResult.succeed = true;
+		popStack(values, &computationResult.value);
+	}
+	destroyStack(values);
+	destroyStack(steps);
+	releaseMemory(memo.values);
+	return computationResult;
+}
+
+/**
+ * Logs an error if an operation ran out of memory (i.e., if it didn't
+ * succeed), and returns the same flag.
+ */
+static boolean _enoughMemory(const boolean succeed) {
+	if (!succeed) {
+		logError(_logger, "The computation ran out of memory.");
+	}
+	return succeed;
+}
 
 /**
  * Converts and expression type to the proper binary operator. If that's not
@@ -40,7 +161,10 @@ static BinaryOperator _expressionTypeToBinaryOperator(const ExpressionType type)
 /**
  * A binary operator that always returns an invalid computation result.
  */
-static ComputationResult _invalidBinaryOperator(const int x, const int y) {
+static ComputationResult _invalidBinaryOperator(Arena * arena, const Integer x, const Integer y) {
+	(void) arena;
+	(void) x;
+	(void) y;
 	return _invalidComputation();
 }
 
@@ -50,87 +174,135 @@ static ComputationResult _invalidBinaryOperator(const int x, const int y) {
 static ComputationResult _invalidComputation() {
 	ComputationResult computationResult = {
 		.succeed = false,
-		.value = 0
+		.value = {
+			.big = NULL,
+			.small = 0
+		}
 	};
 	return computationResult;
 }
 
-/** PUBLIC FUNCTIONS */
+/**
+ * Returns the slot of an expression in the memo (which is not full), or of
+ * the empty one where it should be.
+ */
+static size_t _memoSlot(const Memo * memo, const Expression * expression) {
+	size_t slot = (size_t) (((uintptr_t) expression * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & (memo->capacity - 1);
+	while (memo->values[slot].expression != NULL && memo->values[slot].expression != expression) {
+		slot = (slot + 1) & (memo->capacity - 1);
+	}
+	return slot;
+}
 
-ComputationResult add(const int leftAddend, const int rightAddend) {
-	ComputationResult computationResult = {
-		.succeed = true,
-		.value = leftAddend + rightAddend
+/**
+ * Keeps the value of an expression in the memo. If the memo can't grow, the
+ * value is not kept (so it will be computed again).
+ */
+static void _memoize(Memo * memo, const Expression * expression, const Integer value) {
+	if (memo->capacity <= 2 * (memo->length + 1)) {
+		Memo grown = {
+			.capacity = memo->capacity == 0 ? 64 : 2 * memo->capacity,
+			.length = memo->length,
+			.values = NULL
+		};
+		grown.values = allocateZeroedMemory(grown.capacity, sizeof(MemoizedValue));
+		if (grown.values == NULL) {
+			return;
+		}
+		for (size_t k = 0; k < memo->capacity; ++k) {
+			if (memo->values[k].expression != NULL) {
+				grown.values[_memoSlot(&grown, memo->values[k].expression)] = memo->values[k];
+			}
+		}
+		releaseMemory(memo->values);
+		*memo = grown;
+	}
+	MemoizedValue * memoizedValue = memo->values + _memoSlot(memo, expression);
+	if (memoizedValue->expression == NULL) {
+		memoizedValue->expression = expression;
+		memoizedValue->value = value;
+		memo->length += 1;
+	}
+}
+
+/**
+ * Pushes a new pending step over the specified expression. Returns false if
+ * the stack couldn't grow.
+ */
+static boolean _pushStep(Stack * steps, const ComputationStepType type, Expression * expression) {
+	ComputationStep step = {
+		.expression = expression,
+		.type = type
 	};
-	return computationResult;
+	if (pushStack(steps, &step)) {
+		return true;
+	}
+	logError(_logger, "The computation ran out of memory.");
+	return false;
 }
 
-ComputationResult divide(const int dividend, const int divisor) {
-	const int sign = dividend < 0 ? -1 : +1;
-	const boolean divisionByZero = divisor == 0 ? true : false;
-	if (divisionByZero) {
-		logError(_logger, "The divisor cannot be zero (the computation was %d/%d).", dividend, divisor);
+/**
+ * Finds the value of an expression in the memo. Returns false if it was not
+ * computed yet.
+ */
+static boolean _recall(const Memo * memo, const Expression * expression, Integer * value) {
+	if (memo->length == 0) {
+		return false;
 	}
-	ComputationResult computationResult = {
-		.succeed = divisionByZero ? false : true,
-		.value = divisionByZero ? (sign * INT_MAX) : (dividend / divisor)
-	};
+	const MemoizedValue * memoizedValue = memo->values + _memoSlot(memo, expression);
+	if (memoizedValue->expression == NULL) {
+		return false;
+	}
+	*value = memoizedValue->value;
+	return true;
+}
+
+/** PUBLIC FUNCTIONS */
+
+ComputationResult add(Arena * arena, const Integer leftAddend, const Integer rightAddend) {
+	ComputationResult computationResult = _invalidComputation();
+	computationResult.succeed = _enoughMemory(addIntegers(arena, leftAddend, rightAddend, &computationResult.value));
 	return computationResult;
 }
 
-ComputationResult multiply(const int multiplicand, const int multiplier) {
-	ComputationResult computationResult = {
-		.succeed = true,
-		.value = multiplicand * multiplier
-	};
+ComputationResult divide(Arena * arena, const Integer dividend, const Integer divisor) {
+	ComputationResult computationResult = _invalidComputation();
+	if (isZeroInteger(divisor)) {
+		char * digits = integerToString(dividend);
+		logError(_logger, "The divisor cannot be zero (the computation was %s/0).", digits == NULL ? "?" : digits);
+		releaseMemory(digits);
+		return computationResult;
+	}
+	computationResult.succeed = _enoughMemory(divideIntegers(arena, dividend, divisor, &computationResult.value));
 	return computationResult;
 }
 
-ComputationResult subtract(const int minuend, const int subtract) {
-	ComputationResult computationResult = {
-		.succeed = true,
-		.value = minuend - subtract
-	};
+ComputationResult multiply(Arena * arena, const Integer multiplicand, const Integer multiplier) {
+	ComputationResult computationResult = _invalidComputation();
+	computationResult.succeed = _enoughMemory(multiplyIntegers(arena, multiplicand, multiplier, &computationResult.value));
 	return computationResult;
 }
 
-ComputationResult computeConstant(Constant * constant) {
-	ComputationResult computationResult = {
-		.succeed = true,
-		.value = constant->value
-	};
+ComputationResult subtract(Arena * arena, const Integer minuend, const Integer subtrahend) {
+	ComputationResult computationResult = _invalidComputation();
+	computationResult.succeed = _enoughMemory(subtractIntegers(arena, minuend, subtrahend, &computationResult.value));
 	return computationResult;
 }
 
-ComputationResult computeExpression(Expression * expression) {
-	switch (expression->type) {
-		case ADDITION:
-		case DIVISION:
-		case MULTIPLICATION:
-		case SUBTRACTION:
-			ComputationResult leftResult = computeExpression(expression->leftExpression);
-			ComputationResult rightResult = computeExpression(expression->rightExpression);
-			if (leftResult.succeed && rightResult.succeed) {
-				BinaryOperator binaryOperator = _expressionTypeToBinaryOperator(expression->type);
-				return binaryOperator(leftResult.value, rightResult.value);
-			}
-			else {
-				return _invalidComputation();
-			}
-		case FACTOR:
-			return computeFactor(expression->factor);
-		default:
-			return _invalidComputation();
+ComputationResult computeBinaryOperation(Arena * arena, const ExpressionType type, const ComputationResult leftResult, const ComputationResult rightResult) {
+	if (leftResult.succeed && rightResult.succeed) {
+		BinaryOperator binaryOperator = _expressionTypeToBinaryOperator(type);
+		return binaryOperator(arena, leftResult.value, rightResult.value);
+	}
+	else {
+		return _invalidComputation();
 	}
 }
 
-ComputationResult computeFactor(Factor * factor) {
-	switch (factor->type) {
-		case CONSTANT:
-			return computeConstant(factor->constant);
-		case EXPRESSION:
-			return computeExpression(factor->expression);
-		default:
-			return _invalidComputation();
-	}
+ComputationResult computeExpression(Arena * arena, Expression * expression) {
+	ComputationStep step = {
+		.expression = expression,
+		.type = EVALUATE_EXPRESSION
+	};
+	return _compute(arena, step);
 }
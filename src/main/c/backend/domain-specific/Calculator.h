@@ -7,9 +7,12 @@
  * domain-specific models or DTOs (Data Transfer Objects).
  */
 #include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Arena.h"
+#include "../../shared/Integer.h"
 #include "../../shared/Logger.h"
+#include "../../shared/Memory.h"
+#include "../../shared/Stack.h"
 #include "../../shared/Type.h"
-#include <limits.h>
 
 /** Initialize module's internal state. */
 void initializeCalculatorModule();
@@ -23,31 +26,31 @@ void shutdownCalculatorModule();
  */
 typedef struct {
 	boolean succeed;
-	int value;
+	Integer value;
 } ComputationResult;
 
-typedef ComputationResult (*BinaryOperator)(const int, const int);
-
-/** Arithmetic operations. */
-
-ComputationResult add(const int leftAddend, const int rightAddend);
-ComputationResult divide(const int dividend, const int divisor);
-ComputationResult multiply(const int multiplicand, const int multiplier);
-ComputationResult subtract(const int minuend, const int subtract);
+typedef ComputationResult (*BinaryOperator)(Arena *, const Integer, const Integer);
 
 /**
- * Computes the final value of a mathematical constant.
+ * Arithmetic operations. They never overflow: the values that don't fit in 64
+ * bits are promoted to arbitrary-precision, inside the arena. They fail if
+ * there is no memory left, or if the divisor is zero.
  */
-ComputationResult computeConstant(Constant * constant);
+
+ComputationResult add(Arena * arena, const Integer leftAddend, const Integer rightAddend);
+ComputationResult divide(Arena * arena, const Integer dividend, const Integer divisor);
+ComputationResult multiply(Arena * arena, const Integer multiplicand, const Integer multiplier);
+ComputationResult subtract(Arena * arena, const Integer minuend, const Integer subtrahend);
 
 /**
- * Computes the final value of a mathematical expression.
+ * Computes a binary operation over two partial results. If any of them is
+ * invalid, the result is invalid too.
  */
-ComputationResult computeExpression(Expression * expression);
+ComputationResult computeBinaryOperation(Arena * arena, const ExpressionType type, const ComputationResult leftResult, const ComputationResult rightResult);
 
 /**
- * Computes the final value of a mathematical factor.
+ * Computes the final value of a mathematical expression.
  */
-ComputationResult computeFactor(Factor * factor);
+ComputationResult computeExpression(Arena * arena, Expression * expression);
 
 #endif
@@ -0,0 +1,280 @@
+#include "NativeCode.h"
+
+/**
+ * The machine code is only generated with GCC-compatible compilers on x86-64
+ * and with the System V ABI (i.e., not on Microsoft Windows), where the
+ * executable memory is reserved with "mmap". Otherwise, nothing is compiled.
+ */
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(_WIN32)
+	#include <sys/mman.h>
+	#include <unistd.h>
+	#define NATIVE_CODE
+#endif
+
+/**
+ * The value stacks up to this depth are kept in the native stack of the
+ * caller, instead of in heap-memory.
+ */
+#define NATIVE_CODE_LOCAL_DEPTH 64
+
+/**
+ * The largest amount of bytes emitted per instruction (a division), and for
+ * the handlers, the prologue and the epilogue.
+ */
+#define NATIVE_CODE_INSTRUCTION_SIZE 48
+#define NATIVE_CODE_FIXED_SIZE 64
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeNativeCodeModule() {
+	_logger = createLogger("NativeCode");
+}
+
+void shutdownNativeCodeModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The status returned by a native function.
+ */
+typedef enum {
+	NATIVE_SUCCEED = 0,
+	NATIVE_OVERFLOW = 1,
+	NATIVE_DIVISION_BY_ZERO = 2
+} NativeStatus;
+
+#ifdef NATIVE_CODE
+
+/**
+ * The machine code while it's emitted, and the offsets of the handlers of
+ * the failures (which are emitted first, so every jump to them is backwards
+ * and needs no patching).
+ */
+typedef struct {
+	uint8_t * bytes;
+	size_t length;
+	size_t divisionByZeroHandler;
+	size_t overflowHandler;
+} MachineCode;
+
+static void _emit(MachineCode * machineCode, const uint8_t * bytes, const size_t length);
+static void _emitInstruction(MachineCode * machineCode, const Instruction * instruction, size_t * depth);
+static void _emitJump(MachineCode * machineCode, const uint8_t condition, const size_t target);
+
+/**
+ * Appends raw bytes to the machine code.
+ */
+static void _emit(MachineCode * machineCode, const uint8_t * bytes, const size_t length) {
+	memcpy(machineCode->bytes + machineCode->length, bytes, length);
+	machineCode->length += length;
+}
+
+/**
+ * Emits a single instruction of the bytecode. The top of the value stack is
+ * kept in RAX, and the rest of the stack in memory, below RSI (so a push only
+ * spills RAX if the stack is not empty). RCX and RDX are scratch registers.
+ */
+static void _emitInstruction(MachineCode * machineCode, const Instruction * instruction, size_t * depth) {
+	// sub rsi, 8 (pops the left operand, which is left at [rsi])
+	static const uint8_t pop[] = { 0x48, 0x83, 0xEE, 0x08 };
+	switch (instruction->opcode) {
+		case ADD_INTEGERS: {
+			// add rax, [rsi]
+			static const uint8_t add[] = { 0x48, 0x03, 0x06 };
+			_emit(machineCode, pop, sizeof(pop));
+			_emit(machineCode, add, sizeof(add));
+			_emitJump(machineCode, 0x80, machineCode->overflowHandler);
+			--*depth;
+			break;
+		}
+		case DIVIDE_INTEGERS: {
+			// mov rcx, rax; test rcx, rcx
+			static const uint8_t testDivisor[] = { 0x48, 0x89, 0xC1, 0x48, 0x85, 0xC9 };
+			// mov rax, [rsi]; cmp rcx, -1; je negation; cqo; idiv rcx; jmp end
+			static const uint8_t divide[] = {
+				0x48, 0x8B, 0x06, 0x48, 0x83, 0xF9, 0xFF, 0x74, 0x07,
+				0x48, 0x99, 0x48, 0xF7, 0xF9, 0xEB, 0x09
+			};
+			// negation: neg rax (a division by -1 would trap with the minimum)
+			static const uint8_t negate[] = { 0x48, 0xF7, 0xD8 };
+			_emit(machineCode, pop, sizeof(pop));
+			_emit(machineCode, testDivisor, sizeof(testDivisor));
+			_emitJump(machineCode, 0x84, machineCode->divisionByZeroHandler);
+			_emit(machineCode, divide, sizeof(divide));
+			_emit(machineCode, negate, sizeof(negate));
+			_emitJump(machineCode, 0x80, machineCode->overflowHandler);
+			--*depth;
+			break;
+		}
+		case MULTIPLY_INTEGERS: {
+			// imul rax, [rsi]
+			static const uint8_t multiply[] = { 0x48, 0x0F, 0xAF, 0x06 };
+			_emit(machineCode, pop, sizeof(pop));
+			_emit(machineCode, multiply, sizeof(multiply));
+			_emitJump(machineCode, 0x80, machineCode->overflowHandler);
+			--*depth;
+			break;
+		}
+		case PUSH_INTEGER: {
+			// mov [rsi], rax; add rsi, 8
+			static const uint8_t spill[] = { 0x48, 0x89, 0x06, 0x48, 0x83, 0xC6, 0x08 };
+			// movabs rax, imm64
+			uint8_t load[10] = { 0x48, 0xB8 };
+			if (0 < *depth) {
+				_emit(machineCode, spill, sizeof(spill));
+			}
+			memcpy(load + 2, &instruction->operand.small, sizeof(int64_t));
+			_emit(machineCode, load, sizeof(load));
+			++*depth;
+			break;
+		}
+		case PUSH_VARIABLE:
+			// Never compiled (the variables are not bound).
+			break;
+		case SUBTRACT_INTEGERS: {
+			// mov rcx, rax; mov rax, [rsi]; sub rax, rcx
+			static const uint8_t subtract[] = { 0x48, 0x89, 0xC1, 0x48, 0x8B, 0x06, 0x48, 0x29, 0xC8 };
+			_emit(machineCode, pop, sizeof(pop));
+			_emit(machineCode, subtract, sizeof(subtract));
+			_emitJump(machineCode, 0x80, machineCode->overflowHandler);
+			--*depth;
+			break;
+		}
+	}
+}
+
+/**
+ * Emits a conditional jump (0x80 for JO, 0x84 for JZ) with a 32-bit
+ * displacement to the specified offset.
+ */
+static void _emitJump(MachineCode * machineCode, const uint8_t condition, const size_t target) {
+	uint8_t jump[6] = { 0x0F, condition };
+	const int32_t displacement = (int32_t) ((int64_t) target - (int64_t) (machineCode->length + sizeof(jump)));
+	memcpy(jump + 2, &displacement, sizeof(int32_t));
+	_emit(machineCode, jump, sizeof(jump));
+}
+
+#endif
+
+/** PUBLIC FUNCTIONS */
+
+NativeCode * compileNativeCode(const Bytecode * bytecode) {
+#ifdef NATIVE_CODE
+	for (size_t k = 0; k < bytecode->length; ++k) {
+		if (bytecode->instructions[k].opcode == PUSH_INTEGER && bytecode->instructions[k].operand.big != NULL) {
+			logDebugging(_logger, "The bytecode has a constant bigger than 64 bits, so it cannot be compiled.");
+			return NULL;
+		}
+		if (bytecode->instructions[k].opcode == PUSH_VARIABLE) {
+			logDebugging(_logger, "The bytecode has unbound variables, so it cannot be compiled.");
+			return NULL;
+		}
+	}
+	const size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+	const size_t size = (NATIVE_CODE_FIXED_SIZE + bytecode->length * NATIVE_CODE_INSTRUCTION_SIZE + pageSize - 1) / pageSize * pageSize;
+	void * memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (memory == MAP_FAILED) {
+		logWarning(_logger, "There is no memory left for the machine code.");
+		return NULL;
+	}
+	MachineCode machineCode = {
+		.bytes = memory,
+		.divisionByZeroHandler = 0,
+		.length = 0,
+		.overflowHandler = 0
+	};
+
+	// The handlers: "mov eax, 1; ret" on overflow, and "mov rax, [rsi];
+	// mov [rdi], rax; mov eax, 2; ret" on a division by zero (which returns
+	// the dividend, to report it).
+	static const uint8_t overflowHandler[] = { 0xB8, NATIVE_OVERFLOW, 0x00, 0x00, 0x00, 0xC3 };
+	static const uint8_t divisionByZeroHandler[] = {
+		0x48, 0x8B, 0x06, 0x48, 0x89, 0x07, 0xB8, NATIVE_DIVISION_BY_ZERO, 0x00, 0x00, 0x00, 0xC3
+	};
+	machineCode.overflowHandler = machineCode.length;
+	_emit(&machineCode, overflowHandler, sizeof(overflowHandler));
+	machineCode.divisionByZeroHandler = machineCode.length;
+	_emit(&machineCode, divisionByZeroHandler, sizeof(divisionByZeroHandler));
+
+	// The prologue ("mov rsi, rdi"), every instruction, and the epilogue
+	// ("mov [rdi], rax; xor eax, eax; ret").
+	static const uint8_t prologue[] = { 0x48, 0x89, 0xFE };
+	static const uint8_t epilogue[] = { 0x48, 0x89, 0x07, 0x31, 0xC0, 0xC3 };
+	const size_t entryPoint = machineCode.length;
+	size_t depth = 0;
+	_emit(&machineCode, prologue, sizeof(prologue));
+	for (size_t k = 0; k < bytecode->length; ++k) {
+		_emitInstruction(&machineCode, &bytecode->instructions[k], &depth);
+	}
+	_emit(&machineCode, epilogue, sizeof(epilogue));
+
+	// The memory is never writable and executable at the same time.
+	if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+		logWarning(_logger, "The machine code cannot be made executable.");
+		munmap(memory, size);
+		return NULL;
+	}
+	NativeCode * nativeCode = allocateZeroedMemory(1, sizeof(NativeCode));
+	nativeCode->bytecode = bytecode;
+	nativeCode->function = (NativeFunction) ((uint8_t *) memory + entryPoint);
+	nativeCode->memory = memory;
+	nativeCode->size = size;
+	logDebugging(_logger, "Compilation into machine code is done (%zu bytes).", machineCode.length);
+	return nativeCode;
+#else
+	logDebugging(_logger, "The host doesn't support machine code.");
+	return NULL;
+#endif
+}
+
+void destroyNativeCode(NativeCode * nativeCode) {
+	if (nativeCode != NULL) {
+#ifdef NATIVE_CODE
+		munmap(nativeCode->memory, nativeCode->size);
+#endif
+		releaseMemory(nativeCode);
+	}
+}
+
+ComputationResult executeNativeCode(Arena * arena, const NativeCode * nativeCode) {
+	ComputationResult computationResult = {
+		.succeed = false,
+		.value = {
+			.big = NULL,
+			.small = 0
+		}
+	};
+	int64_t localValues[NATIVE_CODE_LOCAL_DEPTH];
+	const size_t depth = 1 + nativeCode->bytecode->stackDepth;
+	int64_t * values = depth <= NATIVE_CODE_LOCAL_DEPTH ? localValues : allocateMemory(depth * sizeof(int64_t));
+	if (values == NULL) {
+		logError(_logger, "The native code ran out of memory.");
+		return computationResult;
+	}
+	const NativeStatus status = (NativeStatus) nativeCode->function(values);
+	const Integer value = {
+		.big = NULL,
+		.small = values[0]
+	};
+	if (values != localValues) {
+		releaseMemory(values);
+	}
+	switch (status) {
+		case NATIVE_SUCCEED:
+			computationResult.succeed = true;
+			computationResult.value = value;
+			return computationResult;
+		case NATIVE_DIVISION_BY_ZERO:
+			return divide(arena, value, computationResult.value);
+		case NATIVE_OVERFLOW:
+		default:
+			logDebugging(_logger, "The native code overflows, so the program is executed by the virtual-machine.");
+			return executeBytecode(arena, nativeCode->bytecode);
+	}
+}
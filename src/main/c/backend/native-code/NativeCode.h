@@ -0,0 +1,68 @@
+#ifndef NATIVE_CODE_HEADER
+#define NATIVE_CODE_HEADER
+
+#include "../../shared/Integer.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Memory.h"
+#include "../../shared/Type.h"
+#include "../domain-specific/Calculator.h"
+#include "../virtual-machine/Bytecode.h"
+#include "../virtual-machine/VirtualMachine.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeNativeCodeModule();
+
+/** Shutdown module's internal state. */
+void shutdownNativeCodeModule();
+
+/**
+ * The signature of a program translated into machine code. It receives a
+ * value stack (with room for the depth of the bytecode, plus one), leaves its
+ * result in the first slot, and returns a status.
+ */
+typedef int (*NativeFunction)(int64_t * values);
+
+/**
+ * A program translated into x86-64 machine code, inside pages of its own that
+ * are executable but not writable.
+ */
+typedef struct {
+	// The bytecode it was translated from, which executes the program if the
+	// machine integers overflow (so it must outlive the native code).
+	const Bytecode * bytecode;
+
+	// The entry-point of the program.
+	NativeFunction function;
+
+	// The executable memory, and its size.
+	void * memory;
+	size_t size;
+} NativeCode;
+
+/**
+ * Translates a bytecode into machine code. Returns NULL if the host is not
+ * supported (i.e., it's not x86-64 with the System V ABI), if a constant
+ * doesn't fit in 64 bits, if it has variables (which are not bound), or if
+ * executable memory cannot be reserved. In that
+ * case, the bytecode must be executed by the virtual-machine instead.
+ */
+NativeCode * compileNativeCode(const Bytecode * bytecode);
+
+/**
+ * Destroy a native code and its executable memory.
+ */
+void destroyNativeCode(NativeCode * nativeCode);
+
+/**
+ * Executes a native code, and returns its value. As the virtual-machine,
+ * errors (i.e., a division by zero) are reported as in "divide". If an
+ * operation overflows 64 bits, the program is executed again by the
+ * virtual-machine, which promotes the values to arbitrary-precision inside
+ * the arena.
+ */
+ComputationResult executeNativeCode(Arena * arena, const NativeCode * nativeCode);
+
+#endif
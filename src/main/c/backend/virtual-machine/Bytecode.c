@@ -0,0 +1,193 @@
+#include "Bytecode.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeBytecodeModule() {
+	_logger = createLogger("Bytecode");
+}
+
+void shutdownBytecodeModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * A pending step of the lowering of an expression.
+ */
+typedef enum {
+	EMIT_OPERATOR,
+	LOWER_EXPRESSION
+} LoweringStepType;
+
+typedef struct {
+	Expression * expression;
+	LoweringStepType type;
+} LoweringStep;
+
+static boolean _emit(Bytecode * bytecode, const Opcode opcode, const Integer operand);
+static Opcode _expressionTypeToOpcode(const ExpressionType type);
+static boolean _lowerExpression(Bytecode * bytecode, Expression * expression);
+static boolean _pushStep(Stack * steps, const LoweringStepType type, Expression * expression);
+static boolean _variableIndex(Bytecode * bytecode, const char * name, Integer * index);
+
+/**
+ * Appends an instruction at the end of the bytecode, and keeps track of the
+ * depth of the value stack. Returns false if the bytecode couldn't grow.
+ */
+static boolean _emit(Bytecode * bytecode, const Opcode opcode, const Integer operand) {
+	if (bytecode->length == bytecode->capacity) {
+		Instruction * instructions = reallocateMemory(bytecode->instructions, 2 * bytecode->capacity * sizeof(Instruction));
+		if (instructions == NULL) {
+			logError(_logger, "The lowering ran out of memory.");
+			return false;
+		}
+		bytecode->instructions = instructions;
+		bytecode->capacity *= 2;
+	}
+	Instruction * instruction = bytecode->instructions + bytecode->length++;
+	instruction->opcode = opcode;
+	instruction->operand = operand;
+	return true;
+}
+
+/**
+ * Converts and expression type to the opcode of its binary operation.
+ */
+static Opcode _expressionTypeToOpcode(const ExpressionType type) {
+	switch (type) {
+		case ADDITION: return ADD_INTEGERS;
+		case DIVISION: return DIVIDE_INTEGERS;
+		case MULTIPLICATION: return MULTIPLY_INTEGERS;
+		case SUBTRACTION:
+		default:
+			return SUBTRACT_INTEGERS;
+	}
+}
+
+/**
+ * Lowers an expression in post-order, using an explicit stack of pending
+ * steps (so the depth is only limited by the available memory).
+ */
+static boolean _lowerExpression(Bytecode * bytecode, Expression * expression) {
+	Stack * steps = createStack(sizeof(LoweringStep), 64);
+	size_t depth = 0;
+	boolean succeed = _pushStep(steps, LOWER_EXPRESSION, expression);
+	while (succeed && !isEmptyStack(steps)) {
+		LoweringStep step;
+		popStack(steps, &step);
+		switch (step.type) {
+			case EMIT_OPERATOR: {
+				const Integer unused = {
+					.big = NULL,
+					.small = 0
+				};
+				succeed = _emit(bytecode, _expressionTypeToOpcode(step.expression->type), unused);
+				--depth;
+				break;
+			}
+			case LOWER_EXPRESSION:
+				switch (step.expression->type) {
+					case ADDITION:
+					case DIVISION:
+					case MULTIPLICATION:
+					case SUBTRACTION:
+						succeed = _pushStep(steps, EMIT_OPERATOR, step.expression)
+							&& _pushStep(steps, LOWER_EXPRESSION, step.expression->rightExpression)
+							&& _pushStep(steps, LOWER_EXPRESSION, step.expression->leftExpression);
+						break;
+					case CONSTANT:
+						succeed = _emit(bytecode, PUSH_INTEGER, step.expression->value);
+						if (bytecode->stackDepth < ++depth) {
+							bytecode->stackDepth = depth;
+						}
+						break;
+					case VARIABLE: {
+						Integer index;
+						succeed = _variableIndex(bytecode, step.expression->name, &index)
+							&& _emit(bytecode, PUSH_VARIABLE, index);
+						if (bytecode->stackDepth < ++depth) {
+							bytecode->stackDepth = depth;
+						}
+						break;
+					}
+					default:
+						logError(_logger, "The specified expression type is unknown: %d", step.expression->type);
+						succeed = false;
+				}
+				break;
+		}
+	}
+	destroyStack(steps);
+	return succeed;
+}
+
+/**
+ * Pushes a new pending step over the specified expression. Returns false if
+ * the stack couldn't grow.
+ */
+static boolean _pushStep(Stack * steps, const LoweringStepType type, Expression * expression) {
+	LoweringStep step = {
+		.expression = expression,
+		.type = type
+	};
+	if (pushStack(steps, &step)) {
+		return true;
+	}
+	logError(_logger, "The lowering ran out of memory.");
+	return false;
+}
+
+/**
+ * Finds the index of a variable by name, and adds it to the bytecode if it's
+ * the first time it appears. Returns false if the bytecode couldn't grow.
+ */
+static boolean _variableIndex(Bytecode * bytecode, const char * name, Integer * index) {
+	index->big = NULL;
+	for (size_t k = 0; k < bytecode->variablesLength; ++k) {
+		if (strcmp(bytecode->variables[k], name) == 0) {
+			index->small = (int64_t) k;
+			return true;
+		}
+	}
+	const char ** variables = reallocateMemory(bytecode->variables, (1 + bytecode->variablesLength) * sizeof(const char *));
+	if (variables == NULL) {
+		logError(_logger, "The lowering ran out of memory.");
+		return false;
+	}
+	variables[bytecode->variablesLength] = name;
+	bytecode->variables = variables;
+	index->small = (int64_t) bytecode->variablesLength++;
+	return true;
+}
+
+/** PUBLIC FUNCTIONS */
+
+Bytecode * lowerProgram(Program * program) {
+	logDebugging(_logger, "Lowering program into bytecode...");
+	Bytecode * bytecode = allocateZeroedMemory(1, sizeof(Bytecode));
+	bytecode->capacity = 64;
+	bytecode->instructions = allocateMemory(bytecode->capacity * sizeof(Instruction));
+	if (bytecode->instructions == NULL || !_lowerExpression(bytecode, program->expression)) {
+		destroyBytecode(bytecode);
+		return NULL;
+	}
+	logDebugging(_logger, "Lowering is done (%zu instructions, stack depth of %zu, %zu variables).", bytecode->length, bytecode->stackDepth, bytecode->variablesLength);
+	return bytecode;
+}
+
+void destroyBytecode(Bytecode * bytecode) {
+	if (bytecode != NULL) {
+		if (bytecode->instructions != NULL) {
+			releaseMemory(bytecode->instructions);
+		}
+		if (bytecode->variables != NULL) {
+			releaseMemory(bytecode->variables);
+		}
+		releaseMemory(bytecode);
+	}
+}
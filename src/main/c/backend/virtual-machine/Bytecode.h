@@ -0,0 +1,68 @@
+#ifndef BYTECODE_HEADER
+#define BYTECODE_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Integer.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Memory.h"
+#include "../../shared/Stack.h"
+#include "../../shared/Type.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeBytecodeModule();
+
+/** Shutdown module's internal state. */
+void shutdownBytecodeModule();
+
+/**
+ * The operation codes of the virtual machine. Every operation pops its
+ * operands from the value stack, and pushes its result.
+ */
+typedef enum {
+	ADD_INTEGERS,
+	DIVIDE_INTEGERS,
+	MULTIPLY_INTEGERS,
+	PUSH_INTEGER,
+	PUSH_VARIABLE,
+	SUBTRACT_INTEGERS
+} Opcode;
+
+/**
+ * A single instruction. Only PUSH_INTEGER uses its operand (which, if it's
+ * big, lives in the arena of the program), and PUSH_VARIABLE, whose operand
+ * is the index of the variable in the bytecode.
+ */
+typedef struct {
+	Opcode opcode;
+	Integer operand;
+} Instruction;
+
+/**
+ * A program lowered into a contiguous array of instructions in postfix
+ * order, plus the depth of the value stack needed to execute it, and the
+ * distinct names of its variables (which live in the arena of the program),
+ * in order of appearance.
+ */
+typedef struct {
+	Instruction * instructions;
+	size_t capacity;
+	size_t length;
+	size_t stackDepth;
+	const char ** variables;
+	size_t variablesLength;
+} Bytecode;
+
+/**
+ * Lowers a program into bytecode. Returns NULL if the program contains an
+ * unknown node or if the system ran out of memory.
+ */
+Bytecode * lowerProgram(Program * program);
+
+/**
+ * Destroy a bytecode and its resources.
+ */
+void destroyBytecode(Bytecode * bytecode);
+
+#endif
@@ -0,0 +1,86 @@
+#include "VirtualMachine.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeVirtualMachineModule() {
+	_logger = createLogger("VirtualMachine");
+}
+
+void shutdownVirtualMachineModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PUBLIC FUNCTIONS */
+
+ComputationResult executeBytecode(Arena * arena, const Bytecode * bytecode) {
+	ComputationResult computationResult = {
+		.succeed = false,
+		.value = {
+			.big = NULL,
+			.small = 0
+		}
+	};
+	Integer * values = allocateMemory((1 + bytecode->stackDepth) * sizeof(Integer));
+	if (values == NULL) {
+		logError(_logger, "The virtual-machine ran out of memory.");
+		return computationResult;
+	}
+	boolean enoughMemory = true;
+	boolean failed = false;
+	size_t size = 0;
+	const Instruction * instruction = bytecode->instructions;
+	const Instruction * end = instruction + bytecode->length;
+	for (; instruction < end; ++instruction) {
+		switch (instruction->opcode) {
+			case ADD_INTEGERS:
+				--size;
+				enoughMemory &= addIntegers(arena, values[size - 1], values[size], &values[size - 1]);
+				break;
+			case DIVIDE_INTEGERS:
+				--size;
+				if (isZeroInteger(values[size])) {
+					// Only the first failure is reported, as the calculator does.
+					if (!failed) {
+						values[size - 1] = divide(arena, values[size - 1], values[size]).value;
+					}
+					failed = true;
+				}
+				else {
+					enoughMemory &= divideIntegers(arena, values[size - 1], values[size], &values[size - 1]);
+				}
+				break;
+			case MULTIPLY_INTEGERS:
+				--size;
+				enoughMemory &= multiplyIntegers(arena, values[size - 1], values[size], &values[size - 1]);
+				break;
+			case PUSH_INTEGER:
+				values[size++] = instruction->operand;
+				break;
+			case PUSH_VARIABLE:
+				// Only a columnar evaluation binds the variables.
+				if (!failed) {
+					logError(_logger, "The variable \"%s\" is not bound.", bytecode->variables[instruction->operand.small]);
+				}
+				values[size++] = instruction->operand;
+				failed = true;
+				break;
+			case SUBTRACT_INTEGERS:
+				--size;
+				enoughMemory &= subtractIntegers(arena, values[size - 1], values[size], &values[size - 1]);
+				break;
+		}
+	}
+	if (!enoughMemory) {
+		logError(_logger, "The virtual-machine ran out of memory.");
+	}
+	else if (!failed && size == 1) {
+		computationResult.succeed = true;
+		computationResult.value = values[0];
+	}
+	releaseMemory(values);
+	return computationResult;
+}
@@ -0,0 +1,26 @@
+#ifndef VIRTUAL_MACHINE_HEADER
+#define VIRTUAL_MACHINE_HEADER
+
+#include "../../shared/Logger.h"
+#include "../../shared/Memory.h"
+#include "../../shared/Type.h"
+#include "../domain-specific/Calculator.h"
+#include "Bytecode.h"
+#include <stdlib.h>
+
+/** Initialize module's internal state. */
+void initializeVirtualMachineModule();
+
+/** Shutdown module's internal state. */
+void shutdownVirtualMachineModule();
+
+/**
+ * Executes a bytecode over a value stack, and returns the value left on top
+ * of it. The values that overflow 64 bits are promoted to arbitrary-precision
+ * inside the arena. Errors (i.e., a division by zero) are reported as in
+ * "divide", and they raise a sticky flag instead of stopping the execution,
+ * so the loop doesn't need to branch after every instruction.
+ */
+ComputationResult executeBytecode(Arena * arena, const Bytecode * bytecode);
+
+#endif
@@ -0,0 +1,473 @@
+#include "Batch.h"
+
+/* MODULE INTERNAL STATE */
+
+static boolean _flushEveryLine = false;
+static Logger * _logger = NULL;
+
+void initializeBatchModule() {
+	_flushEveryLine = getBooleanOrDefault("FLUSH_EVERY_LINE", false);
+	_logger = createLogger("Batch");
+}
+
+void shutdownBatchModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/**
+ * A growable buffer, reused by a worker to hold the source of every program
+ * it compiles.
+ */
+typedef struct {
+	char * bytes;
+	size_t capacity;
+	size_t length;
+} SourceBuffer;
+
+/**
+ * The result of a single program, kept until every previous program is
+ * reported. The value is kept in decimal, because the arena that holds it
+ * (if it's big) is reset before the report.
+ */
+typedef struct {
+	CompilationStatus status;
+	char * value;
+	boolean done;
+} BatchResult;
+
+/**
+ * The state shared by the workers of a batch. Everything but the
+ * configuration is protected by the mutex.
+ */
+typedef struct {
+	const BatchConfiguration * batchConfiguration;
+	pthread_mutex_t mutex;
+
+	// The amount of programs taken so far by the workers, and if there are no
+	// more programs to take.
+	unsigned int takenPrograms;
+	boolean exhausted;
+
+	// The results by program, and the next one to report.
+	BatchResult * results;
+	unsigned int resultsCapacity;
+	unsigned int nextResult;
+	Writer * writer;
+
+	// Totals of the entire batch.
+	size_t bytes;
+	CompilationStatus status;
+} Batch;
+
+/* PRIVATE FUNCTIONS */
+
+static const char * _baseName(const char * path);
+static int _compareBaseNames(const void * left, const void * right);
+static CompilationStatus _compileProgram(const BatchConfiguration * batchConfiguration, Arena * arena, Telemetry * telemetry, const char * name, SourceBuffer * source, char ** value);
+static void _completeProgram(Batch * batch, const unsigned int index, const CompilationStatus compilationStatus, char * value, const size_t bytes);
+static boolean _ensureCapacity(SourceBuffer * source, const size_t capacity);
+static boolean _hasDistinctOutputs(const BatchConfiguration * batchConfiguration);
+static char * _outputPath(const char * directory, const char * name);
+static const char * _programName(const Batch * batch, const unsigned int index, char * name, const size_t size);
+static boolean _readFile(const char * path, SourceBuffer * source);
+static boolean _readProgram(FILE * stream, const char delimiter, SourceBuffer * source);
+static void _report(Writer * writer, const char * name, const CompilationStatus compilationStatus, const char * value);
+static boolean _takeProgram(Batch * batch, SourceBuffer * source, unsigned int * index);
+static void * _work(void * argument);
+
+/**
+ * The last component of a path.
+ */
+static const char * _baseName(const char * path) {
+	const char * baseName = strrchr(path, '/');
+	return baseName == NULL ? path : baseName + 1;
+}
+
+/**
+ * Orders the paths of the programs by their last component.
+ */
+static int _compareBaseNames(const void * left, const void * right) {
+	return strcmp(_baseName(*(const char * const *) left), _baseName(*(const char * const *) right));
+}
+
+/**
+ * Compiles a single program of the batch over a clean arena (which is reset
+ * afterwards), with its own compiler state (so its frontend and backend state
+ * is not shared). The source is padded with two null bytes, so it's scanned
+ * in place. The value of a successful program is returned in decimal, in a
+ * new string.
+ */
+static CompilationStatus _compileProgram(const BatchConfiguration * batchConfiguration, Arena * arena, Telemetry * telemetry, const char * name, SourceBuffer * source, char ** value) {
+	logDebugging(_logger, "Compiling \"%s\" (%zu bytes)...", name, source->length);
+	const boolean scanInPlace = _ensureCapacity(source, source->length + 2);
+	if (scanInPlace) {
+		source->bytes[source->length] = '\0';
+		source->bytes[source->length + 1] = '\0';
+	}
+	CompilerState compilerState = {
+		.abstractSyntaxtTree = NULL,
+		.arena = arena,
+		.computed = false,
+		.input = NULL,
+		.mode = batchConfiguration->mode,
+		.nodeTable = NULL,
+		.output = NULL,
+		.scanInPlace = scanInPlace,
+		.scanner = NULL,
+		.source = source->bytes,
+		.sourceLength = source->length,
+		.spilledTree = NULL,
+		.succeed = false,
+		.telemetry = telemetry,
+		.tokenRing = NULL,
+		.value = {
+			.big = NULL,
+			.small = 0
+		}
+	};
+	CompilationStatus compilationStatus = FAILED;
+	char * outputPath = NULL;
+	if (batchConfiguration->outputDirectory != NULL && batchConfiguration->mode != EVALUATION_MODE) {
+		outputPath = _outputPath(batchConfiguration->outputDirectory, name);
+		compilerState.output = fopen(outputPath, "w");
+		if (compilerState.output == NULL) {
+			logError(_logger, "The output \"%s\" cannot be opened: %s.", outputPath, strerror(errno));
+		}
+	}
+	if (outputPath == NULL || compilerState.output != NULL) {
+		compilationStatus = compile(&compilerState);
+	}
+	if (compilerState.output != NULL && fclose(compilerState.output) != 0) {
+		logError(_logger, "The output \"%s\" cannot be closed: %s.", outputPath, strerror(errno));
+		compilationStatus = FAILED;
+	}
+	releaseMemory(outputPath);
+	if (compilationStatus == SUCCEED) {
+		*value = integerToString(compilerState.value);
+		if (*value == NULL) {
+			logError(_logger, "There is no memory left for the value of \"%s\".", name);
+			compilationStatus = FAILED;
+		}
+	}
+	const double start = telemetry == NULL ? 0 : telemetrySeconds();
+	setMemoryPhase(RELEASE_PHASE);
+	resetArena(arena);
+	setMemoryPhase(DRIVER_PHASE);
+	if (telemetry != NULL) {
+		telemetry->releaseSeconds += telemetrySeconds() - start;
+	}
+	return compilationStatus;
+}
+
+/**
+ * Stores the result of a program, and reports every result that is ready in
+ * order (i.e., those not waiting for a previous program), releasing their
+ * values. The caller must hold the mutex.
+ */
+static void _completeProgram(Batch * batch, const unsigned int index, const CompilationStatus compilationStatus, char * value, const size_t bytes) {
+	BatchResult * result = &batch->results[index];
+	result->status = compilationStatus;
+	result->value = value;
+	result->done = true;
+	batch->bytes += bytes;
+	if (compilationStatus != SUCCEED) {
+		batch->status = FAILED;
+	}
+	char name[16];
+	while (batch->nextResult < batch->takenPrograms && batch->results[batch->nextResult].done) {
+		result = &batch->results[batch->nextResult];
+		_report(batch->writer, _programName(batch, batch->nextResult, name, sizeof(name)), result->status, result->value);
+		releaseMemory(result->value);
+		result->value = NULL;
+		++batch->nextResult;
+	}
+}
+
+/**
+ * Grows the buffer to hold, at least, the specified amount of bytes. Returns
+ * false if there is no memory left.
+ */
+static boolean _ensureCapacity(SourceBuffer * source, const size_t capacity) {
+	if (capacity <= source->capacity) {
+		return true;
+	}
+	size_t newCapacity = source->capacity == 0 ? 4096 : source->capacity;
+	while (newCapacity < capacity) {
+		newCapacity *= 2;
+	}
+	char * bytes = reallocateMemory(source->bytes, newCapacity);
+	if (bytes == NULL) {
+		return false;
+	}
+	source->bytes = bytes;
+	source->capacity = newCapacity;
+	return true;
+}
+
+/**
+ * Verifies that no two programs have the same final output (i.e., the same
+ * last component in their paths), since their workers would write the same
+ * file at once. Returns false (and logs both paths) otherwise.
+ */
+static boolean _hasDistinctOutputs(const BatchConfiguration * batchConfiguration) {
+	const unsigned int pathsCount = batchConfiguration->pathsCount;
+	if (batchConfiguration->outputDirectory == NULL || batchConfiguration->mode == EVALUATION_MODE || pathsCount < 2) {
+		return true;
+	}
+	const char ** paths = allocateMemory(pathsCount * sizeof(const char *));
+	if (paths == NULL) {
+		logError(_logger, "There is no memory left to verify the outputs.");
+		return false;
+	}
+	memcpy(paths, batchConfiguration->paths, pathsCount * sizeof(const char *));
+	qsort(paths, pathsCount, sizeof(const char *), _compareBaseNames);
+	boolean distinct = true;
+	for (unsigned int k = 1; distinct && k < pathsCount; ++k) {
+		if (_compareBaseNames(&paths[k - 1], &paths[k]) == 0) {
+			logError(_logger, "The programs \"%s\" and \"%s\" would have the same output (\"%s.tex\").", paths[k - 1], paths[k], _baseName(paths[k]));
+			distinct = false;
+		}
+	}
+	releaseMemory(paths);
+	return distinct;
+}
+
+/**
+ * Builds the path of the final output of a program, inside the directory and
+ * named after the last component of the name of the program.
+ */
+static char * _outputPath(const char * directory, const char * name) {
+	return concatenate(4, directory, "/", _baseName(name), ".tex");
+}
+
+/**
+ * The name of a program: its path, or its position inside the stream (which
+ * is written in the provided buffer).
+ */
+static const char * _programName(const Batch * batch, const unsigned int index, char * name, const size_t size) {
+	if (0 < batch->batchConfiguration->pathsCount) {
+		return batch->batchConfiguration->paths[index];
+	}
+	snprintf(name, size, "%u", index + 1);
+	return name;
+}
+
+/**
+ * Reads the entire file into the buffer. Returns false if the file cannot be
+ * read.
+ */
+static boolean _readFile(const char * path, SourceBuffer * source) {
+	FILE * file = fopen(path, "rb");
+	if (file == NULL) {
+		logError(_logger, "The program \"%s\" cannot be opened: %s.", path, strerror(errno));
+		return false;
+	}
+	source->length = 0;
+	boolean succeed = true;
+	while (succeed) {
+		if (!_ensureCapacity(source, source->length + 4096)) {
+			logError(_logger, "There is no memory left to read the program \"%s\".", path);
+			succeed = false;
+			break;
+		}
+		const size_t length = fread(source->bytes + source->length, 1, source->capacity - source->length, file);
+		source->length += length;
+		if (length == 0) {
+			break;
+		}
+	}
+	if (ferror(file)) {
+		logError(_logger, "The program \"%s\" cannot be read.", path);
+		succeed = false;
+	}
+	fclose(file);
+	return succeed;
+}
+
+/**
+ * Reads the next program of the stream into the buffer, up to the delimiter
+ * (which is discarded) or the end of the stream. Returns false if there are
+ * no more programs.
+ */
+static boolean _readProgram(FILE * stream, const char delimiter, SourceBuffer * source) {
+	source->length = 0;
+	int character = getc(stream);
+	if (character == EOF) {
+		return false;
+	}
+	while (character != EOF && character != (unsigned char) delimiter) {
+		if (!_ensureCapacity(source, source->length + 1)) {
+			logError(_logger, "There is no memory left to read the next program.");
+			return false;
+		}
+		source->bytes[source->length++] = (char) character;
+		character = getc(stream);
+	}
+	// An empty program still needs a buffer, or it would be read from stdin.
+	return _ensureCapacity(source, 1);
+}
+
+/**
+ * Prints the line with the result of a single program.
+ */
+static void _report(Writer * writer, const char * name, const CompilationStatus compilationStatus, const char * value) {
+	writeString(writer, name);
+	writeCharacter(writer, '\t');
+	writeInteger(writer, compilationStatus);
+	if (compilationStatus == SUCCEED) {
+		writeCharacter(writer, '\t');
+		writeString(writer, value);
+	}
+	writeCharacter(writer, '\n');
+}
+
+/**
+ * Assigns the next program of the batch to a worker. Programs from the stream
+ * are read here, so they are split in order. The caller must hold the mutex.
+ * Returns false if there are no more programs.
+ */
+static boolean _takeProgram(Batch * batch, SourceBuffer * source, unsigned int * index) {
+	const BatchConfiguration * batchConfiguration = batch->batchConfiguration;
+	if (batch->exhausted) {
+		return false;
+	}
+	if (0 < batchConfiguration->pathsCount) {
+		batch->exhausted = batch->takenPrograms + 1 == batchConfiguration->pathsCount;
+	}
+	else if (!_readProgram(stdin, batchConfiguration->delimiter, source)) {
+		batch->exhausted = true;
+		return false;
+	}
+	if (batch->takenPrograms == batch->resultsCapacity) {
+		const unsigned int capacity = batch->resultsCapacity == 0 ? 1024 : 2 * batch->resultsCapacity;
+		BatchResult * results = reallocateMemory(batch->results, capacity * sizeof(BatchResult));
+		if (results == NULL) {
+			logError(_logger, "There is no memory left to hold the results of the batch.");
+			batch->exhausted = true;
+			batch->status = FAILED;
+			return false;
+		}
+		memset(results + batch->resultsCapacity, 0, (capacity - batch->resultsCapacity) * sizeof(BatchResult));
+		batch->results = results;
+		batch->resultsCapacity = capacity;
+	}
+	*index = batch->takenPrograms++;
+	return true;
+}
+
+/**
+ * The loop of a worker: takes the next program, compiles it, and stores its
+ * result, until there are no more programs.
+ */
+static void * _work(void * argument) {
+	Batch * batch = argument;
+	const BatchConfiguration * batchConfiguration = batch->batchConfiguration;
+	Arena * arena = createArena(ARENA_DEFAULT_BLOCK_SIZE);
+	Telemetry * telemetry = batchConfiguration->telemetry == NULL ? NULL : createTelemetry();
+	SourceBuffer source = {
+		.bytes = NULL,
+		.capacity = 0,
+		.length = 0
+	};
+	while (true) {
+		unsigned int index = 0;
+		pthread_mutex_lock(&batch->mutex);
+		const boolean taken = _takeProgram(batch, &source, &index);
+		pthread_mutex_unlock(&batch->mutex);
+		if (!taken) {
+			break;
+		}
+		CompilationStatus compilationStatus = FAILED;
+		char * value = NULL;
+		char name[16];
+		const char * programName = _programName(batch, index, name, sizeof(name));
+		if (0 < batchConfiguration->pathsCount) {
+			source.length = 0;
+			if (_readFile(programName, &source)) {
+				compilationStatus = _compileProgram(batchConfiguration, arena, telemetry, programName, &source, &value);
+			}
+		}
+		else {
+			compilationStatus = _compileProgram(batchConfiguration, arena, telemetry, programName, &source, &value);
+		}
+		pthread_mutex_lock(&batch->mutex);
+		_completeProgram(batch, index, compilationStatus, value, source.length);
+		pthread_mutex_unlock(&batch->mutex);
+	}
+	if (telemetry != NULL) {
+		pthread_mutex_lock(&batch->mutex);
+		mergeTelemetry(batchConfiguration->telemetry, telemetry);
+		pthread_mutex_unlock(&batch->mutex);
+		destroyTelemetry(telemetry);
+	}
+	releaseMemory(source.bytes);
+	destroyArena(arena);
+	return NULL;
+}
+
+/* PUBLIC FUNCTIONS */
+
+CompilationStatus compileBatch(const BatchConfiguration * batchConfiguration) {
+	if (!_hasDistinctOutputs(batchConfiguration)) {
+		return FAILED;
+	}
+	unsigned int jobs = batchConfiguration->jobs;
+	if (jobs == 0) {
+		const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		jobs = cores < 1 ? 1 : (unsigned int) cores;
+	}
+	if (0 < batchConfiguration->pathsCount && batchConfiguration->pathsCount < jobs) {
+		jobs = batchConfiguration->pathsCount;
+	}
+	Batch batch = {
+		.batchConfiguration = batchConfiguration,
+		.bytes = 0,
+		.exhausted = false,
+		.nextResult = 0,
+		.results = NULL,
+		.resultsCapacity = 0,
+		.status = SUCCEED,
+		.takenPrograms = 0,
+		.writer = createWriter(stdout, WRITER_DEFAULT_CAPACITY, _flushEveryLine)
+	};
+	pthread_mutex_init(&batch.mutex, NULL);
+	logDebugging(_logger, "Compiling a batch with %u workers...", jobs);
+	const double start = telemetrySeconds();
+
+	// The calling thread is one of the workers.
+	pthread_t * threads = allocateZeroedMemory(jobs, sizeof(pthread_t));
+	unsigned int startedThreads = 0;
+	for (unsigned int k = 1; k < jobs; ++k) {
+		if (pthread_create(&threads[startedThreads], NULL, _work, &batch) == 0) {
+			++startedThreads;
+		}
+		else {
+			logWarning(_logger, "Only %u of %u workers could be started.", 1 + startedThreads, jobs);
+			break;
+		}
+	}
+	_work(&batch);
+	for (unsigned int k = 0; k < startedThreads; ++k) {
+		pthread_join(threads[k], NULL);
+	}
+	const double seconds = telemetrySeconds() - start;
+
+	CompilationStatus batchStatus = batch.status;
+	if (!destroyWriter(batch.writer)) {
+		logError(_logger, "The results could not be written completely.");
+		batchStatus = FAILED;
+	}
+	fprintf(stderr, "Compiled %u programs (%.3f MB) in %.3f seconds with %u workers: %.1f files/s, %.3f MB/s.\n",
+		batch.takenPrograms,
+		batch.bytes / 1e6,
+		seconds,
+		1 + startedThreads,
+		batch.takenPrograms / seconds,
+		batch.bytes / 1e6 / seconds);
+	releaseMemory(threads);
+	releaseMemory(batch.results);
+	pthread_mutex_destroy(&batch.mutex);
+	return batchStatus;
+}
@@ -0,0 +1,65 @@
+#ifndef BATCH_HEADER
+#define BATCH_HEADER
+
+#include "../shared/Arena.h"
+#include "../shared/CompilerState.h"
+#include "../shared/Environment.h"
+#include "../shared/Logger.h"
+#include "../shared/Memory.h"
+#include "../shared/String.h"
+#include "../shared/Telemetry.h"
+#include "../shared/Writer.h"
+#include "Compilation.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/** Initialize module's internal state. */
+void initializeBatchModule();
+
+/** Shutdown module's internal state. */
+void shutdownBatchModule();
+
+/**
+ * What a batch must compile, and how.
+ */
+typedef struct {
+	// What every compilation must produce.
+	CompilationMode mode;
+
+	// The paths of the programs to compile. If there are none, the programs
+	// are read from the standard input, separated by the delimiter.
+	const char ** paths;
+	unsigned int pathsCount;
+	char delimiter;
+
+	// The directory where the final output of each program is generated, in a
+	// file named after the program (with a ".tex" extension), so the programs
+	// must have distinct names. If NULL, the final output is not generated at
+	// all.
+	const char * outputDirectory;
+
+	// The amount of worker threads that compile the programs concurrently (0
+	// to use one per online core).
+	unsigned int jobs;
+
+	// The measurements of the entire batch, added up from every worker (if
+	// NULL, nothing is measured).
+	Telemetry * telemetry;
+} BatchConfiguration;
+
+/**
+ * Compiles many programs in the same process, spread over a pool of worker
+ * threads that reuse the modules, and each one its own arena. For every
+ * program, prints one line to the standard output with its name (the path, or
+ * the position inside the stream starting at 1), its status and, if it
+ * succeed, its value, separated by tabs. The lines follow the order of the
+ * programs, whatever the order in which they finish. At the end, reports the
+ * throughput in the standard error. Fails if any of the programs fails.
+ */
+CompilationStatus compileBatch(const BatchConfiguration * batchConfiguration);
+
+#endif
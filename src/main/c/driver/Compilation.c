@@ -0,0 +1,276 @@
+#include "Compilation.h"
+
+/* MODULE INTERNAL STATE */
+
+static boolean _nativeEvaluator = false;
+static boolean _treeEvaluator = false;
+static Logger * _logger = NULL;
+
+void initializeCompilationModule() {
+	_logger = createLogger("Compilation");
+	const char * evaluator = getStringOrDefault("EVALUATOR", "bytecode");
+	_nativeEvaluator = strcmp(evaluator, "native") == 0;
+	_treeEvaluator = strcmp(evaluator, "tree") == 0;
+	if (!_nativeEvaluator && !_treeEvaluator && strcmp(evaluator, "bytecode") != 0) {
+		logWarning(_logger, "Unknown evaluator \"%s\", using \"bytecode\" instead.", evaluator);
+	}
+}
+
+void shutdownCompilationModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+/**
+ * A pending node of the AST while it's measured, with its depth.
+ */
+typedef struct {
+	Expression * expression;
+	size_t depth;
+} MeasuredExpression;
+
+static CompilationStatus _computeAndGenerate(CompilerState * compilerState, double start);
+static ComputationResult _computeProgram(Arena * arena, Program * program);
+static double _lap(double * start);
+static void _measureProgram(Program * program, Telemetry * telemetry);
+static CompilationStatus _streamProgram(CompilerState * compilerState);
+
+/**
+ * The backend: computes the value of the AST of the compiler state and,
+ * unless in evaluation mode, generates the final output (if the state has an
+ * output stream). The phases are measured since the specified start.
+ */
+static CompilationStatus _computeAndGenerate(CompilerState * compilerState, double start) {
+	Telemetry * telemetry = compilerState->telemetry;
+	logDebugging(_logger, "Computing expression value...");
+	setMemoryPhase(COMPUTATION_PHASE);
+	ComputationResult computationResult = _computeProgram(compilerState->arena, compilerState->abstractSyntaxtTree);
+	setMemoryPhase(DRIVER_PHASE);
+	if (telemetry != NULL) {
+		telemetry->computationSeconds += _lap(&start);
+	}
+	if (!computationResult.succeed) {
+		logError(_logger, "The computation phase rejects the input program.");
+		return FAILED;
+	}
+	compilerState->computed = true;
+	compilerState->value = computationResult.value;
+	if (compilerState->output != NULL && compilerState->mode != EVALUATION_MODE) {
+		setMemoryPhase(GENERATION_PHASE);
+		const boolean generated = generate(compilerState);
+		setMemoryPhase(DRIVER_PHASE);
+		if (telemetry != NULL) {
+			telemetry->generationSeconds += _lap(&start);
+		}
+		if (!generated) {
+			logError(_logger, "The generation phase cannot output the program.");
+			return FAILED;
+		}
+	}
+	return SUCCEED;
+}
+
+/**
+ * Computes the value of the program with the evaluator selected by the
+ * "EVALUATOR" variable: the bytecode virtual-machine ("bytecode", by
+ * default), the bytecode translated into machine code ("native", which falls
+ * back to the virtual-machine if the host is not supported), or the
+ * tree-walking calculator ("tree"). The big values are allocated in the
+ * arena.
+ */
+static ComputationResult _computeProgram(Arena * arena, Program * program) {
+	if (_treeEvaluator) {
+		return computeExpression(arena, program->expression);
+	}
+	ComputationResult computationResult = {
+		.succeed = false,
+		.value = {
+			.big = NULL,
+			.small = 0
+		}
+	};
+	Bytecode * bytecode = lowerProgram(program);
+	NativeCode * nativeCode = _nativeEvaluator && bytecode != NULL ? compileNativeCode(bytecode) : NULL;
+	if (nativeCode != NULL) {
+		computationResult = executeNativeCode(arena, nativeCode);
+		destroyNativeCode(nativeCode);
+	}
+	else if (bytecode != NULL) {
+		computationResult = executeBytecode(arena, bytecode);
+	}
+	destroyBytecode(bytecode);
+	return computationResult;
+}
+
+/**
+ * Returns the seconds elapsed since the start of a lap, and starts the next
+ * one.
+ */
+static double _lap(double * start) {
+	const double end = telemetrySeconds();
+	const double seconds = end - *start;
+	*start = end;
+	return seconds;
+}
+
+/**
+ * Counts the nodes of the AST by type, and measures its depth, with an
+ * explicit stack (so it's only bounded by the available memory).
+ */
+static void _measureProgram(Program * program, Telemetry * telemetry) {
+	telemetry->nodes.programs += 1;
+	size_t maximumDepth = 1;
+	Stack * stack = createStack(sizeof(MeasuredExpression), 64);
+	MeasuredExpression measuredExpression = {
+		.depth = 2,
+		.expression = program->expression
+	};
+	boolean succeed = pushStack(stack, &measuredExpression);
+	while (succeed && !isEmptyStack(stack)) {
+		popStack(stack, &measuredExpression);
+		const Expression * expression = measuredExpression.expression;
+		const size_t depth = measuredExpression.depth;
+		telemetry->nodes.expressions += 1;
+		telemetry->nodes.parentheses += expression->parentheses;
+		if (expression->type == CONSTANT || expression->type == VARIABLE) {
+			telemetry->nodes.constants += expression->type == CONSTANT;
+			telemetry->nodes.variables += expression->type == VARIABLE;
+			maximumDepth = maximumDepth < depth ? depth : maximumDepth;
+		}
+		else {
+			MeasuredExpression left = { .depth = depth + 1, .expression = expression->leftExpression };
+			MeasuredExpression right = { .depth = depth + 1, .expression = expression->rightExpression };
+			succeed = pushStack(stack, &left) && pushStack(stack, &right);
+		}
+	}
+	if (!succeed) {
+		logWarning(_logger, "The AST cannot be measured completely (out of memory).");
+	}
+	destroyStack(stack);
+	if (telemetry->maximumDepth < maximumDepth) {
+		telemetry->maximumDepth = maximumDepth;
+	}
+}
+
+/**
+ * Compiles a program in streaming mode: the value is computed while parsing,
+ * and the tree is spilled at the same time (instead of building the AST), so
+ * the final output is generated from the spilled tree afterwards.
+ */
+static CompilationStatus _streamProgram(CompilerState * compilerState) {
+	Telemetry * telemetry = compilerState->telemetry;
+	double start = telemetry == NULL ? 0 : telemetrySeconds();
+	SpilledTree * spilledTree = createSpilledTree();
+	if (spilledTree == NULL) {
+		logError(_logger, "The tree cannot be spilled (out of memory).");
+		return FAILED;
+	}
+	compilerState->spilledTree = spilledTree;
+	setMemoryPhase(PARSING_PHASE);
+	const SyntacticAnalysisStatus syntacticAnalysisStatus = parse(compilerState);
+	setMemoryPhase(DRIVER_PHASE);
+	if (telemetry != NULL) {
+		telemetry->parsingSeconds += _lap(&start);
+		telemetry->programs += 1;
+		telemetry->sourceBytes += compilerState->sourceLength;
+	}
+	CompilationStatus compilationStatus = FAILED;
+	if (syntacticAnalysisStatus != ACCEPT) {
+		logError(_logger, "The syntactic-analysis phase rejects the input program.");
+	}
+	else if (!compilerState->computed) {
+		logError(_logger, "The computation phase rejects the input program.");
+	}
+	else if (spilledTree->failed) {
+		logError(_logger, "The tree cannot be spilled completely.");
+	}
+	else {
+		setMemoryPhase(GENERATION_PHASE);
+		const boolean generated = generate(compilerState);
+		setMemoryPhase(DRIVER_PHASE);
+		if (telemetry != NULL) {
+			telemetry->generationSeconds += _lap(&start);
+		}
+		if (!generated) {
+			logError(_logger, "The generation phase cannot output the program.");
+		}
+		compilationStatus = generated && !spilledTree->failed ? SUCCEED : FAILED;
+	}
+	compilerState->spilledTree = NULL;
+	destroySpilledTree(spilledTree);
+	return compilationStatus;
+}
+
+/* PUBLIC FUNCTIONS */
+
+CompilationStatus compile(CompilerState * compilerState) {
+	if (compilerState->mode == STREAMING_MODE && compilerState->output != NULL && isGenerationEnabled()) {
+		return _streamProgram(compilerState);
+	}
+	Telemetry * telemetry = compilerState->telemetry;
+	double start = telemetry == NULL ? 0 : telemetrySeconds();
+	setMemoryPhase(PARSING_PHASE);
+	const SyntacticAnalysisStatus syntacticAnalysisStatus = parse(compilerState);
+	setMemoryPhase(DRIVER_PHASE);
+	if (telemetry != NULL) {
+		telemetry->parsingSeconds += _lap(&start);
+		telemetry->programs += 1;
+		telemetry->sourceBytes += compilerState->sourceLength;
+		if (syntacticAnalysisStatus == ACCEPT && compilerState->mode == GENERATION_MODE) {
+			_measureProgram(compilerState->abstractSyntaxtTree, telemetry);
+			start = telemetrySeconds();
+		}
+	}
+	if (syntacticAnalysisStatus != ACCEPT) {
+		logError(_logger, "The syntactic-analysis phase rejects the input program.");
+		return FAILED;
+	}
+	if (compilerState->mode != GENERATION_MODE) {
+		// The value was computed while parsing, so there is no backend (in
+		// streaming mode, only if there is no output to generate).
+		if (!compilerState->computed) {
+			logError(_logger, "The computation phase rejects the input program.");
+			return FAILED;
+		}
+		return SUCCEED;
+	}
+	// --------------------------------------------------------------------------------------------
+	// Beginning of the Backend... ----------------------------------------------------------------
+	const CompilationStatus compilationStatus = _computeAndGenerate(compilerState, start);
+	// ...end of the Backend. ---------------------------------------------------------------------
+	// --------------------------------------------------------------------------------------------
+	return compilationStatus;
+}
+
+CompilationStatus compileTree(CompilerState * compilerState) {
+	Telemetry * telemetry = compilerState->telemetry;
+	if (telemetry != NULL) {
+		telemetry->programs += 1;
+		_measureProgram(compilerState->abstractSyntaxtTree, telemetry);
+	}
+	return _computeAndGenerate(compilerState, telemetry == NULL ? 0 : telemetrySeconds());
+}
+
+CompilationStatus saveTree(CompilerState * compilerState, const char * path) {
+	setMemoryPhase(PARSING_PHASE);
+	const SyntacticAnalysisStatus syntacticAnalysisStatus = parse(compilerState);
+	setMemoryPhase(DRIVER_PHASE);
+	if (syntacticAnalysisStatus != ACCEPT) {
+		logError(_logger, "The syntactic-analysis phase rejects the input program.");
+		return FAILED;
+	}
+	FILE * stream = fopen(path, "wb");
+	if (stream == NULL) {
+		logError(_logger, "The tree file \"%s\" cannot be opened: %s.", path, strerror(errno));
+		return FAILED;
+	}
+	const boolean written = writeTreeFile(stream, compilerState->abstractSyntaxtTree);
+	if (fclose(stream) != 0 || !written) {
+		logError(_logger, "The tree file \"%s\" cannot be written completely.", path);
+		return FAILED;
+	}
+	return SUCCEED;
+}
@@ -0,0 +1,47 @@
+#ifndef COMPILATION_HEADER
+#define COMPILATION_HEADER
+
+#include "../backend/code-generation/Generator.h"
+#include "../backend/domain-specific/Calculator.h"
+#include "../backend/native-code/NativeCode.h"
+#include "../backend/virtual-machine/Bytecode.h"
+#include "../backend/virtual-machine/VirtualMachine.h"
+#include "../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../frontend/syntactic-analysis/SyntacticAnalyzer.h"
+#include "../frontend/syntactic-analysis/TreeFile.h"
+#include "../shared/CompilerState.h"
+#include "../shared/Environment.h"
+#include "../shared/Logger.h"
+#include "../shared/Memory.h"
+#include <errno.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeCompilationModule();
+
+/** Shutdown module's internal state. */
+void shutdownCompilationModule();
+
+/**
+ * Compiles the program of the compiler state: parses it, computes its value
+ * and, in generation mode, generates the final output (if the state has an
+ * output stream). The nodes of the AST are left in the arena of the state, so
+ * the caller decides when to release (or reset) it.
+ */
+CompilationStatus compile(CompilerState * compilerState);
+
+/**
+ * Compiles an AST that was already built (e.g., loaded from a tree file in
+ * the compiler state), without parsing anything: computes its value and, in
+ * generation mode, generates the final output.
+ */
+CompilationStatus compileTree(CompilerState * compilerState);
+
+/**
+ * Parses the program of the compiler state (which must be in generation
+ * mode), and writes its AST into a tree file, without compiling it, so it can
+ * be compiled in another process.
+ */
+CompilationStatus saveTree(CompilerState * compilerState, const char * path);
+
+#endif
@@ -0,0 +1,343 @@
+#include "CompilationCache.h"
+
+/**
+ * The first bytes of every entry, which change with its layout.
+ */
+#define CACHE_ENTRY_MAGIC "CACHE\0\0\1"
+
+/**
+ * The age after which a temporary file is considered abandoned (e.g., by a
+ * process that crashed), and is removed on the next eviction, in seconds.
+ */
+#define CACHE_TEMPORARY_LIFETIME (60 * 60)
+
+/* MODULE INTERNAL STATE */
+
+static const char * _directory = NULL;
+static boolean _generateOutput = true;
+static Logger * _logger = NULL;
+static uint64_t _maximumBytes = 0;
+
+void initializeCompilationCacheModule() {
+	_logger = createLogger("CompilationCache");
+	_directory = getStringOrDefault("CACHE_DIRECTORY", NULL);
+	_generateOutput = getBooleanOrDefault("GENERATE_OUTPUT", true);
+	_maximumBytes = strtoull(getStringOrDefault("CACHE_SIZE", "1024"), NULL, 10) * 1024 * 1024;
+	if (_directory != NULL && mkdir(_directory, 0777) != 0 && errno != EEXIST) {
+		logWarning(_logger, "The cache is disabled, because its directory \"%s\" cannot be created: %s.", _directory, strerror(errno));
+		_directory = NULL;
+	}
+}
+
+void shutdownCompilationCacheModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The beginning of every entry, followed by the captured output.
+ */
+typedef struct {
+	char magic[8];
+	uint32_t status;
+	uint32_t reserved;
+	uint64_t outputLength;
+} CacheEntryHeader;
+
+/**
+ * An entry found while evicting.
+ */
+typedef struct {
+	char * name;
+	off_t size;
+	struct timespec usage;
+} CachedFile;
+
+static int _compareUsages(const void * left, const void * right);
+static boolean _copyOutput(const int file, uint64_t length, FILE * output);
+static void _destroyCacheEntry(CacheEntry * cacheEntry);
+static char * _entryPath(const char * prefix, const char * key, const char * suffix);
+static void _evict(void);
+static boolean _isEntryName(const char * name);
+
+/**
+ * Sorts the entries from the least to the most recently used.
+ */
+static int _compareUsages(const void * left, const void * right) {
+	const struct timespec * leftUsage = &((const CachedFile *) left)->usage;
+	const struct timespec * rightUsage = &((const CachedFile *) right)->usage;
+	if (leftUsage->tv_sec != rightUsage->tv_sec) {
+		return leftUsage->tv_sec < rightUsage->tv_sec ? -1 : 1;
+	}
+	return leftUsage->tv_nsec < rightUsage->tv_nsec ? -1 : leftUsage->tv_nsec > rightUsage->tv_nsec;
+}
+
+/**
+ * Copies the next bytes of a file into the output, straight into its file
+ * descriptor (the pending bytes of the output are flushed first). On Linux,
+ * the kernel copies them without going through user-space, if it can.
+ */
+static boolean _copyOutput(const int file, uint64_t length, FILE * output) {
+	if (fflush(output) != 0) {
+		return false;
+	}
+#if defined(__linux__)
+	while (0 < length) {
+		const ssize_t sentBytes = sendfile(fileno(output), file, NULL, length < (1 << 30) ? length : (1 << 30));
+		if (sentBytes <= 0) {
+			if (sentBytes < 0 && errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		length -= (uint64_t) sentBytes;
+	}
+#endif
+	char buffer[64 * 1024];
+	while (0 < length) {
+		const ssize_t readBytes = read(file, buffer, length < sizeof(buffer) ? length : sizeof(buffer));
+		if (readBytes < 0 && errno == EINTR) {
+			continue;
+		}
+		if (readBytes <= 0) {
+			return false;
+		}
+		for (ssize_t writtenBytes = 0; writtenBytes < readBytes;) {
+			const ssize_t chunk = write(fileno(output), buffer + writtenBytes, readBytes - writtenBytes);
+			if (chunk < 0 && errno != EINTR) {
+				return false;
+			}
+			writtenBytes += chunk < 0 ? 0 : chunk;
+		}
+		length -= readBytes;
+	}
+	return true;
+}
+
+static void _destroyCacheEntry(CacheEntry * cacheEntry) {
+	if (cacheEntry->stream != NULL) {
+		fclose(cacheEntry->stream);
+	}
+	releaseMemory(cacheEntry->temporaryPath);
+	releaseMemory(cacheEntry);
+}
+
+/**
+ * The path of a file inside the cache directory, named after a key (between
+ * a prefix and a suffix, which can be empty). Returns NULL if the system ran
+ * out of memory.
+ */
+static char * _entryPath(const char * prefix, const char * key, const char * suffix) {
+	const size_t length = strlen(_directory) + strlen(prefix) + strlen(key) + strlen(suffix) + 2;
+	char * path = allocateMemory(length);
+	if (path != NULL) {
+		snprintf(path, length, "%s/%s%s%s", _directory, prefix, key, suffix);
+	}
+	return path;
+}
+
+/**
+ * Removes the least recently used entries (by their modification time, which
+ * is refreshed on every hit), if the cache exceeds its size, until it only
+ * takes 3/4 of it, so the next misses don't evict again. Also removes the
+ * abandoned temporary files. Another process can remove the same entries
+ * concurrently, or still be reading them, which is harmless.
+ */
+static void _evict(void) {
+	DIR * directory = opendir(_directory);
+	if (directory == NULL) {
+		return;
+	}
+	CachedFile * files = NULL;
+	size_t count = 0;
+	size_t capacity = 0;
+	uint64_t bytes = 0;
+	const time_t now = time(NULL);
+	for (struct dirent * directoryEntry = readdir(directory); directoryEntry != NULL; directoryEntry = readdir(directory)) {
+		const char * name = directoryEntry->d_name;
+		struct stat status;
+		if (fstatat(dirfd(directory), name, &status, AT_SYMLINK_NOFOLLOW) != 0 || !S_ISREG(status.st_mode)) {
+			continue;
+		}
+		if (name[0] == '.' && _isEntryName(name + 1) && CACHE_TEMPORARY_LIFETIME < now - status.st_mtime) {
+			unlinkat(dirfd(directory), name, 0);
+		}
+		if (!_isEntryName(name) || name[DIGEST_HEXADECIMAL_LENGTH] != '\0') {
+			continue;
+		}
+		if (count == capacity) {
+			capacity = capacity == 0 ? 256 : 2 * capacity;
+			CachedFile * grown = reallocateMemory(files, capacity * sizeof(CachedFile));
+			if (grown == NULL) {
+				break;
+			}
+			files = grown;
+		}
+		files[count].name = strdup(name);
+		files[count].size = status.st_size;
+		files[count].usage = status.st_mtim;
+		if (files[count].name == NULL) {
+			break;
+		}
+		bytes += (uint64_t) status.st_size;
+		++count;
+	}
+	if (_maximumBytes < bytes) {
+		logDebugging(_logger, "The cache takes %" PRIu64 " bytes of %" PRIu64 ", evicting...", bytes, _maximumBytes);
+		qsort(files, count, sizeof(CachedFile), _compareUsages);
+		for (size_t k = 0; k < count && _maximumBytes / 4 * 3 < bytes; ++k) {
+			if (unlinkat(dirfd(directory), files[k].name, 0) == 0 || errno == ENOENT) {
+				bytes -= (uint64_t) files[k].size;
+			}
+		}
+	}
+	for (size_t k = 0; k < count; ++k) {
+		// Allocated by "strdup", outside of the tracked memory.
+		free(files[k].name);
+	}
+	releaseMemory(files);
+	closedir(directory);
+}
+
+/**
+ * Returns true if the name starts with a key.
+ */
+static boolean _isEntryName(const char * name) {
+	for (unsigned int k = 0; k < DIGEST_HEXADECIMAL_LENGTH; ++k) {
+		if (!(('0' <= name[k] && name[k] <= '9') || ('a' <= name[k] && name[k] <= 'f'))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* PUBLIC FUNCTIONS */
+
+boolean isCompilationCacheEnabled() {
+	return _directory != NULL;
+}
+
+void computeCacheKey(const char * source, const size_t length, const CompilationMode mode, CacheKey key) {
+	// The version and the options are terminated by null bytes, so they are
+	// never confused with the beginning of the source.
+	const char options[2] = { (char) ('0' + mode), _generateOutput ? 'G' : '-' };
+	Digest digest;
+	resetDigest(&digest);
+	updateDigest(&digest, COMPILER_VERSION, sizeof(COMPILER_VERSION));
+	updateDigest(&digest, options, sizeof(options));
+	updateDigest(&digest, "", 1);
+	updateDigest(&digest, source, length);
+	finishDigest(&digest, key);
+}
+
+CacheEntry * createCacheEntry(const CacheKey key) {
+	CacheEntry * cacheEntry = allocateZeroedMemory(1, sizeof(CacheEntry));
+	if (cacheEntry == NULL) {
+		return NULL;
+	}
+	memcpy(cacheEntry->key, key, sizeof(CacheKey));
+	// The temporary file is hidden, and unique to this process.
+	cacheEntry->temporaryPath = _entryPath(".", key, ".XXXXXX");
+	const int file = cacheEntry->temporaryPath == NULL ? -1 : mkstemp(cacheEntry->temporaryPath);
+	if (0 <= file) {
+		// The entries are readable by every process that shares the cache.
+		fchmod(file, 0644);
+		cacheEntry->stream = fdopen(file, "w+b");
+		if (cacheEntry->stream == NULL) {
+			close(file);
+		}
+	}
+	const CacheEntryHeader header = { 0 };
+	if (cacheEntry->stream == NULL || fwrite(&header, sizeof(header), 1, cacheEntry->stream) != 1) {
+		logWarning(_logger, "The compilation cannot be cached: %s.", strerror(errno));
+		if (0 <= file) {
+			unlink(cacheEntry->temporaryPath);
+		}
+		_destroyCacheEntry(cacheEntry);
+		return NULL;
+	}
+	return cacheEntry;
+}
+
+boolean commitCacheEntry(CacheEntry * cacheEntry, const CompilationStatus compilationStatus, FILE * output) {
+	FILE * stream = cacheEntry->stream;
+	CacheEntryHeader header = {
+		.outputLength = 0,
+		.reserved = 0,
+		.status = (uint32_t) compilationStatus
+	};
+	memcpy(header.magic, CACHE_ENTRY_MAGIC, sizeof(header.magic));
+	const long end = fflush(stream) == 0 ? ftell(stream) : -1;
+	header.outputLength = end < 0 ? 0 : (uint64_t) end - sizeof(header);
+	// The header is written at last, so a partial entry never has the magic.
+	const boolean captured = 0 <= end
+		&& fseek(stream, 0, SEEK_SET) == 0
+		&& fwrite(&header, sizeof(header), 1, stream) == 1
+		&& fflush(stream) == 0
+		&& !ferror(stream);
+	const boolean copied = lseek(fileno(stream), sizeof(header), SEEK_SET) == (off_t) sizeof(header)
+		&& _copyOutput(fileno(stream), header.outputLength, output);
+	// A failed compilation is only cached without output (i.e., if the program
+	// is rejected), because a failure during the generation may be transient.
+	const boolean cacheable = compilationStatus == SUCCEED || header.outputLength == 0;
+	char * path = _entryPath("", cacheEntry->key, "");
+	if (!cacheable) {
+		logDebugging(_logger, "The failed generation of \"%s\" is not cached.", cacheEntry->key);
+		unlink(cacheEntry->temporaryPath);
+	}
+	else if (captured && path != NULL && rename(cacheEntry->temporaryPath, path) == 0) {
+		logDebugging(_logger, "Cached the output of \"%s\" (%" PRIu64 " bytes).", cacheEntry->key, header.outputLength);
+		_evict();
+	}
+	else {
+		logWarning(_logger, "The compilation cannot be cached: %s.", strerror(errno));
+		unlink(cacheEntry->temporaryPath);
+	}
+	releaseMemory(path);
+	_destroyCacheEntry(cacheEntry);
+	if (!captured || !copied) {
+		logError(_logger, "The output could not be written completely.");
+	}
+	return captured && copied;
+}
+
+boolean replayCacheEntry(const CacheKey key, FILE * output, CompilationStatus * compilationStatus) {
+	char * path = _entryPath("", key, "");
+	const int file = path == NULL ? -1 : open(path, O_RDONLY);
+	if (file < 0) {
+		logDebugging(_logger, "Cache miss on \"%s\".", key);
+		releaseMemory(path);
+		return false;
+	}
+	CacheEntryHeader header;
+	struct stat status;
+	if (read(file, &header, sizeof(header)) != (ssize_t) sizeof(header)
+		|| memcmp(header.magic, CACHE_ENTRY_MAGIC, sizeof(header.magic)) != 0
+		|| fstat(file, &status) != 0
+		|| (uint64_t) status.st_size != sizeof(header) + header.outputLength) {
+		logWarning(_logger, "Ignoring the corrupted entry \"%s\" of the cache.", key);
+		close(file);
+		releaseMemory(path);
+		return false;
+	}
+	logDebugging(_logger, "Cache hit on \"%s\" (%" PRIu64 " bytes).", key, header.outputLength);
+	// Refreshes the modification time, which tracks the last usage. If it
+	// fails, the entry is only evicted earlier than it should.
+	if (utimensat(AT_FDCWD, path, NULL, 0) != 0) {
+		logWarning(_logger, "The last usage of the entry \"%s\" cannot be refreshed: %s.", key, strerror(errno));
+	}
+	releaseMemory(path);
+	*compilationStatus = (CompilationStatus) header.status;
+	if (!_copyOutput(file, header.outputLength, output)) {
+		logError(_logger, "The output could not be written completely.");
+		*compilationStatus = FAILED;
+	}
+	else if (*compilationStatus != SUCCEED) {
+		logError(_logger, "A previous compilation of the same program failed (the failure is cached).");
+	}
+	close(file);
+	return true;
+}
@@ -0,0 +1,100 @@
+#ifndef COMPILATION_CACHE_HEADER
+#define COMPILATION_CACHE_HEADER
+
+#include "../shared/CompilerState.h"
+#include "../shared/Digest.h"
+#include "../shared/Environment.h"
+#include "../shared/Logger.h"
+#include "../shared/Memory.h"
+#include "../shared/Type.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#if defined(__linux__)
+	#include <sys/sendfile.h>
+#endif
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * The version of the compiler, which is part of every key of the cache (so a
+ * new version never reuses the outputs of an older one).
+ */
+#ifndef COMPILER_VERSION
+	#define COMPILER_VERSION "unknown"
+#endif
+
+/** Initialize module's internal state. */
+void initializeCompilationCacheModule();
+
+/** Shutdown module's internal state. */
+void shutdownCompilationCacheModule();
+
+/**
+ * The key of a program in the cache: the digest of its content, the version
+ * of the compiler and the options that change the output, in hexadecimal.
+ */
+typedef char CacheKey[DIGEST_HEXADECIMAL_LENGTH + 1];
+
+/**
+ * An entry of the cache that is being produced: the output of a compilation
+ * is captured in a temporary file inside the cache directory, which becomes
+ * the entry only when the compilation is done.
+ */
+typedef struct {
+	// The key of the entry.
+	CacheKey key;
+
+	// The stream where the output must be written, instead of the final one.
+	FILE * stream;
+
+	// The path of the temporary file.
+	char * temporaryPath;
+} CacheEntry;
+
+/**
+ * Returns true if the cache is enabled (i.e., if the "CACHE_DIRECTORY"
+ * variable is defined).
+ */
+boolean isCompilationCacheEnabled();
+
+/**
+ * Computes the key of a program, in the specified mode. It must be computed
+ * before the compilation, because the scanner can modify the source in place.
+ */
+void computeCacheKey(const char * source, const size_t length, const CompilationMode mode, CacheKey key);
+
+/**
+ * Creates a new entry for a key, to capture the output of its compilation.
+ * Returns NULL if the temporary file cannot be created (e.g., the cache
+ * directory is not writable), so the compilation must not be cached.
+ */
+CacheEntry * createCacheEntry(const CacheKey key);
+
+/**
+ * Completes the entry with the status of its compilation: copies the captured
+ * output into the final stream, publishes the entry with an atomic rename (so
+ * a concurrent process either finds all of it, or nothing), evicts the least
+ * recently used entries if the cache exceeds its size, and destroys the
+ * entry. A failed compilation with some output (that is, a failed generation)
+ * is not published. Returns false if the output cannot be captured, or copied
+ * into the final stream.
+ */
+boolean commitCacheEntry(CacheEntry * cacheEntry, const CompilationStatus compilationStatus, FILE * output);
+
+/**
+ * Looks for the entry of a key. If it's found, copies its output into the
+ * stream, sets the status of its compilation, and returns true. Otherwise,
+ * returns false without writing anything. Only the output is cached, so the
+ * diagnostics logged by the compilation (e.g., the syntax errors) are not
+ * replayed.
+ */
+boolean replayCacheEntry(const CacheKey key, FILE * output, CompilationStatus * compilationStatus);
+
+#endif
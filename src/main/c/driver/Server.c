@@ -0,0 +1,430 @@
+#include "Server.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeServerModule() {
+	_logger = createLogger("Server");
+}
+
+void shutdownServerModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The kinds of requests, as indexes of the statistics.
+ */
+typedef enum {
+	EVALUATE_INDEX = 0,
+	GENERATE_INDEX = 1,
+	STATISTICS_INDEX = 2
+} ServerRequestIndex;
+
+#define SERVER_REQUEST_KINDS 3
+
+/**
+ * The statistics of a kind of request.
+ */
+typedef struct {
+	Histogram latencies;
+	uint64_t failures;
+} ServerRequestStatistics;
+
+/**
+ * The state shared by the workers of a server. Everything but the
+ * configuration and the socket is protected by the mutex.
+ */
+typedef struct {
+	const ServerConfiguration * serverConfiguration;
+	int socket;
+	pthread_mutex_t mutex;
+
+	// If true, the server is stopping: the workers finish their current
+	// request, and leave.
+	boolean stopping;
+
+	// The connection of each worker (or -1, if it's waiting for a client), so
+	// they can be interrupted while stopping.
+	int * clients;
+
+	// The statistics since the start.
+	double startSeconds;
+	uint64_t connections;
+	uint64_t receivedBytes;
+	uint64_t sentBytes;
+	ServerRequestStatistics requests[SERVER_REQUEST_KINDS];
+} Server;
+
+/**
+ * A worker of a server, and its position among the others.
+ */
+typedef struct {
+	Server * server;
+	unsigned int index;
+} ServerWorker;
+
+static CompilationStatus _compileRequest(const uint32_t code, Arena * arena, char * source, const size_t length, FILE * output);
+static boolean _receive(const int socket, void * bytes, size_t length);
+static boolean _send(const int socket, const void * bytes, size_t length);
+static boolean _serveRequest(ServerWorker * serverWorker, const int client, Arena * arena, char ** source, size_t * capacity);
+static void _setClient(Server * server, const unsigned int index, const int client);
+static void _writeStatistics(Server * server, FILE * stream);
+static void * _work(void * argument);
+
+/**
+ * Compiles (or evaluates) a program, and writes what the compiler outputs
+ * outside of the server into the stream. The program must be followed by two
+ * null bytes, so it's scanned in place. The arena is reset afterwards.
+ */
+static CompilationStatus _compileRequest(const uint32_t code, Arena * arena, char * source, const size_t length, FILE * output) {
+	CompilerState compilerState = {
+		.abstractSyntaxtTree = NULL,
+		.arena = arena,
+		.computed = false,
+		.input = NULL,
+		.mode = code == EVALUATE_REQUEST ? EVALUATION_MODE : GENERATION_MODE,
+		.nodeTable = NULL,
+		.output = output,
+		.scanInPlace = true,
+		.scanner = NULL,
+		.source = source,
+		.sourceLength = length,
+		.spilledTree = NULL,
+		.succeed = false,
+		.telemetry = NULL,
+		.tokenRing = NULL,
+		.value = {
+			.big = NULL,
+			.small = 0
+		}
+	};
+	CompilationStatus compilationStatus = compile(&compilerState);
+	if (compilationStatus == SUCCEED && compilerState.mode == EVALUATION_MODE) {
+		char * value = integerToString(compilerState.value);
+		if (value == NULL) {
+			logError(_logger, "There is no memory left to respond the value.");
+			compilationStatus = FAILED;
+		}
+		else {
+			fprintf(output, "%s\n", value);
+			releaseMemory(value);
+		}
+	}
+	setMemoryPhase(RELEASE_PHASE);
+	resetArena(arena);
+	setMemoryPhase(DRIVER_PHASE);
+	return compilationStatus;
+}
+
+/**
+ * Receives exactly the specified amount of bytes. Returns false if the
+ * connection was closed before, or failed.
+ */
+static boolean _receive(const int socket, void * bytes, size_t length) {
+	char * next = bytes;
+	while (0 < length) {
+		const ssize_t receivedBytes = recv(socket, next, length, 0);
+		if (receivedBytes < 0 && errno == EINTR) {
+			continue;
+		}
+		if (receivedBytes <= 0) {
+			return false;
+		}
+		next += receivedBytes;
+		length -= (size_t) receivedBytes;
+	}
+	return true;
+}
+
+/**
+ * Sends exactly the specified amount of bytes (without raising SIGPIPE if the
+ * client left). Returns false if the connection failed.
+ */
+static boolean _send(const int socket, const void * bytes, size_t length) {
+	const char * next = bytes;
+	while (0 < length) {
+		const ssize_t sentBytes = send(socket, next, length, MSG_NOSIGNAL);
+		if (sentBytes < 0 && errno == EINTR) {
+			continue;
+		}
+		if (sentBytes < 0) {
+			return false;
+		}
+		next += sentBytes;
+		length -= (size_t) sentBytes;
+	}
+	return true;
+}
+
+/**
+ * Serves the next request of a client. The program is received into a buffer
+ * of the worker, which grows on demand. Returns false if the client left, if
+ * the request is invalid, or if the server is stopping (so the connection
+ * must be closed).
+ */
+static boolean _serveRequest(ServerWorker * serverWorker, const int client, Arena * arena, char ** source, size_t * capacity) {
+	Server * server = serverWorker->server;
+	ServerFrame request;
+	if (!_receive(client, &request, sizeof(request))) {
+		return false;
+	}
+	const double start = telemetrySeconds();
+	ServerRequestIndex index;
+	switch (request.code) {
+		case EVALUATE_REQUEST: index = EVALUATE_INDEX; break;
+		case GENERATE_REQUEST: index = GENERATE_INDEX; break;
+		case STATISTICS_REQUEST: index = STATISTICS_INDEX; break;
+		default:
+			logWarning(_logger, "Closing a connection with an unknown request (code %u).", request.code);
+			return false;
+	}
+	if (SERVER_MAXIMUM_LENGTH < request.length) {
+		logWarning(_logger, "Closing a connection with a program too long (%" PRIu64 " bytes).", request.length);
+		return false;
+	}
+	if (*capacity < request.length + 2) {
+		char * bytes = reallocateMemory(*source, request.length + 2);
+		if (bytes == NULL) {
+			logError(_logger, "There is no memory left to receive a program of %" PRIu64 " bytes.", request.length);
+			return false;
+		}
+		*source = bytes;
+		*capacity = request.length + 2;
+	}
+	if (!_receive(client, *source, request.length)) {
+		return false;
+	}
+	(*source)[request.length] = '\0';
+	(*source)[request.length + 1] = '\0';
+
+	// The output of the request is accumulated in memory, because its length
+	// precedes it.
+	char * output = NULL;
+	size_t outputLength = 0;
+	FILE * stream = open_memstream(&output, &outputLength);
+	CompilationStatus compilationStatus = FAILED;
+	if (stream == NULL) {
+		logError(_logger, "There is no memory left for the output of a request.");
+	}
+	else if (index == STATISTICS_INDEX) {
+		_writeStatistics(server, stream);
+		compilationStatus = SUCCEED;
+	}
+	else {
+		compilationStatus = _compileRequest(request.code, arena, *source, request.length, stream);
+	}
+	if (stream != NULL && fclose(stream) != 0) {
+		compilationStatus = FAILED;
+	}
+	const ServerFrame response = {
+		.code = compilationStatus,
+		.length = output == NULL ? 0 : outputLength,
+		.reserved = 0
+	};
+	const boolean sent = _send(client, &response, sizeof(response)) && _send(client, output, response.length);
+	// Allocated by "open_memstream", outside of the tracked memory.
+	free(output);
+
+	pthread_mutex_lock(&server->mutex);
+	const uint64_t nanoseconds = (uint64_t) ((telemetrySeconds() - start) * 1e9);
+	recordHistogram(&server->requests[index].latencies, nanoseconds);
+	server->requests[index].failures += compilationStatus != SUCCEED;
+	server->receivedBytes += sizeof(request) + request.length;
+	server->sentBytes += sent ? sizeof(response) + response.length : 0;
+	const boolean stopping = server->stopping;
+	pthread_mutex_unlock(&server->mutex);
+	return sent && !stopping;
+}
+
+/**
+ * Publishes the connection of a worker, or -1 when it's done with it.
+ */
+static void _setClient(Server * server, const unsigned int index, const int client) {
+	pthread_mutex_lock(&server->mutex);
+	server->clients[index] = client;
+	if (0 <= client) {
+		server->connections += 1;
+		// Stops before serving a client accepted while stopping.
+		if (server->stopping) {
+			shutdown(client, SHUT_RD);
+		}
+	}
+	pthread_mutex_unlock(&server->mutex);
+}
+
+/**
+ * Writes the statistics of the server as a JSON line. The latencies are in
+ * microseconds.
+ */
+static void _writeStatistics(Server * server, FILE * stream) {
+	static const char * names[SERVER_REQUEST_KINDS] = { "evaluate", "generate", "statistics" };
+	pthread_mutex_lock(&server->mutex);
+	unsigned int activeConnections = 0;
+	for (unsigned int k = 0; k < server->serverConfiguration->jobs; ++k) {
+		activeConnections += 0 <= server->clients[k];
+	}
+	fprintf(stream, "{\"seconds\":%.3f,\"workers\":%u,\"connections\":{\"active\":%u,\"total\":%" PRIu64 "},\"receivedBytes\":%" PRIu64 ",\"sentBytes\":%" PRIu64 ",\"requests\":{",
+		telemetrySeconds() - server->startSeconds,
+		server->serverConfiguration->jobs,
+		activeConnections,
+		server->connections,
+		server->receivedBytes,
+		server->sentBytes);
+	for (unsigned int k = 0; k < SERVER_REQUEST_KINDS; ++k) {
+		const Histogram * latencies = &server->requests[k].latencies;
+		fprintf(stream, "%s\"%s\":{\"count\":%" PRIu64 ",\"failures\":%" PRIu64 ",\"latency\":{\"mean\":%.3f,\"p50\":%.3f,\"p99\":%.3f,\"maximum\":%.3f}}",
+			k == 0 ? "" : ",",
+			names[k],
+			latencies->length,
+			server->requests[k].failures,
+			latencies->length == 0 ? 0.0 : latencies->sum / 1e3 / latencies->length,
+			histogramPercentile(latencies, 50) / 1e3,
+			histogramPercentile(latencies, 99) / 1e3,
+			latencies->maximum / 1e3);
+	}
+	fprintf(stream, "}}\n");
+	pthread_mutex_unlock(&server->mutex);
+}
+
+/**
+ * Accepts a client at a time, and serves its requests until it leaves. Every
+ * worker has its own arena and program buffer, reused between requests.
+ */
+static void * _work(void * argument) {
+	ServerWorker * serverWorker = argument;
+	Server * server = serverWorker->server;
+	Arena * arena = createArena(ARENA_DEFAULT_BLOCK_SIZE);
+	char * source = NULL;
+	size_t capacity = 0;
+	while (true) {
+		const int client = accept(server->socket, NULL, NULL);
+		if (client < 0) {
+			pthread_mutex_lock(&server->mutex);
+			const boolean stopping = server->stopping;
+			pthread_mutex_unlock(&server->mutex);
+			if (stopping) {
+				break;
+			}
+			if (errno != EINTR && errno != ECONNABORTED) {
+				logError(_logger, "A client cannot be accepted: %s.", strerror(errno));
+			}
+			continue;
+		}
+		_setClient(server, serverWorker->index, client);
+		while (_serveRequest(serverWorker, client, arena, &source, &capacity));
+		_setClient(server, serverWorker->index, -1);
+		close(client);
+	}
+	releaseMemory(source);
+	destroyArena(arena);
+	return NULL;
+}
+
+/* PUBLIC FUNCTIONS */
+
+CompilationStatus serve(const ServerConfiguration * serverConfiguration) {
+	struct sockaddr_un address = {
+		.sun_family = AF_UNIX
+	};
+	if (sizeof(address.sun_path) <= strlen(serverConfiguration->socketPath)) {
+		logError(_logger, "The socket path is too long: \"%s\".", serverConfiguration->socketPath);
+		return FAILED;
+	}
+	strcpy(address.sun_path, serverConfiguration->socketPath);
+	// Replaces the socket of a previous server (but never another file).
+	struct stat status;
+	if (lstat(address.sun_path, &status) == 0 && S_ISSOCK(status.st_mode)) {
+		unlink(address.sun_path);
+	}
+	const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listener < 0 || bind(listener, (struct sockaddr *) &address, sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0) {
+		logError(_logger, "The server cannot listen on \"%s\": %s.", address.sun_path, strerror(errno));
+		if (0 <= listener) {
+			close(listener);
+		}
+		return FAILED;
+	}
+
+	// The signals that stop the server are only received by this thread
+	// (every worker inherits the mask).
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+	ServerConfiguration configuration = *serverConfiguration;
+	if (configuration.jobs == 0) {
+		const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		configuration.jobs = cores < 1 ? 1 : (unsigned int) cores;
+	}
+	Server * server = allocateZeroedMemory(1, sizeof(Server));
+	pthread_t * threads = allocateZeroedMemory(configuration.jobs, sizeof(pthread_t));
+	ServerWorker * serverWorkers = allocateZeroedMemory(configuration.jobs, sizeof(ServerWorker));
+	int * clients = allocateMemory(configuration.jobs * sizeof(int));
+	if (server == NULL || threads == NULL || serverWorkers == NULL || clients == NULL) {
+		logError(_logger, "There is no memory left to start the server.");
+		releaseMemory(server);
+		releaseMemory(threads);
+		releaseMemory(serverWorkers);
+		releaseMemory(clients);
+		close(listener);
+		unlink(address.sun_path);
+		return FAILED;
+	}
+	for (unsigned int k = 0; k < configuration.jobs; ++k) {
+		clients[k] = -1;
+	}
+	server->clients = clients;
+	server->serverConfiguration = &configuration;
+	server->socket = listener;
+	server->startSeconds = telemetrySeconds();
+	pthread_mutex_init(&server->mutex, NULL);
+	unsigned int startedThreads = 0;
+	for (unsigned int k = 0; k < configuration.jobs; ++k) {
+		serverWorkers[k].server = server;
+		serverWorkers[k].index = k;
+		if (pthread_create(&threads[k], NULL, _work, &serverWorkers[k]) != 0) {
+			logWarning(_logger, "Only %u of %u workers could be started.", startedThreads, configuration.jobs);
+			break;
+		}
+		++startedThreads;
+	}
+	CompilationStatus serverStatus = 0 < startedThreads ? SUCCEED : FAILED;
+	if (0 < startedThreads) {
+		logInformation(_logger, "Listening on \"%s\", with %u workers...", address.sun_path, startedThreads);
+		int received = 0;
+		sigwait(&signals, &received);
+		logInformation(_logger, "Stopping (signal %d)...", received);
+	}
+
+	// Interrupts every pending accept, and every client waiting for its next
+	// request (but the current requests are responded).
+	pthread_mutex_lock(&server->mutex);
+	server->stopping = true;
+	shutdown(listener, SHUT_RDWR);
+	for (unsigned int k = 0; k < configuration.jobs; ++k) {
+		if (0 <= clients[k]) {
+			shutdown(clients[k], SHUT_RD);
+		}
+	}
+	pthread_mutex_unlock(&server->mutex);
+	for (unsigned int k = 0; k < startedThreads; ++k) {
+		pthread_join(threads[k], NULL);
+	}
+	close(listener);
+	unlink(address.sun_path);
+	_writeStatistics(server, stderr);
+	pthread_mutex_destroy(&server->mutex);
+	pthread_sigmask(SIG_UNBLOCK, &signals, NULL);
+	releaseMemory(server);
+	releaseMemory(threads);
+	releaseMemory(serverWorkers);
+	releaseMemory(clients);
+	return serverStatus;
+}
@@ -0,0 +1,89 @@
+#ifndef SERVER_HEADER
+#define SERVER_HEADER
+
+#include "../shared/Arena.h"
+#include "../shared/CompilerState.h"
+#include "../shared/Histogram.h"
+#include "../shared/Logger.h"
+#include "../shared/Memory.h"
+#include "../shared/String.h"
+#include "../shared/Telemetry.h"
+#include "../shared/Type.h"
+#include "Compilation.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * The maximum length of a program sent to a server, in bytes.
+ */
+#define SERVER_MAXIMUM_LENGTH (1024 * 1024 * 1024)
+
+/** Initialize module's internal state. */
+void initializeServerModule();
+
+/** Shutdown module's internal state. */
+void shutdownServerModule();
+
+/**
+ * What a client can request to a server.
+ */
+typedef enum {
+	// Computes the value of the program, and responds it in decimal.
+	EVALUATE_REQUEST = 'E',
+
+	// Compiles the program, and responds its final output.
+	GENERATE_REQUEST = 'G',
+
+	// Responds the statistics of the server, as a JSON line (without
+	// program).
+	STATISTICS_REQUEST = 'S'
+} ServerRequest;
+
+/**
+ * The header of every request and response, followed by a payload of the
+ * specified length: the program of a request, or the output of a response
+ * (exactly what the compiler outputs outside of the server). The fields are
+ * in the byte order of the host, which is the same for both ends of a Unix
+ * domain socket.
+ */
+typedef struct {
+	// The kind of a request, or the status of the compilation of a response.
+	uint32_t code;
+	uint32_t reserved;
+	uint64_t length;
+} ServerFrame;
+
+/**
+ * Where a server must listen, and how.
+ */
+typedef struct {
+	// The path of the Unix domain socket (replaced, if it exists).
+	const char * socketPath;
+
+	// The amount of worker threads, each one serving a client at a time (0 to
+	// use one per online core).
+	unsigned int jobs;
+} ServerConfiguration;
+
+/**
+ * Serves the requests of many concurrent clients over a Unix domain socket,
+ * with the modules already initialized, until the process receives SIGINT or
+ * SIGTERM. A client can send many requests over the same connection, one at
+ * a time. Every worker compiles over its own arena, which is reset after each
+ * request, so the memory of a request never outlives it. The latency of
+ * every kind of request is recorded in a histogram, and reported (with the
+ * percentiles 50 and 99) on a statistics request, and at exit.
+ */
+CompilationStatus serve(const ServerConfiguration * serverConfiguration);
+
+#endif
@@ -0,0 +1,401 @@
+#include "Table.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeTableModule() {
+	_logger = createLogger("Table");
+}
+
+void shutdownTableModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+/**
+ * An input column, and the resources that hold it: the mapped file of a
+ * binary column, or the name and the values parsed from a CSV table.
+ */
+typedef struct {
+	Column column;
+	size_t rows;
+	MappedFile * mappedFile;
+	char * name;
+	int64_t * values;
+} TableColumn;
+
+/**
+ * Every input column of an evaluation.
+ */
+typedef struct {
+	TableColumn * columns;
+	size_t length;
+	size_t capacity;
+} Table;
+
+static TableColumn * _addColumn(Table * table);
+static void _destroyTable(Table * table);
+static boolean _isBlank(const char character);
+static boolean _loadBinaryColumn(Table * table, const char * binding);
+static boolean _loadCsvTable(Table * table, const char * path);
+static Bytecode * _lowerProgram(Arena * arena, const char * path);
+static boolean _parseCell(const char ** cursor, const char * end, int64_t * value);
+static boolean _printResult(const ColumnarResult * columnarResult);
+static boolean _writeFile(const char * path, const void * bytes, const size_t length);
+
+/**
+ * Appends an empty column to the table. Returns NULL if the table couldn't
+ * grow.
+ */
+static TableColumn * _addColumn(Table * table) {
+	if (table->length == table->capacity) {
+		const size_t capacity = table->capacity == 0 ? 8 : 2 * table->capacity;
+		TableColumn * columns = reallocateMemory(table->columns, capacity * sizeof(TableColumn));
+		if (columns == NULL) {
+			logError(_logger, "There is no memory left for another column.");
+			return NULL;
+		}
+		table->columns = columns;
+		table->capacity = capacity;
+	}
+	TableColumn * tableColumn = table->columns + table->length++;
+	memset(tableColumn, 0, sizeof(TableColumn));
+	return tableColumn;
+}
+
+/**
+ * Releases every column of the table, and their resources.
+ */
+static void _destroyTable(Table * table) {
+	for (size_t k = 0; k < table->length; ++k) {
+		if (table->columns[k].mappedFile != NULL) {
+			destroyMappedFile(table->columns[k].mappedFile);
+		}
+		// Allocated by "strndup", outside of the tracked memory.
+		free(table->columns[k].name);
+		releaseMemory(table->columns[k].values);
+	}
+	releaseMemory(table->columns);
+}
+
+/**
+ * Returns true if the character is a space or a tab.
+ */
+static boolean _isBlank(const char character) {
+	return character == ' ' || character == '\t';
+}
+
+/**
+ * Maps a binary column in memory, from a "name=path" argument. The rows are
+ * read in place, so they're never copied.
+ */
+static boolean _loadBinaryColumn(Table * table, const char * binding) {
+	const char * separator = strchr(binding, '=');
+	if (separator == NULL || separator == binding) {
+		logError(_logger, "The binding \"%s\" is not of the form \"name=path\".", binding);
+		return false;
+	}
+	TableColumn * tableColumn = _addColumn(table);
+	if (tableColumn == NULL) {
+		return false;
+	}
+	tableColumn->name = strndup(binding, (size_t) (separator - binding));
+	if (tableColumn->name == NULL) {
+		logError(_logger, "There is no memory left for another column.");
+		return false;
+	}
+	tableColumn->mappedFile = createMappedFile(separator + 1);
+	if (tableColumn->mappedFile == NULL) {
+		logError(_logger, "The column \"%s\" cannot be mapped in memory: %s.", separator + 1, strerror(errno));
+		return false;
+	}
+	if (tableColumn->mappedFile->length % sizeof(int64_t) != 0) {
+		logError(_logger, "The column \"%s\" is not a sequence of 64-bit integers (it has %zu bytes).", separator + 1, tableColumn->mappedFile->length);
+		return false;
+	}
+	tableColumn->column.name = tableColumn->name;
+	tableColumn->column.values = (const int64_t *) tableColumn->mappedFile->bytes;
+	tableColumn->rows = tableColumn->mappedFile->length / sizeof(int64_t);
+	return true;
+}
+
+/**
+ * Parses a CSV table into a column per field of its header. The fields are
+ * separated by commas, and surrounded by optional blanks. The empty lines are
+ * ignored.
+ */
+static boolean _loadCsvTable(Table * table, const char * path) {
+	MappedFile * mappedFile = createMappedFile(path);
+	if (mappedFile == NULL) {
+		logError(_logger, "The table \"%s\" cannot be mapped in memory: %s.", path, strerror(errno));
+		return false;
+	}
+	const char * cursor = mappedFile->bytes;
+	const char * end = cursor + mappedFile->length;
+	const size_t first = table->length;
+	boolean succeed = true;
+	while (succeed) {
+		while (cursor < end && _isBlank(*cursor)) ++cursor;
+		const char * name = cursor;
+		while (cursor < end && *cursor != ',' && *cursor != '\n' && *cursor != '\r') ++cursor;
+		const char * nameEnd = cursor;
+		while (name < nameEnd && _isBlank(nameEnd[-1])) --nameEnd;
+		if (name == nameEnd) {
+			logError(_logger, "The header of the table \"%s\" has an empty name.", path);
+			succeed = false;
+			break;
+		}
+		TableColumn * tableColumn = _addColumn(table);
+		if (tableColumn == NULL) {
+			succeed = false;
+			break;
+		}
+		tableColumn->name = strndup(name, (size_t) (nameEnd - name));
+		tableColumn->column.name = tableColumn->name;
+		succeed = tableColumn->name != NULL;
+		if (cursor == end || *cursor != ',') {
+			break;
+		}
+		++cursor;
+	}
+	size_t capacity = 0;
+	size_t rows = 0;
+	unsigned int line = 1;
+	while (succeed && cursor < end) {
+		// Consumes the end of the previous line.
+		if (*cursor == '\r') {
+			++cursor;
+		}
+		if (cursor < end && *cursor == '\n') {
+			++cursor;
+			++line;
+		}
+		while (cursor < end && _isBlank(*cursor)) ++cursor;
+		if (cursor == end || *cursor == '\n' || *cursor == '\r') {
+			continue;
+		}
+		if (rows == capacity) {
+			capacity = capacity == 0 ? 1024 : 2 * capacity;
+			for (size_t k = first; succeed && k < table->length; ++k) {
+				int64_t * values = reallocateMemory(table->columns[k].values, capacity * sizeof(int64_t));
+				if (values == NULL) {
+					logError(_logger, "There is no memory left for the table \"%s\".", path);
+					succeed = false;
+				}
+				else {
+					table->columns[k].values = values;
+				}
+			}
+		}
+		for (size_t k = first; succeed && k < table->length; ++k) {
+			succeed = _parseCell(&cursor, end, &table->columns[k].values[rows])
+				&& (k + 1 == table->length ? cursor == end || *cursor == '\n' || *cursor == '\r' : cursor < end && *cursor++ == ',');
+			if (!succeed) {
+				logError(_logger, "The table \"%s\" has an invalid row on line %u (expected %zu integers).", path, line, table->length - first);
+			}
+		}
+		++rows;
+	}
+	for (size_t k = first; k < table->length; ++k) {
+		table->columns[k].column.values = table->columns[k].values;
+		table->columns[k].rows = rows;
+	}
+	destroyMappedFile(mappedFile);
+	return succeed;
+}
+
+/**
+ * Parses the program, and lowers it into bytecode. Its AST is allocated in
+ * the arena, which must outlive the bytecode (the names of the variables
+ * live there). Returns NULL if it's rejected.
+ */
+static Bytecode * _lowerProgram(Arena * arena, const char * path) {
+	MappedFile * mappedFile = NULL;
+	FILE * stream = path == NULL ? stdin : NULL;
+	if (path != NULL) {
+		// A file that cannot be mapped (e.g., a pipe) is scanned as a stream.
+		mappedFile = createMappedFile(path);
+		if (mappedFile == NULL && errno == ENODEV) {
+			stream = fopen(path, "r");
+		}
+		if (mappedFile == NULL && stream == NULL) {
+			logError(_logger, "The program \"%s\" cannot be read: %s.", path, strerror(errno));
+			return NULL;
+		}
+	}
+	CompilerState compilerState = {
+		.abstractSyntaxtTree = NULL,
+		.arena = arena,
+		.computed = false,
+		.input = stream,
+		.mode = GENERATION_MODE,
+		.nodeTable = NULL,
+		.output = NULL,
+		.scanInPlace = mappedFile != NULL,
+		.scanner = NULL,
+		.source = mappedFile == NULL ? NULL : mappedFile->bytes,
+		.sourceLength = mappedFile == NULL ? 0 : mappedFile->length,
+		.spilledTree = NULL,
+		.succeed = false,
+		.telemetry = NULL,
+		.tokenRing = NULL,
+		.value = {
+			.big = NULL,
+			.small = 0
+		}
+	};
+	Bytecode * bytecode = NULL;
+	if (parse(&compilerState) == ACCEPT) {
+		bytecode = lowerProgram(compilerState.abstractSyntaxtTree);
+	}
+	else {
+		logError(_logger, "The syntactic-analysis phase rejects the input program.");
+	}
+	if (mappedFile != NULL) {
+		destroyMappedFile(mappedFile);
+	}
+	if (stream != NULL && stream != stdin) {
+		fclose(stream);
+	}
+	return bytecode;
+}
+
+/**
+ * Parses a decimal 64-bit integer, with an optional sign, and surrounded by
+ * optional blanks. Returns false if there is no integer, or if it overflows.
+ */
+static boolean _parseCell(const char ** cursor, const char * end, int64_t * value) {
+	const char * character = *cursor;
+	while (character < end && _isBlank(*character)) ++character;
+	const boolean negative = character < end && *character == '-';
+	if (character < end && (*character == '-' || *character == '+')) ++character;
+	const char * digits = character;
+	int64_t magnitude = 0;
+	boolean overflow = false;
+	for (; character < end && '0' <= *character && *character <= '9'; ++character) {
+		// The magnitude is accumulated as a negative number, so the minimum fits.
+		overflow |= __builtin_mul_overflow(magnitude, 10, &magnitude);
+		overflow |= __builtin_sub_overflow(magnitude, *character - '0', &magnitude);
+	}
+	overflow |= !negative && magnitude == INT64_MIN;
+	while (character < end && _isBlank(*character)) ++character;
+	*cursor = character;
+	*value = negative ? magnitude : -magnitude;
+	return digits < character && '0' <= *digits && *digits <= '9' && !overflow;
+}
+
+/**
+ * Prints the result in decimal, one row per line (empty if it's invalid).
+ */
+static boolean _printResult(const ColumnarResult * columnarResult) {
+	Writer * writer = createWriter(stdout, 1 << 16, false);
+	if (writer == NULL) {
+		logError(_logger, "There is no memory left to print the result.");
+		return false;
+	}
+	for (size_t k = 0; k < columnarResult->rows; ++k) {
+		if ((columnarResult->validity[k / 64] >> (k % 64)) & 1) {
+			const Integer value = {
+				.big = NULL,
+				.small = columnarResult->values[k]
+			};
+			writeLargeInteger(writer, value);
+		}
+		writeCharacter(writer, '\n');
+	}
+	return destroyWriter(writer);
+}
+
+/**
+ * Writes an entire file at once.
+ */
+static boolean _writeFile(const char * path, const void * bytes, const size_t length) {
+	FILE * file = fopen(path, "wb");
+	if (file == NULL) {
+		logError(_logger, "The result cannot be written into \"%s\": %s.", path, strerror(errno));
+		return false;
+	}
+	// The file is closed even if it couldn't be written, but the first error
+	// is the one reported.
+	boolean succeed = fwrite(bytes, 1, length, file) == length;
+	int error = errno;
+	if (fclose(file) != 0 && succeed) {
+		succeed = false;
+		error = errno;
+	}
+	if (!succeed) {
+		logError(_logger, "The result cannot be written into \"%s\": %s.", path, strerror(error));
+	}
+	return succeed;
+}
+
+/* PUBLIC FUNCTIONS */
+
+CompilationStatus evaluateTable(const TableConfiguration * tableConfiguration) {
+	Table table = {
+		.capacity = 0,
+		.columns = NULL,
+		.length = 0
+	};
+	boolean succeed = true;
+	for (unsigned int k = 0; succeed && k < tableConfiguration->bindingsCount; ++k) {
+		succeed = _loadBinaryColumn(&table, tableConfiguration->bindings[k]);
+	}
+	if (succeed && tableConfiguration->csvPath != NULL) {
+		succeed = _loadCsvTable(&table, tableConfiguration->csvPath);
+	}
+	for (size_t k = 1; succeed && k < table.length; ++k) {
+		if (table.columns[k].rows != table.columns[0].rows) {
+			logError(_logger, "The column \"%s\" has %zu rows, but the column \"%s\" has %zu.",
+				table.columns[k].name, table.columns[k].rows, table.columns[0].name, table.columns[0].rows);
+			succeed = false;
+		}
+	}
+	Arena * arena = createArena(ARENA_DEFAULT_BLOCK_SIZE);
+	Column * columns = succeed ? allocateZeroedMemory(1 + table.length, sizeof(Column)) : NULL;
+	Bytecode * bytecode = columns == NULL ? NULL : _lowerProgram(arena, tableConfiguration->programPath);
+	ColumnarResult * columnarResult = NULL;
+	if (bytecode != NULL) {
+		for (size_t k = 0; k < table.length; ++k) {
+			columns[k] = table.columns[k].column;
+		}
+		const size_t rows = table.length == 0 ? 0 : table.columns[0].rows;
+		const double start = telemetrySeconds();
+		columnarResult = evaluateColumns(bytecode, columns, table.length, rows);
+		const double seconds = telemetrySeconds() - start;
+		if (columnarResult != NULL) {
+			fprintf(stderr, "Evaluated %zu rows (%zu invalid, with %zu divisions by zero and %zu overflows) in %.3f seconds: %.1f rows/s.\n",
+				rows, columnarResult->invalidRows, columnarResult->divisionsByZero, columnarResult->overflows,
+				seconds, 0 < seconds ? rows / seconds : 0.0);
+		}
+	}
+	if (columnarResult == NULL) {
+		logError(_logger, "The columnar evaluation rejects the input program.");
+		succeed = false;
+	}
+	else if (tableConfiguration->resultPath == NULL) {
+		succeed = _printResult(columnarResult);
+	}
+	else {
+		const size_t length = strlen(tableConfiguration->resultPath);
+		char * validityPath = allocateMemory(length + sizeof(".validity"));
+		if (validityPath != NULL) {
+			memcpy(validityPath, tableConfiguration->resultPath, length);
+			memcpy(validityPath + length, ".validity", sizeof(".validity"));
+		}
+		succeed = validityPath != NULL
+			&& _writeFile(tableConfiguration->resultPath, columnarResult->values, columnarResult->rows * sizeof(int64_t))
+			&& _writeFile(validityPath, columnarResult->validity, COLUMNAR_VALIDITY_WORDS(columnarResult->rows) * sizeof(uint64_t));
+		releaseMemory(validityPath);
+	}
+	destroyColumnarResult(columnarResult);
+	destroyBytecode(bytecode);
+	destroyArena(arena);
+	releaseMemory(columns);
+	_destroyTable(&table);
+	return succeed ? SUCCEED : FAILED;
+}
@@ -0,0 +1,59 @@
+#ifndef TABLE_HEADER
+#define TABLE_HEADER
+
+#include "../backend/columnar-evaluation/ColumnarEvaluator.h"
+#include "../backend/virtual-machine/Bytecode.h"
+#include "../frontend/syntactic-analysis/SyntacticAnalyzer.h"
+#include "../shared/Arena.h"
+#include "../shared/CompilerState.h"
+#include "../shared/Logger.h"
+#include "../shared/MappedFile.h"
+#include "../shared/Memory.h"
+#include "../shared/Telemetry.h"
+#include "../shared/Type.h"
+#include "../shared/Writer.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeTableModule();
+
+/** Shutdown module's internal state. */
+void shutdownTableModule();
+
+/**
+ * What a columnar evaluation must read, and where it must write the result.
+ */
+typedef struct {
+	// The path of the program, or NULL to read it from the standard input.
+	const char * programPath;
+
+	// The binary columns, as "name=path" arguments, where the file holds the
+	// rows of the variable "name" as native 64-bit integers.
+	const char ** bindings;
+	unsigned int bindingsCount;
+
+	// The path of a CSV table, or NULL. Its header names the variable of each
+	// column, and every other line is a row of decimal integers.
+	const char * csvPath;
+
+	// The path of the binary result (as native 64-bit integers), which is
+	// followed by its validity mask in another file with the same path plus
+	// a ".validity" extension. If NULL, the result is printed in decimal to
+	// the standard output, one row per line (empty, if the row is invalid).
+	const char * resultPath;
+} TableConfiguration;
+
+/**
+ * Compiles a program with variables, binds every variable to an input column
+ * (with the same amount of rows), and evaluates it once per row over the
+ * entire columns. The failures of each row (i.e., a division by zero, or an
+ * overflow of 64 bits) are reported in the validity mask, and their amounts
+ * in the standard error, so they don't fail the evaluation.
+ */
+CompilationStatus evaluateTable(const TableConfiguration * tableConfiguration);
+
+#endif
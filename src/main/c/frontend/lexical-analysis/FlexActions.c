@@ -21,21 +21,33 @@ void shutdownFlexActionsModule() {
 static void _logLexicalAnalyzerContext(const char * functionName, LexicalAnalyzerContext * lexicalAnalyzerContext);
 
 /**
- * Logs a lexical-analyzer context in DEBUGGING level.
+ * Logs a lexical-analyzer context in DEBUGGING level. The lexeme is copied
+ * and escaped only if that level is visible.
  */
 static void _logLexicalAnalyzerContext(const char * functionName, LexicalAnalyzerContext * lexicalAnalyzerContext) {
-	char * escapedLexeme = escape(lexicalAnalyzerContext->lexeme);
+	if (!isLoggingEnabled(_logger, DEBUGGING)) {
+		return;
+	}
+	char * lexeme = copyLexeme(lexicalAnalyzerContext);
+	char * escapedLexeme = escape(lexeme);
 	logDebugging(_logger, "%s: %s (context = %d, length = %d, line = %d)",
 		functionName,
 		escapedLexeme,
 		lexicalAnalyzerContext->currentContext,
 		lexicalAnalyzerContext->length,
 		lexicalAnalyzerContext->line);
-	free(escapedLexeme);
+	releaseMemory(escapedLexeme);
+	releaseMemory(lexeme);
 }
 
 /* PUBLIC FUNCTIONS */
 
+Token StartTokenLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
+	const Token startToken = lexicalAnalyzerContext->startToken;
+	lexicalAnalyzerContext->startToken = 0;
+	return startToken;
+}
+
 void BeginMultilineCommentLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
 	if (_logIgnoredLexemes) {
 		_logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
@@ -60,9 +72,26 @@ Token ArithmeticOperatorLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerCon
 	return token;
 }
 
+Token IdentifierLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
+	_logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
+	// The lexeme is not terminated, and it doesn't outlive the scanner buffer.
+	char * name = allocateInArena(lexicalAnalyzerContext->arena, lexicalAnalyzerContext->length + 1);
+	if (name == NULL) {
+		logError(_logger, "There is no memory left for the identifier on line %u.", lexicalAnalyzerContext->line);
+		return UNKNOWN;
+	}
+	memcpy(name, lexicalAnalyzerContext->lexeme, lexicalAnalyzerContext->length);
+	lexicalAnalyzerContext->semanticValue->name = name;
+	return IDENTIFIER;
+}
+
 Token IntegerLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext) {
 	_logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
-	lexicalAnalyzerContext->semanticValue->integer = atoi(lexicalAnalyzerContext->lexeme);
+	// The literals that don't fit in 64 bits are kept in the arena, as the AST.
+	if (!parseInteger(lexicalAnalyzerContext->arena, lexicalAnalyzerContext->lexeme, lexicalAnalyzerContext->length, &lexicalAnalyzerContext->semanticValue->integer)) {
+		logError(_logger, "There is no memory left for the integer on line %u.", lexicalAnalyzerContext->line);
+		return UNKNOWN;
+	}
 	return INTEGER;
 }
 
@@ -1,8 +1,10 @@
 #ifndef FLEX_ACTIONS_HEADER
 #define FLEX_ACTIONS_HEADER
 
+#include "../../backend/domain-specific/Calculator.h"
 #include "../../shared/Environment.h"
 #include "../../shared/Logger.h"
+#include "../../shared/Memory.h"
 #include "../../shared/String.h"
 #include "../../shared/Type.h"
 #include "../syntactic-analysis/AbstractSyntaxTree.h"
@@ -10,6 +12,7 @@
 #include "LexicalAnalyzerContext.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 /** Initialize module's internal state. */
 void initializeFlexActionsModule();
@@ -21,11 +24,19 @@ void shutdownFlexActionsModule();
  * Flex lexeme processing actions.
  */
 
+/**
+ * Emits the artificial start token of the context only once, before the first
+ * lexeme (or returns 0, if there is none). It allows the parser to select the
+ * grammar to use, depending on the mode of the compilation.
+ */
+Token StartTokenLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext);
+
 void BeginMultilineCommentLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext);
 void EndMultilineCommentLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext);
 void IgnoredLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext);
 
 Token ArithmeticOperatorLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext, Token token);
+Token IdentifierLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext);
 Token IntegerLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext);
 Token ParenthesisLexemeAction(LexicalAnalyzerContext * lexicalAnalyzerContext, Token token);
 
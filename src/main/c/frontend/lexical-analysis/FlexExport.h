@@ -4,10 +4,85 @@
 /**
  * Hook that allows to export a static function or variable from the inside of
  * Flex infrastructure, in this case, the current context (a.k.a. start
- * condition).
+ * condition) of a scanner.
  */
-unsigned int flexCurrentContext(void) {
+unsigned int flexCurrentContext(void * scanner) {
+	struct yyguts_t * yyg = (struct yyguts_t *) scanner;
 	return YY_START;
 }
 
+/**
+ * Hook that refreshes the lexical-analyzer context of a scanner (its extra
+ * data) with the lexeme just consumed. The state is read directly from the
+ * inside of the scanner, so it doesn't allocate any memory.
+ */
+LexicalAnalyzerContext * currentLexicalAnalyzerContext(void * scanner) {
+	struct yyguts_t * yyg = (struct yyguts_t *) scanner;
+	LexicalAnalyzerContext * lexicalAnalyzerContext = yyextra;
+	lexicalAnalyzerContext->currentContext = YY_START;
+	lexicalAnalyzerContext->length = yyleng;
+	lexicalAnalyzerContext->lexeme = yytext;
+	lexicalAnalyzerContext->line = yylineno;
+	lexicalAnalyzerContext->semanticValue = yylval;
+	return lexicalAnalyzerContext;
+}
+
+/**
+ * Hook that skips the rest of a multiline comment, and the ignored lexemes
+ * after it, directly over the buffer of the scanner. It counts the lines,
+ * and moves the position and the hold character of Flex past the skipped
+ * bytes. The current lexeme becomes empty, right at that position, so Flex
+ * never looks back into the skipped bytes (e.g., when it refills the buffer).
+ * Only the buffer in memory is skipped: a comment that doesn't end inside it
+ * is left to the patterns of the "MULTILINE_COMMENT" context.
+ */
+boolean flexSkipMultilineComment(void * scanner) {
+	struct yyguts_t * yyg = (struct yyguts_t *) scanner;
+	char * from = yyg->yy_c_buf_p;
+	char * to = YY_CURRENT_BUFFER_LVALUE->yy_ch_buf + yyg->yy_n_chars;
+	unsigned int lines = 0;
+	*from = yyg->yy_hold_char;
+	char * end = (char *) skipMultilineComment(from, to, &lines);
+	if (end == NULL) {
+		*from = '\0';
+		return false;
+	}
+	yylineno += lines;
+	yyg->yytext_ptr = end;
+	yyleng = 0;
+	yyg->yy_hold_char = *end;
+	*end = '\0';
+	yyg->yy_c_buf_p = end;
+	return true;
+}
+
+/**
+ * Hook that prepares a scanner to scan a program from a sequence of bytes in
+ * memory (Flex copies them into a buffer owned by the scanner).
+ */
+void flexScanBytes(void * scanner, const char * bytes, const size_t length) {
+	yy_scan_bytes(bytes, (int) length, scanner);
+	yyset_lineno(1, scanner);
+}
+
+/**
+ * Hook that prepares a scanner to scan a program in place, without copying it.
+ * The bytes must be writable (Flex modifies them temporarily while scanning),
+ * and the length must include two trailing null bytes.
+ *
+ * @see https://westes.github.io/flex/manual/Multiple-Input-Buffers.html
+ */
+void flexScanBuffer(void * scanner, char * bytes, const size_t length) {
+	yy_scan_buffer(bytes, (yy_size_t) length, scanner);
+	yyset_lineno(1, scanner);
+}
+
+/**
+ * Hook that prepares a scanner to scan a program from a stream.
+ */
+void flexScanStream(void * scanner, FILE * stream) {
+	yyrestart(stream, scanner);
+	yyset_lineno(1, scanner);
+}
+
 #endif
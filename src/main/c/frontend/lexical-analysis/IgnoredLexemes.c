@@ -0,0 +1,214 @@
+#include "IgnoredLexemes.h"
+
+/**
+ * The vector instructions are only used with GCC-compatible compilers on
+ * x86-64, where SSE2 is always available, and AVX2 is detected at runtime.
+ * Otherwise, the bytes are scanned one at a time.
+ */
+#if defined(__GNUC__) && defined(__x86_64__)
+	#include <immintrin.h>
+	#define VECTORIZED_IGNORED_LEXEMES
+#endif
+
+/* MODULE INTERNAL STATE */
+
+static boolean _avx2 = false;
+static boolean _enabled = true;
+static Logger * _logger = NULL;
+
+void initializeIgnoredLexemesModule() {
+	_logger = createLogger("IgnoredLexemes");
+	_enabled = getBooleanOrDefault("SKIP_IGNORED_LEXEMES", _enabled);
+#ifdef VECTORIZED_IGNORED_LEXEMES
+	__builtin_cpu_init();
+	_avx2 = __builtin_cpu_supports("avx2");
+#endif
+	logDebugging(_logger, "Skipping ignored lexemes: %s (with %s).",
+		_enabled ? "enabled" : "disabled",
+		_avx2 ? "AVX2" : "SSE2");
+}
+
+void shutdownIgnoredLexemesModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+static const char * _findCommentEnd(const char * from, const char * to, unsigned int * lines);
+#ifdef VECTORIZED_IGNORED_LEXEMES
+static const char * _findCommentEndAvx2(const char * from, const char * to, unsigned int * lines);
+#endif
+static const char * _findCommentEndScalar(const char * from, const char * to, unsigned int * lines);
+#ifdef VECTORIZED_IGNORED_LEXEMES
+static const char * _findCommentEndSse2(const char * from, const char * to, unsigned int * lines);
+#endif
+static boolean _isWhitespace(const char character);
+static const char * _skipWhitespace(const char * from, const char * to, unsigned int * lines);
+
+/**
+ * Returns the byte that follows the first "*" + "/" between "from" and "to",
+ * and adds the newlines before it to "lines", or returns NULL if there is no
+ * such end (without adding anything).
+ */
+static const char * _findCommentEnd(const char * from, const char * to, unsigned int * lines) {
+#ifdef VECTORIZED_IGNORED_LEXEMES
+	return _avx2
+		? _findCommentEndAvx2(from, to, lines)
+		: _findCommentEndSse2(from, to, lines);
+#else
+	return _findCommentEndScalar(from, to, lines);
+#endif
+}
+
+#ifdef VECTORIZED_IGNORED_LEXEMES
+
+/**
+ * Finds the end of a comment 32 bytes at a time. Each block is compared with
+ * the same block shifted by one byte, so an end that crosses two blocks is
+ * found too.
+ */
+__attribute__((target("avx2")))
+static const char * _findCommentEndAvx2(const char * from, const char * to, unsigned int * lines) {
+	const __m256i asterisks = _mm256_set1_epi8('*');
+	const __m256i newlines = _mm256_set1_epi8('\n');
+	const __m256i slashes = _mm256_set1_epi8('/');
+	unsigned int skippedLines = 0;
+	const char * block = from;
+	for (; block + 33 <= to; block += 32) {
+		const __m256i bytes = _mm256_loadu_si256((const __m256i *) block);
+		const __m256i nextBytes = _mm256_loadu_si256((const __m256i *) (block + 1));
+		const unsigned int ends = (unsigned int) _mm256_movemask_epi8(
+			_mm256_and_si256(_mm256_cmpeq_epi8(bytes, asterisks), _mm256_cmpeq_epi8(nextBytes, slashes)));
+		const unsigned int newlineMask = (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newlines));
+		if (ends != 0) {
+			const unsigned int offset = __builtin_ctz(ends);
+			*lines += skippedLines + __builtin_popcount(newlineMask & ((1u << offset) - 1));
+			return block + offset + 2;
+		}
+		skippedLines += __builtin_popcount(newlineMask);
+	}
+	const char * end = _findCommentEndScalar(block, to, &skippedLines);
+	if (end != NULL) {
+		*lines += skippedLines;
+	}
+	return end;
+}
+
+#endif
+
+/**
+ * Finds the end of a comment one byte at a time.
+ */
+static const char * _findCommentEndScalar(const char * from, const char * to, unsigned int * lines) {
+	unsigned int skippedLines = 0;
+	for (const char * byte = from; byte + 1 < to; ++byte) {
+		if (byte[0] == '*' && byte[1] == '/') {
+			*lines += skippedLines;
+			return byte + 2;
+		}
+		if (byte[0] == '\n') {
+			++skippedLines;
+		}
+	}
+	return NULL;
+}
+
+#ifdef VECTORIZED_IGNORED_LEXEMES
+
+/**
+ * Finds the end of a comment 16 bytes at a time (as the AVX2 version).
+ */
+static const char * _findCommentEndSse2(const char * from, const char * to, unsigned int * lines) {
+	const __m128i asterisks = _mm_set1_epi8('*');
+	const __m128i newlines = _mm_set1_epi8('\n');
+	const __m128i slashes = _mm_set1_epi8('/');
+	unsigned int skippedLines = 0;
+	const char * block = from;
+	for (; block + 17 <= to; block += 16) {
+		const __m128i bytes = _mm_loadu_si128((const __m128i *) block);
+		const __m128i nextBytes = _mm_loadu_si128((const __m128i *) (block + 1));
+		const unsigned int ends = (unsigned int) _mm_movemask_epi8(
+			_mm_and_si128(_mm_cmpeq_epi8(bytes, asterisks), _mm_cmpeq_epi8(nextBytes, slashes)));
+		const unsigned int newlineMask = (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newlines));
+		if (ends != 0) {
+			const unsigned int offset = __builtin_ctz(ends);
+			*lines += skippedLines + __builtin_popcount(newlineMask & ((1u << offset) - 1));
+			return block + offset + 2;
+		}
+		skippedLines += __builtin_popcount(newlineMask);
+	}
+	const char * end = _findCommentEndScalar(block, to, &skippedLines);
+	if (end != NULL) {
+		*lines += skippedLines;
+	}
+	return end;
+}
+
+#endif
+
+/**
+ * The same characters as the "[[:space:]]" class of Flex.
+ */
+static boolean _isWhitespace(const char character) {
+	return character == ' ' || ('\t' <= character && character <= '\r');
+}
+
+/**
+ * Skips a run of whitespace 16 bytes at a time (a byte is whitespace if it's
+ * a space, or if it's between a tab and a carriage return), and then one byte
+ * at a time.
+ */
+static const char * _skipWhitespace(const char * from, const char * to, unsigned int * lines) {
+	const char * byte = from;
+#ifdef VECTORIZED_IGNORED_LEXEMES
+	const __m128i controlRange = _mm_set1_epi8('\r' - '\t');
+	const __m128i newlines = _mm_set1_epi8('\n');
+	const __m128i spaces = _mm_set1_epi8(' ');
+	const __m128i tabs = _mm_set1_epi8('\t');
+	for (; byte + 16 <= to; byte += 16) {
+		const __m128i bytes = _mm_loadu_si128((const __m128i *) byte);
+		const __m128i offsets = _mm_sub_epi8(bytes, tabs);
+		const __m128i controls = _mm_cmpeq_epi8(_mm_min_epu8(offsets, controlRange), offsets);
+		const unsigned int whitespace = (unsigned int) _mm_movemask_epi8(_mm_or_si128(controls, _mm_cmpeq_epi8(bytes, spaces)));
+		const unsigned int newlineMask = (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newlines));
+		if (whitespace != 0xFFFF) {
+			const unsigned int offset = __builtin_ctz(~whitespace);
+			*lines += __builtin_popcount(newlineMask & ((1u << offset) - 1));
+			return byte + offset;
+		}
+		*lines += __builtin_popcount(newlineMask);
+	}
+#endif
+	for (; byte < to && _isWhitespace(*byte); ++byte) {
+		if (*byte == '\n') {
+			++*lines;
+		}
+	}
+	return byte;
+}
+
+/* PUBLIC FUNCTIONS */
+
+const char * skipMultilineComment(const char * from, const char * to, unsigned int * lines) {
+	if (!_enabled) {
+		return NULL;
+	}
+	const char * end = _findCommentEnd(from, to, lines);
+	while (end != NULL) {
+		end = _skipWhitespace(end, to, lines);
+		if (end + 1 < to && end[0] == '/' && end[1] == '*') {
+			// An unterminated comment is left to the scanner.
+			const char * commentEnd = _findCommentEnd(end + 2, to, lines);
+			if (commentEnd == NULL) {
+				return end;
+			}
+			end = commentEnd;
+		}
+		else {
+			return end;
+		}
+	}
+	return NULL;
+}
@@ -0,0 +1,26 @@
+#ifndef IGNORED_LEXEMES_HEADER
+#define IGNORED_LEXEMES_HEADER
+
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include <stdlib.h>
+
+/** Initialize module's internal state. */
+void initializeIgnoredLexemesModule();
+
+/** Shutdown module's internal state. */
+void shutdownIgnoredLexemesModule();
+
+/**
+ * Skips the rest of a multiline comment (right after its opening delimiter),
+ * and then every whitespace and complete multiline comment that follows, with
+ * vector instructions (AVX2 or SSE2, if available) over the bytes between
+ * "from" and "to". Adds the amount of newlines skipped to "lines", and returns
+ * the first significant byte. Returns NULL (without skipping anything) if the
+ * comment doesn't end before "to", or if the "SKIP_IGNORED_LEXEMES" variable
+ * disables this fast path.
+ */
+const char * skipMultilineComment(const char * from, const char * to, unsigned int * lines);
+
+#endif
@@ -1,30 +1,56 @@
 #ifndef LEXICAL_ANALYZER_CONTEXT_HEADER
 #define LEXICAL_ANALYZER_CONTEXT_HEADER
 
+#include "../../shared/CompilerState.h"
+#include "../../shared/Memory.h"
+#include "../../shared/Type.h"
 #include <stdlib.h>
 #include <string.h>
 
 /**
- * The state of a lexical-analyzer context.
+ * The state of a lexical-analyzer context. The lexeme is a view over the
+ * buffer of Flex: it's not null-terminated (use its length instead), and it's
+ * only valid during the action that receives the context.
  */
 typedef struct {
 	unsigned int currentContext;
 	unsigned int length;
-	char * lexeme;
+	const char * lexeme;
 	unsigned int line;
 	union SemanticValue * semanticValue;
+
+	// The memory where the values that outlive the lexeme are allocated (the
+	// names of identifiers, and the big integers): the arena of the
+	// compilation, or a private one while scanning in a thread of its own.
+	Arena * arena;
+
+	// The compilation that owns the lexical-analyzer.
+	CompilerState * compilerState;
+
+	// An artificial token to emit before the first lexeme (or 0, if none).
+	Token startToken;
 } LexicalAnalyzerContext;
 
 /**
- * Creates a new context with the current state of the lexical-analyzer over
- * the lexeme just consumed. The lexeme is a deep-copy of the original,
- * allocated in heap-memory.
+ * Refreshes the context of a scanner with its state over the lexeme just
+ * consumed. Every scanner has its own context, which is reused across lexemes,
+ * so it doesn't allocate any memory (it's implemented as a Flex hook).
+ */
+LexicalAnalyzerContext * currentLexicalAnalyzerContext(void * scanner);
+
+/**
+ * Skips the rest of the multiline comment just opened by a scanner, and every
+ * whitespace and comment after it, without matching them one by one (it's
+ * implemented as a Flex hook). The lexeme of the context becomes the skipped
+ * text. Returns false if nothing was skipped, so the scanner must match the
+ * comment itself.
  */
-LexicalAnalyzerContext * createLexicalAnalyzerContext();
+boolean flexSkipMultilineComment(void * scanner);
 
 /**
- * Destroy a lexical-analyzer context and its resources.
+ * Creates a null-terminated deep-copy of the lexeme of the context, allocated
+ * in heap-memory. The returned string must be freed.
  */
-void destroyLexicalAnalyzerContext(LexicalAnalyzerContext * lexicalAnalyzerContext);
+char * copyLexeme(const LexicalAnalyzerContext * lexicalAnalyzerContext);
 
 #endif
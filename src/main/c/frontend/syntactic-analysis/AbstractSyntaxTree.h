@@ -1,7 +1,10 @@
 #ifndef ABSTRACT_SYNTAX_TREE_HEADER
 #define ABSTRACT_SYNTAX_TREE_HEADER
 
+#include "../../shared/Integer.h"
 #include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include <stdint.h>
 #include <stdlib.h>
 
 /** Initialize module's internal state. */
@@ -15,63 +18,62 @@ void shutdownAbstractSyntaxTreeModule();
  */
 
 typedef enum ExpressionType ExpressionType;
-typedef enum FactorType FactorType;
 
-typedef struct Constant Constant;
 typedef struct Expression Expression;
-typedef struct Factor Factor;
 typedef struct Program Program;
 
 /**
- * Node types for the Abstract Syntax Tree (AST).
+ * Node types for the Abstract Syntax Tree (AST). Every node is allocated in
+ * the arena of the compiler state, so there are no destructors: the entire
+ * tree is released at once when that arena is destroyed. The identical
+ * subtrees can be shared (i.e., the AST can be a DAG), so the nodes must
+ * never be modified after parsing.
+ *
+ * There is a single type of node, tagged by its type: an arithmetic
+ * expression points to its operands, and a constant or a variable keeps its
+ * value or its name inline, so a literal is a single node. The parentheses
+ * don't change the meaning of an expression, so they are not nodes either:
+ * an expression only counts the pairs of parentheses around it, which the
+ * generator still renders as the factors of the grammar.
  */
 
 enum ExpressionType {
 	ADDITION,
+	CONSTANT,
 	DIVISION,
-	FACTOR,
 	MULTIPLICATION,
-	SUBTRACTION
-};
-
-enum FactorType {
-	CONSTANT,
-	EXPRESSION
-};
-
-struct Constant {
-	int value;
-};
-
-struct Factor {
-	union {
-		Constant * constant;
-		Expression * expression;
-	};
-	FactorType type;
+	SUBTRACTION,
+	VARIABLE
 };
 
 struct Expression {
 	union {
-		Factor * factor;
 		struct {
 			Expression * leftExpression;
 			Expression * rightExpression;
 		};
+
+		// The value of a constant.
+		Integer value;
+
+		// The name of a variable (inside the arena).
+		char * name;
 	};
-	ExpressionType type;
+
+	// The pairs of parentheses around the expression.
+	uint32_t parentheses;
+
+	// The ExpressionType, in a single byte (as the flag below), so the node
+	// takes 24 bytes, and more of them fit in a cache line.
+	uint8_t type;
+
+	// If true, the expression appears more than once in the program, so its
+	// value is computed only once.
+	uint8_t shared;
 };
 
 struct Program {
 	Expression * expression;
 };
 
-/**
- * Node recursive destructors.
- */
-void releaseConstant(Constant * constant);
-void releaseExpression(Expression * expression);
-void releaseFactor(Factor * factor);
-void releaseProgram(Program * program);
-
 #endif
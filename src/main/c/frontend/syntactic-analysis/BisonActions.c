@@ -16,12 +16,52 @@ void shutdownBisonActionsModule() {
 
 /** IMPORTED FUNCTIONS */
 
-extern unsigned int flexCurrentContext(void);
+extern unsigned int flexCurrentContext(void * scanner);
 
 /* PRIVATE FUNCTIONS */
 
+static void * _allocateNode(CompilerState * compilerState, const size_t size);
+static Expression * _createNode(CompilerState * compilerState, const Expression * expression);
+static boolean _isFinalContextValid(CompilerState * compilerState);
 static void _logSyntacticAnalyzerAction(const char * functionName);
 
+/**
+ * Allocates a new zeroed node inside the arena of the current compilation.
+ */
+static void * _allocateNode(CompilerState * compilerState, const size_t size) {
+	return allocateInArena(compilerState->arena, size);
+}
+
+/**
+ * Copies a node into the arena of the current compilation, or returns the
+ * identical one if it was already created (so the AST becomes a DAG).
+ */
+static Expression * _createNode(CompilerState * compilerState, const Expression * expression) {
+	if (compilerState->nodeTable != NULL) {
+		return internExpression(compilerState->nodeTable, compilerState->arena, expression);
+	}
+	Expression * copy = _allocateNode(compilerState, sizeof(Expression));
+	if (copy != NULL) {
+		memcpy(copy, expression, sizeof(Expression));
+	}
+	return copy;
+}
+
+/**
+ * Returns true if the lexical-analyzer ended in the default context (0). For
+ * example, it doesn't if a multiline comment was left open.
+ */
+static boolean _isFinalContextValid(CompilerState * compilerState) {
+	const unsigned int finalContext = flexCurrentContext(compilerState->scanner);
+	if (0 < finalContext) {
+		logError(_logger, "The final context is not the default (0): %d", finalContext);
+		return false;
+	}
+	else {
+		return true;
+	}
+}
+
 /**
  * Logs a syntactic-analyzer action in DEBUGGING level.
  */
@@ -31,57 +71,116 @@ static void _logSyntacticAnalyzerAction(const char * functionName) {
 
 /* PUBLIC FUNCTIONS */
 
-Constant * IntegerConstantSemanticAction(const int value) {
+Expression * ArithmeticExpressionSemanticAction(CompilerState * compilerState, Expression * leftExpression, Expression * rightExpression, ExpressionType type) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Constant * constant = calloc(1, sizeof(Constant));
-	constant->value = value;
-	return constant;
+	const Expression expression = {
+		.leftExpression = leftExpression,
+		.parentheses = 0,
+		.rightExpression = rightExpression,
+		.shared = false,
+		.type = type
+	};
+	return _createNode(compilerState, &expression);
 }
 
-Expression * ArithmeticExpressionSemanticAction(Expression * leftExpression, Expression * rightExpression, ExpressionType type) {
+Expression * IdentifierVariableSemanticAction(CompilerState * compilerState, char * name) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Expression * expression = calloc(1, sizeof(Expression));
-	expression->leftExpression = leftExpression;
-	expression->rightExpression = rightExpression;
-	expression->type = type;
-	return expression;
+	const Expression expression = {
+		.name = name,
+		.parentheses = 0,
+		.shared = false,
+		.type = VARIABLE
+	};
+	return _createNode(compilerState, &expression);
 }
 
-Expression * FactorExpressionSemanticAction(Factor * factor) {
+Expression * IntegerConstantSemanticAction(CompilerState * compilerState, const Integer value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Expression * expression = calloc(1, sizeof(Expression));
-	expression->factor = factor;
-	expression->type = FACTOR;
-	return expression;
+	const Expression expression = {
+		.parentheses = 0,
+		.shared = false,
+		.type = CONSTANT,
+		.value = value
+	};
+	return _createNode(compilerState, &expression);
 }
 
-Factor * ConstantFactorSemanticAction(Constant * constant) {
+Expression * ParenthesisExpressionSemanticAction(CompilerState * compilerState, Expression * expression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Factor * factor = calloc(1, sizeof(Factor));
-	factor->constant = constant;
-	factor->type = CONSTANT;
-	return factor;
-}
-
-Factor * ExpressionFactorSemanticAction(Expression * expression) {
-	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Factor * factor = calloc(1, sizeof(Factor));
-	factor->expression = expression;
-	factor->type = EXPRESSION;
-	return factor;
+	if (expression == NULL) {
+		return NULL;
+	}
+	if (compilerState->nodeTable == NULL) {
+		// Nothing else points to the expression yet, so it keeps the
+		// parentheses itself, instead of a new node.
+		expression->parentheses += 1;
+		return expression;
+	}
+	// The expression may be shared, so the parenthesized one is another node.
+	Expression parenthesized = *expression;
+	parenthesized.parentheses += 1;
+	parenthesized.shared = false;
+	return _createNode(compilerState, &parenthesized);
 }
 
 Program * ExpressionProgramSemanticAction(CompilerState * compilerState, Expression * expression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Program * program = calloc(1, sizeof(Program));
+	Program * program = _allocateNode(compilerState, sizeof(Program));
 	program->expression = expression;
 	compilerState->abstractSyntaxtTree = program;
-	if (0 < flexCurrentContext()) {
-		logError(_logger, "The final context is not the default (0): %d", flexCurrentContext());
-		compilerState->succeed = false;
+	compilerState->succeed = _isFinalContextValid(compilerState);
+	return program;
+}
+
+ComputationResult ArithmeticComputationSemanticAction(CompilerState * compilerState, const ComputationResult leftComputation, const ComputationResult rightComputation, ExpressionType type) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	if (compilerState->spilledTree != NULL) {
+		spillArithmeticExpression(compilerState->spilledTree, type);
 	}
-	else {
-		compilerState->succeed = true;
+	return computeBinaryOperation(compilerState->arena, type, leftComputation, rightComputation);
+}
+
+ComputationResult ComputationProgramSemanticAction(CompilerState * compilerState, const ComputationResult computation) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	compilerState->computed = computation.succeed;
+	compilerState->value = computation.value;
+	compilerState->succeed = _isFinalContextValid(compilerState);
+	return computation;
+}
+
+ComputationResult IdentifierComputationSemanticAction(CompilerState * compilerState, const char * name) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	if (compilerState->spilledTree != NULL) {
+		spillVariable(compilerState->spilledTree, name);
 	}
-	return program;
+	// Only a columnar evaluation binds the variables, to its input columns.
+	logError(_logger, "The variable \"%s\" is not bound.", name);
+	ComputationResult computation = {
+		.succeed = false,
+		.value = {
+			.big = NULL,
+			.small = 0
+		}
+	};
+	return computation;
+}
+
+ComputationResult IntegerComputationSemanticAction(CompilerState * compilerState, const Integer value) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	if (compilerState->spilledTree != NULL) {
+		spillConstant(compilerState->spilledTree, value);
+	}
+	ComputationResult computation = {
+		.succeed = true,
+		.value = value
+	};
+	return computation;
+}
+
+ComputationResult ParenthesisComputationSemanticAction(CompilerState * compilerState, const ComputationResult computation) {
+	_logSyntacticAnalyzerAction(__FUNCTION__);
+	if (compilerState->spilledTree != NULL) {
+		spillParenthesizedExpression(compilerState->spilledTree);
+	}
+	return computation;
 }
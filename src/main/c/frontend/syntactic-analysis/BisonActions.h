@@ -1,12 +1,16 @@
 #ifndef BISON_ACTIONS_HEADER
 #define BISON_ACTIONS_HEADER
 
+#include "../../backend/code-generation/SpilledTree.h"
+#include "../../backend/domain-specific/Calculator.h"
 #include "../../shared/CompilerState.h"
 #include "../../shared/Logger.h"
 #include "../../shared/Type.h"
 #include "AbstractSyntaxTree.h"
+#include "NodeTable.h"
 #include "SyntacticAnalyzer.h"
 #include <stdlib.h>
+#include <string.h>
 
 /** Initialize module's internal state. */
 void initializeBisonActionsModule();
@@ -18,11 +22,20 @@ void shutdownBisonActionsModule();
  * Bison semantic actions.
  */
 
-Constant * IntegerConstantSemanticAction(const int value);
-Expression * ArithmeticExpressionSemanticAction(Expression * leftExpression, Expression * rightExpression, ExpressionType type);
-Expression * FactorExpressionSemanticAction(Factor * factor);
-Factor * ConstantFactorSemanticAction(Constant * constant);
-Factor * ExpressionFactorSemanticAction(Expression * expression);
+Expression * ArithmeticExpressionSemanticAction(CompilerState * compilerState, Expression * leftExpression, Expression * rightExpression, ExpressionType type);
+Expression * IdentifierVariableSemanticAction(CompilerState * compilerState, char * name);
+Expression * IntegerConstantSemanticAction(CompilerState * compilerState, const Integer value);
+Expression * ParenthesisExpressionSemanticAction(CompilerState * compilerState, Expression * expression);
 Program * ExpressionProgramSemanticAction(CompilerState * compilerState, Expression * expression);
 
+/**
+ * Bison semantic actions (evaluation-only).
+ */
+
+ComputationResult ArithmeticComputationSemanticAction(CompilerState * compilerState, const ComputationResult leftComputation, const ComputationResult rightComputation, ExpressionType type);
+ComputationResult ComputationProgramSemanticAction(CompilerState * compilerState, const ComputationResult computation);
+ComputationResult IdentifierComputationSemanticAction(CompilerState * compilerState, const char * name);
+ComputationResult IntegerComputationSemanticAction(CompilerState * compilerState, const Integer value);
+ComputationResult ParenthesisComputationSemanticAction(CompilerState * compilerState, const ComputationResult computation);
+
 #endif
@@ -1,43 +1,62 @@
 %{
 
 #include "BisonActions.h"
+#include <stdint.h>
+
+/**
+ * The stacks of the parser start small and double on demand (in heap-memory)
+ * up to this depth, so the nesting of a program is only limited by the
+ * available memory.
+ *
+ * @see https://www.gnu.org/software/bison/manual/html_node/Memory-Management.html
+ */
+#define YYMAXDEPTH (PTRDIFF_MAX / 64)
 
 %}
 
+/**
+ * A pure (reentrant) parser: the state of the compilation is received as a
+ * parameter, and forwarded to the lexical-analyzer, instead of being global.
+ *
+ * @see https://www.gnu.org/software/bison/manual/html_node/Pure-Decl.html
+ */
+%code requires {
+	#include "../../shared/CompilerState.h"
+}
+%define api.pure full
+%param {CompilerState * compilerState}
+
 // You touch this, and you die.
 %define api.value.union.name SemanticValue
 
 %union {
 	/** Terminals. */
 
-	int integer;
+	Integer integer;
+	char * name;
 	Token token;
 
 	/** Non-terminals. */
 
-	Constant * constant;
 	Expression * expression;
-	Factor * factor;
 	Program * program;
+
+	/** Non-terminals (evaluation-only). */
+
+	ComputationResult computation;
 }
 
 /**
- * Destructors. This functions are executed after the parsing ends, so if the
- * AST must be used in the following phases of the compiler you shouldn't used
- * this approach. To use this mechanism, the AST must be translated into
- * another structure.
+ * Destructors are not needed: every node (and every big integer) lives in the
+ * arena of the compiler state, which is released at once even if the parsing
+ * fails.
  *
  * @see https://www.gnu.org/software/bison/manual/html_node/Destructor-Decl.html
  */
-/*
-%destructor { releaseConstant($$); } <constant>
-%destructor { releaseExpression($$); } <expression>
-%destructor { releaseFactor($$); } <factor>
-%destructor { releaseProgram($$); } <program>
-*/
 
 /** Terminals. */
 %token <integer> INTEGER
+%token <name> IDENTIFIER
 %token <token> ADD
 %token <token> CLOSE_PARENTHESIS
 %token <token> DIV
@@ -47,12 +66,20 @@
 
 %token <token> UNKNOWN
 
+/**
+ * Artificial terminal emitted by the lexical-analyzer before the first lexeme,
+ * only when the parser must use the evaluation-only grammar.
+ */
+%token <token> EVALUATION_START
+
 /** Non-terminals. */
-%type <constant> constant
 %type <expression> expression
-%type <factor> factor
 %type <program> program
 
+/** Non-terminals (evaluation-only). */
+%type <computation> computation
+%type <computation> evaluation
+
 /**
  * Precedence and associativity.
  *
@@ -65,21 +92,41 @@
 
 // IMPORTANT: To use λ in the following grammar, use the %empty symbol.
 
-program: expression													{ $$ = ExpressionProgramSemanticAction(currentCompilerState(), $1); }
+compilation: program												{ }
+	| EVALUATION_START evaluation									{ }
 	;
 
-expression: expression[left] ADD expression[right]					{ $$ = ArithmeticExpressionSemanticAction($left, $right, ADDITION); }
-	| expression[left] DIV expression[right]						{ $$ = ArithmeticExpressionSemanticAction($left, $right, DIVISION); }
-	| expression[left] MUL expression[right]						{ $$ = ArithmeticExpressionSemanticAction($left, $right, MULTIPLICATION); }
-	| expression[left] SUB expression[right]						{ $$ = ArithmeticExpressionSemanticAction($left, $right, SUBTRACTION); }
-	| factor														{ $$ = FactorExpressionSemanticAction($1); }
+program: expression													{ $$ = ExpressionProgramSemanticAction(compilerState, $1); }
 	;
 
-factor: OPEN_PARENTHESIS expression CLOSE_PARENTHESIS				{ $$ = ExpressionFactorSemanticAction($2); }
-	| constant														{ $$ = ConstantFactorSemanticAction($1); }
+expression: expression[left] ADD expression[right]					{ $$ = ArithmeticExpressionSemanticAction(compilerState, $left, $right, ADDITION); }
+	| expression[left] DIV expression[right]						{ $$ = ArithmeticExpressionSemanticAction(compilerState, $left, $right, DIVISION); }
+	| expression[left] MUL expression[right]						{ $$ = ArithmeticExpressionSemanticAction(compilerState, $left, $right, MULTIPLICATION); }
+	| expression[left] SUB expression[right]						{ $$ = ArithmeticExpressionSemanticAction(compilerState, $left, $right, SUBTRACTION); }
+	| OPEN_PARENTHESIS expression CLOSE_PARENTHESIS					{ $$ = ParenthesisExpressionSemanticAction(compilerState, $2); }
+	| INTEGER														{ $$ = IntegerConstantSemanticAction(compilerState, $1); }
+	| IDENTIFIER													{ $$ = IdentifierVariableSemanticAction(compilerState, $1); }
+	;
+
+/**
+ * Evaluation-only grammar. It recognizes the same language, but every
+ * non-terminal carries its computed value instead of a node of the AST, so
+ * the parser only needs memory for the nesting depth of the program. The
+ * values that don't fit in 64 bits and the names of the variables are the
+ * exception: they live in the arena until the end, so they add up with the
+ * length of the program.
+ */
+
+evaluation: computation												{ $$ = ComputationProgramSemanticAction(compilerState, $1); }
 	;
 
-constant: INTEGER													{ $$ = IntegerConstantSemanticAction($1); }
+computation: computation[left] ADD computation[right]				{ $$ = ArithmeticComputationSemanticAction(compilerState, $left, $right, ADDITION); }
+	| computation[left] DIV computation[right]						{ $$ = ArithmeticComputationSemanticAction(compilerState, $left, $right, DIVISION); }
+	| computation[left] MUL computation[right]						{ $$ = ArithmeticComputationSemanticAction(compilerState, $left, $right, MULTIPLICATION); }
+	| computation[left] SUB computation[right]						{ $$ = ArithmeticComputationSemanticAction(compilerState, $left, $right, SUBTRACTION); }
+	| OPEN_PARENTHESIS computation CLOSE_PARENTHESIS					{ $$ = ParenthesisComputationSemanticAction(compilerState, $2); }
+	| INTEGER														{ $$ = IntegerComputationSemanticAction(compilerState, $1); }
+	| IDENTIFIER													{ $$ = IdentifierComputationSemanticAction(compilerState, $1); }
 	;
 
 %%
@@ -0,0 +1,154 @@
+#include "NodeTable.h"
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _equalNodes(const Expression * left, const Expression * right);
+static boolean _growNodeTable(NodeTable * nodeTable);
+static uint32_t _hashNode(const Expression * expression);
+static uint64_t _mix(const uint64_t hash, const uint64_t word);
+
+/**
+ * Compares two nodes by their types, their parentheses, their values, and by
+ * the addresses of their children.
+ */
+static boolean _equalNodes(const Expression * left, const Expression * right) {
+	if (left->type != right->type || left->parentheses != right->parentheses) {
+		return false;
+	}
+	switch (left->type) {
+		case CONSTANT:
+			return equalIntegers(left->value, right->value);
+		case VARIABLE:
+			return strcmp(left->name, right->name) == 0;
+		default:
+			return left->leftExpression == right->leftExpression
+				&& left->rightExpression == right->rightExpression;
+	}
+}
+
+/**
+ * Doubles the capacity of the table, and moves every node into its new slot.
+ * Returns false if the system ran out of memory.
+ */
+static boolean _growNodeTable(NodeTable * nodeTable) {
+	const size_t capacity = 2 * nodeTable->capacity;
+	NodeTableEntry * entries = allocateZeroedMemory(capacity, sizeof(NodeTableEntry));
+	if (entries == NULL) {
+		return false;
+	}
+	for (size_t k = 0; k < nodeTable->capacity; ++k) {
+		if (nodeTable->entries[k].expression != NULL) {
+			size_t slot = nodeTable->entries[k].hash & (capacity - 1);
+			while (entries[slot].expression != NULL) {
+				slot = (slot + 1) & (capacity - 1);
+			}
+			entries[slot] = nodeTable->entries[k];
+		}
+	}
+	releaseMemory(nodeTable->entries);
+	nodeTable->entries = entries;
+	nodeTable->capacity = capacity;
+	return true;
+}
+
+/**
+ * Hashes a node by its type, its parentheses, its value, and the addresses
+ * of its children.
+ */
+static uint32_t _hashNode(const Expression * expression) {
+	uint64_t hash = _mix(_mix(0, expression->type), expression->parentheses);
+	switch (expression->type) {
+		case CONSTANT: {
+			const Integer value = expression->value;
+			if (value.big == NULL) {
+				hash = _mix(hash, (uint64_t) value.small);
+			}
+			else {
+				hash = _mix(hash, value.big->negative);
+				for (size_t k = 0; k < value.big->length; ++k) {
+					hash = _mix(hash, value.big->limbs[k]);
+				}
+			}
+			break;
+		}
+		case VARIABLE:
+			for (const char * character = expression->name; *character != '\0'; ++character) {
+				hash = _mix(hash, (unsigned char) *character);
+			}
+			break;
+		default:
+			hash = _mix(_mix(hash, (uintptr_t) expression->leftExpression), (uintptr_t) expression->rightExpression);
+			break;
+	}
+	return (uint32_t) (hash >> 32);
+}
+
+/**
+ * Mixes a word into a hash, with a multiplication by the golden ratio (so the
+ * high bits depend on every bit of the word).
+ */
+static uint64_t _mix(const uint64_t hash, const uint64_t word) {
+	return (((hash << 5) | (hash >> 59)) ^ word) * UINT64_C(0x9E3779B97F4A7C15);
+}
+
+/* PUBLIC FUNCTIONS */
+
+NodeTable * createNodeTable(const size_t initialCapacity) {
+	NodeTable * nodeTable = allocateZeroedMemory(1, sizeof(NodeTable));
+	if (nodeTable == NULL) {
+		return NULL;
+	}
+	// The capacity is a power of 2, so the slot of a hash is a mask.
+	nodeTable->capacity = 16;
+	while (nodeTable->capacity < 2 * initialCapacity) {
+		nodeTable->capacity *= 2;
+	}
+	nodeTable->entries = allocateZeroedMemory(nodeTable->capacity, sizeof(NodeTableEntry));
+	if (nodeTable->entries == NULL) {
+		releaseMemory(nodeTable);
+		return NULL;
+	}
+	return nodeTable;
+}
+
+void destroyNodeTable(NodeTable * nodeTable) {
+	if (nodeTable != NULL) {
+		releaseMemory(nodeTable->entries);
+		releaseMemory(nodeTable);
+	}
+}
+
+Expression * internExpression(NodeTable * nodeTable, Arena * arena, const Expression * expression) {
+	nodeTable->nodes += 1;
+	const uint32_t hash = _hashNode(expression);
+	size_t slot = hash & (nodeTable->capacity - 1);
+	for (; nodeTable->entries[slot].expression != NULL; slot = (slot + 1) & (nodeTable->capacity - 1)) {
+		const NodeTableEntry * entry = nodeTable->entries + slot;
+		if (entry->hash == hash && _equalNodes(entry->expression, expression)) {
+			entry->expression->shared = true;
+			nodeTable->sharedNodes += 1;
+			nodeTable->savedBytes += sizeof(Expression);
+			return entry->expression;
+		}
+	}
+	Expression * copy = allocateInArena(arena, sizeof(Expression));
+	if (copy == NULL) {
+		return NULL;
+	}
+	memcpy(copy, expression, sizeof(Expression));
+	// The load factor is kept below 1/2, so the probes are short.
+	if (2 * (nodeTable->length + 1) <= nodeTable->capacity || _growNodeTable(nodeTable)) {
+		slot = hash & (nodeTable->capacity - 1);
+		while (nodeTable->entries[slot].expression != NULL) {
+			slot = (slot + 1) & (nodeTable->capacity - 1);
+		}
+		nodeTable->entries[slot].expression = copy;
+		nodeTable->entries[slot].hash = hash;
+		nodeTable->length += 1;
+	}
+	return copy;
+}
+
+size_t nodeTableBytes(const NodeTable * nodeTable) {
+	return sizeof(NodeTable) + nodeTable->capacity * sizeof(NodeTableEntry);
+}
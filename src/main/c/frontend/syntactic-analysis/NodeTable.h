@@ -0,0 +1,65 @@
+#ifndef NODE_TABLE_HEADER
+#define NODE_TABLE_HEADER
+
+#include "../../shared/Arena.h"
+#include "../../shared/Integer.h"
+#include "../../shared/Memory.h"
+#include "../../shared/Type.h"
+#include "AbstractSyntaxTree.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A slot of the table: a node and its hash (or NULL, if empty).
+ */
+typedef struct {
+	Expression * expression;
+	uint32_t hash;
+} NodeTableEntry;
+
+/**
+ * A hash table of the nodes of an AST, keyed on their types, their values and
+ * the identities of their children, to share the identical subtrees (a.k.a.,
+ * hash-consing), so the AST becomes a DAG. Since the children are always
+ * shared before their parents, comparing them by address is enough. It's
+ * only needed while parsing: the nodes live in the arena.
+ */
+typedef struct {
+	NodeTableEntry * entries;
+	size_t capacity;
+	size_t length;
+
+	// The amount of nodes requested, of the ones that were shared instead of
+	// allocated, and the bytes that they would have taken in the arena.
+	size_t nodes;
+	size_t sharedNodes;
+	size_t savedBytes;
+} NodeTable;
+
+/**
+ * Creates a new empty table, with room for the specified amount of nodes
+ * before growing.
+ */
+NodeTable * createNodeTable(const size_t initialCapacity);
+
+/**
+ * Destroy a table and its resources (but not the nodes).
+ */
+void destroyNodeTable(NodeTable * nodeTable);
+
+/**
+ * Returns the node identical to the specified one (i.e., a local copy that
+ * was never shared), if there's one in the table. Otherwise, it copies the
+ * node into the arena, adds it to the table, and returns it. The nodes
+ * returned more than once are marked as shared. Returns NULL if the arena
+ * ran out of memory (but if the table can't grow, the node is not shared).
+ */
+Expression * internExpression(NodeTable * nodeTable, Arena * arena, const Expression * expression);
+
+/**
+ * The memory reserved by the table, in bytes.
+ */
+size_t nodeTableBytes(const NodeTable * nodeTable);
+
+#endif
@@ -1,12 +1,33 @@
 #include "SyntacticAnalyzer.h"
 #include "../lexical-analysis/LexicalAnalyzerContext.h"
+#include "../lexical-analysis/FlexActions.h"
+#include "TokenRing.h"
+#include <pthread.h>
+
+/** IMPORTED FUNCTIONS */
+
+extern int flexLex(union SemanticValue * semanticValue, void * scanner);
+extern void flexScanBuffer(void * scanner, char * bytes, const size_t length);
+extern void flexScanBytes(void * scanner, const char * bytes, const size_t length);
+extern void flexScanStream(void * scanner, FILE * stream);
+extern int yyget_lineno(void * scanner);
+extern int yylex_destroy(void * scanner);
+extern int yylex_init_extra(LexicalAnalyzerContext * lexicalAnalyzerContext, void ** scanner);
 
 /* MODULE INTERNAL STATE */
 
-static CompilerState * _currentCompilerState = NULL;
+/**
+ * The amount of tokens that the lexer thread can scan ahead of the parser.
+ */
+static const size_t _tokenRingCapacity = 4096;
+
+static boolean _hashConsing = true;
 static Logger * _logger = NULL;
+static boolean _pipelinedFrontend = false;
 
 void initializeSyntacticAnalyzerModule() {
+	_hashConsing = getBooleanOrDefault("HASH_CONSING", true);
+	_pipelinedFrontend = getBooleanOrDefault("PIPELINED_FRONTEND", false);
 	_logger = createLogger("SyntacticAnalyzer");
 }
 
@@ -16,9 +37,50 @@ void shutdownSyntacticAnalyzerModule() {
 	}
 }
 
-/** IMPORTED FUNCTIONS */
+/* PRIVATE FUNCTIONS */
 
-extern LexicalAnalyzerContext * createLexicalAnalyzerContext();
+static void _countToken(TokenCounters * tokenCounters, const int token);
+static void _reportNodeTable(const NodeTable * nodeTable, Telemetry * telemetry);
+static void * _scanAhead(void * argument);
+static boolean _startLexerThread(CompilerState * compilerState, pthread_t * lexerThread);
+
+/**
+ * Counts a token by kind (the artificial start token, and the end of the
+ * input, are not counted).
+ */
+static void _countToken(TokenCounters * tokenCounters, const int token) {
+	switch (token) {
+		case ADD:
+			tokenCounters->additions += 1;
+			break;
+		case CLOSE_PARENTHESIS:
+			tokenCounters->closeParentheses += 1;
+			break;
+		case DIV:
+			tokenCounters->divisions += 1;
+			break;
+		case IDENTIFIER:
+			tokenCounters->identifiers += 1;
+			break;
+		case INTEGER:
+			tokenCounters->integers += 1;
+			break;
+		case MUL:
+			tokenCounters->multiplications += 1;
+			break;
+		case OPEN_PARENTHESIS:
+			tokenCounters->openParentheses += 1;
+			break;
+		case SUB:
+			tokenCounters->subtractions += 1;
+			break;
+		case UNKNOWN:
+			tokenCounters->unknowns += 1;
+			break;
+		default:
+			break;
+	}
+}
 
 /**
  * Bison exported functions.
@@ -31,25 +93,136 @@ extern LexicalAnalyzerContext * createLexicalAnalyzerContext();
  *
  * @see https://www.gnu.org/software/bison/manual/html_node/Parser-Function.html
  */
-extern int yyparse(void);
+extern int yyparse(CompilerState * compilerState);
+
+// Bison lexical-analyzer function (forwards to the scanner of the compilation,
+// or pops the tokens already scanned by its lexer thread, and counts them if
+// the compilation is measured).
+int yylex(union SemanticValue * semanticValue, CompilerState * compilerState) {
+	Token token;
+	if (compilerState->tokenRing == NULL) {
+		token = flexLex(semanticValue, compilerState->scanner);
+	}
+	else {
+		RingToken ringToken;
+		popToken(compilerState->tokenRing, &ringToken);
+		*semanticValue = ringToken.semanticValue;
+		token = ringToken.token;
+	}
+	if (compilerState->telemetry != NULL) {
+		_countToken(&compilerState->telemetry->tokens, token);
+	}
+	return token;
+}
 
 // Bison error-reporting function.
-void yyerror(const char * string) {
-	LexicalAnalyzerContext * lexicalAnalyzerContext = createLexicalAnalyzerContext();
-	logError(_logger, "Syntax error (on line %d).", lexicalAnalyzerContext->line);
+void yyerror(CompilerState * compilerState, const char * string) {
+	// The scanner of a lexer thread is already ahead of the parser.
+	const TokenRing * tokenRing = compilerState->tokenRing;
+	const int line = tokenRing == NULL ? yyget_lineno(compilerState->scanner) : (int) tokenRing->line;
+	logError(_logger, "Syntax error (on line %d): %s.", line, string);
 }
 
-/* PUBLIC FUNCTIONS */
+/**
+ * Reports the nodes shared by the table, and the memory saved.
+ */
+static void _reportNodeTable(const NodeTable * nodeTable, Telemetry * telemetry) {
+	logDebugging(_logger, "Hash-consing shared %zu of %zu nodes, saving %zu bytes (the table took %zu bytes).",
+		nodeTable->sharedNodes, nodeTable->nodes, nodeTable->savedBytes, nodeTableBytes(nodeTable));
+	if (telemetry != NULL) {
+		telemetry->hashConsing.nodes += nodeTable->nodes;
+		telemetry->hashConsing.sharedNodes += nodeTable->sharedNodes;
+		telemetry->hashConsing.savedBytes += nodeTable->savedBytes;
+		if (telemetry->hashConsing.tableBytes < nodeTableBytes(nodeTable)) {
+			telemetry->hashConsing.tableBytes = nodeTableBytes(nodeTable);
+		}
+	}
+}
 
-CompilerState * currentCompilerState() {
-	return _currentCompilerState;
+/**
+ * The body of a lexer thread: scans the whole input of the compilation, and
+ * pushes every token into the ring (the end of the input too, which is the
+ * last one), unless the parser stops popping them.
+ */
+static void * _scanAhead(void * argument) {
+	CompilerState * compilerState = argument;
+	RingToken ringToken;
+	do {
+		ringToken.token = flexLex(&ringToken.semanticValue, compilerState->scanner);
+		ringToken.line = (unsigned int) yyget_lineno(compilerState->scanner);
+	} while (pushToken(compilerState->tokenRing, &ringToken) && ringToken.token != 0);
+	return NULL;
 }
 
+/**
+ * Starts a thread that scans the input of the compilation ahead of the
+ * parser. Returns false if it cannot be started, so the scanner must be used
+ * by the parser itself.
+ */
+static boolean _startLexerThread(CompilerState * compilerState, pthread_t * lexerThread) {
+	compilerState->tokenRing = createTokenRing(_tokenRingCapacity);
+	if (compilerState->tokenRing != NULL && pthread_create(lexerThread, NULL, _scanAhead, compilerState) == 0) {
+		return true;
+	}
+	logWarning(_logger, "The lexer thread cannot be started, so the input is scanned by the parser.");
+	destroyTokenRing(compilerState->tokenRing);
+	compilerState->tokenRing = NULL;
+	return false;
+}
+
+/* PUBLIC FUNCTIONS */
+
 SyntacticAnalysisStatus parse(CompilerState * compilerState) {
 	logDebugging(_logger, "Parsing...");
-	_currentCompilerState = compilerState;
-	const int code = yyparse();
-	_currentCompilerState = NULL;
+	// A lexer thread allocates in an arena of its own (the arena of the
+	// compilation belongs to the parser), which joins it after the parse.
+	Arena * lexerArena = _pipelinedFrontend ? createArena(ARENA_DEFAULT_BLOCK_SIZE) : NULL;
+	LexicalAnalyzerContext lexicalAnalyzerContext = {
+		.arena = lexerArena == NULL ? compilerState->arena : lexerArena,
+		.compilerState = compilerState,
+		.startToken = compilerState->mode == GENERATION_MODE ? 0 : EVALUATION_START
+	};
+	if (yylex_init_extra(&lexicalAnalyzerContext, &compilerState->scanner) != 0) {
+		logError(_logger, "The lexical-analyzer cannot be created.");
+		destroyArena(lexerArena);
+		compilerState->succeed = false;
+		return OUT_OF_MEMORY;
+	}
+	if (compilerState->source != NULL && compilerState->scanInPlace) {
+		flexScanBuffer(compilerState->scanner, (char *) compilerState->source, compilerState->sourceLength + 2);
+	}
+	else if (compilerState->source != NULL) {
+		flexScanBytes(compilerState->scanner, compilerState->source, compilerState->sourceLength);
+	}
+	else {
+		flexScanStream(compilerState->scanner, compilerState->input == NULL ? stdin : compilerState->input);
+	}
+	// Only the AST has nodes to share.
+	if (_hashConsing && compilerState->mode == GENERATION_MODE) {
+		compilerState->nodeTable = createNodeTable(1024);
+	}
+	pthread_t lexerThread;
+	if (lexerArena != NULL && !_startLexerThread(compilerState, &lexerThread)) {
+		lexicalAnalyzerContext.arena = compilerState->arena;
+	}
+	const int code = yyparse(compilerState);
+	if (compilerState->tokenRing != NULL) {
+		closeTokenRing(compilerState->tokenRing);
+		pthread_join(lexerThread, NULL);
+		destroyTokenRing(compilerState->tokenRing);
+		compilerState->tokenRing = NULL;
+	}
+	if (lexerArena != NULL) {
+		mergeArena(compilerState->arena, lexerArena);
+		destroyArena(lexerArena);
+	}
+	yylex_destroy(compilerState->scanner);
+	compilerState->scanner = NULL;
+	if (compilerState->nodeTable != NULL) {
+		_reportNodeTable(compilerState->nodeTable, compilerState->telemetry);
+		destroyNodeTable(compilerState->nodeTable);
+		compilerState->nodeTable = NULL;
+	}
 	SyntacticAnalysisStatus syntacticAnalysisStatus;
 	logDebugging(_logger, "Parsing is done.");
 	switch (code) {
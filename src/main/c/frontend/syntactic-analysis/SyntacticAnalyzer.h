@@ -2,12 +2,17 @@
 #define SYNTACTIC_ANALYZER_HEADER
 
 #include "../../shared/CompilerState.h"
+#include "../../shared/Environment.h"
 #include "../../shared/Logger.h"
+#include "../../shared/Telemetry.h"
+#include "NodeTable.h"
 
 /** Bison imported functions. */
 
-int yylex(void);
-void yyerror(const char * string);
+union SemanticValue;
+
+int yylex(union SemanticValue * semanticValue, CompilerState * compilerState);
+void yyerror(CompilerState * compilerState, const char * string);
 
 /** Initialize module's internal state. */
 void initializeSyntacticAnalyzerModule();
@@ -23,14 +28,9 @@ typedef enum {
 } SyntacticAnalysisStatus;
 
 /**
- * Retrieves the current compiler state. The state must be accessed during the
- * parsing phase (i.e., during a call to the "parse" function). Outside of the
- * parse, the state is set to NULL.
- */
-CompilerState * currentCompilerState();
-
-/**
- * Executes the parsing phase of the compiler.
+ * Executes the parsing phase of the compiler over the program of the compiler
+ * state, with a new scanner. The parse is reentrant: it doesn't use global
+ * state, so different threads can parse their own programs concurrently.
  */
 SyntacticAnalysisStatus parse(CompilerState * compilerState);
 
@@ -0,0 +1,93 @@
+#include "TokenRing.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * How many times an end spins over the index of the other, before yielding
+ * the processor (e.g., when both threads share a single core).
+ */
+static const unsigned int _spins = 128;
+
+/* PRIVATE FUNCTIONS */
+
+static void _wait(const unsigned int attempt);
+
+/**
+ * Waits a little before reading the index of the other end again: first with
+ * a hint that the thread is spinning, and later yielding the processor.
+ */
+static void _wait(const unsigned int attempt) {
+	if (attempt < _spins) {
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#endif
+	}
+	else {
+		sched_yield();
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+TokenRing * createTokenRing(const size_t capacity) {
+	size_t roundedCapacity = 2;
+	while (roundedCapacity < capacity) {
+		roundedCapacity *= 2;
+	}
+	void * ring = NULL;
+	TokenRing * tokenRing = posix_memalign(&ring, TOKEN_RING_CACHE_LINE, sizeof(TokenRing)) == 0 ? ring : NULL;
+	RingToken * tokens = allocateMemory(roundedCapacity * sizeof(RingToken));
+	if (tokenRing == NULL || tokens == NULL) {
+		free(tokenRing);
+		releaseMemory(tokens);
+		return NULL;
+	}
+	memset(tokenRing, 0, sizeof(TokenRing));
+	atomic_init(&tokenRing->head, 0);
+	atomic_init(&tokenRing->tail, 0);
+	atomic_init(&tokenRing->closed, false);
+	tokenRing->mask = roundedCapacity - 1;
+	tokenRing->tokens = tokens;
+	return tokenRing;
+}
+
+void destroyTokenRing(TokenRing * tokenRing) {
+	if (tokenRing != NULL) {
+		releaseMemory(tokenRing->tokens);
+		// Allocated by "posix_memalign", outside of the tracked memory.
+		free(tokenRing);
+	}
+}
+
+void closeTokenRing(TokenRing * tokenRing) {
+	atomic_store_explicit(&tokenRing->closed, true, memory_order_release);
+}
+
+void popToken(TokenRing * tokenRing, RingToken * ringToken) {
+	const size_t head = atomic_load_explicit(&tokenRing->head, memory_order_relaxed);
+	for (unsigned int attempt = 0; head == tokenRing->cachedTail; ++attempt) {
+		tokenRing->cachedTail = atomic_load_explicit(&tokenRing->tail, memory_order_acquire);
+		if (head == tokenRing->cachedTail) {
+			_wait(attempt);
+		}
+	}
+	*ringToken = tokenRing->tokens[head & tokenRing->mask];
+	tokenRing->line = ringToken->line;
+	atomic_store_explicit(&tokenRing->head, head + 1, memory_order_release);
+}
+
+boolean pushToken(TokenRing * tokenRing, const RingToken * ringToken) {
+	const size_t tail = atomic_load_explicit(&tokenRing->tail, memory_order_relaxed);
+	for (unsigned int attempt = 0; tokenRing->mask < tail - tokenRing->cachedHead; ++attempt) {
+		if (atomic_load_explicit(&tokenRing->closed, memory_order_acquire)) {
+			return false;
+		}
+		tokenRing->cachedHead = atomic_load_explicit(&tokenRing->head, memory_order_acquire);
+		if (tokenRing->mask < tail - tokenRing->cachedHead) {
+			_wait(attempt);
+		}
+	}
+	tokenRing->tokens[tail & tokenRing->mask] = *ringToken;
+	atomic_store_explicit(&tokenRing->tail, tail + 1, memory_order_release);
+	return true;
+}
@@ -0,0 +1,92 @@
+#ifndef TOKEN_RING_HEADER
+#define TOKEN_RING_HEADER
+
+#include "../../shared/Memory.h"
+#include "../../shared/Type.h"
+#include "BisonActions.h"
+#include "BisonParser.h"
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The size of a cache line, in bytes. The indices of both ends of a ring
+ * live in different lines, so each thread only writes its own.
+ */
+#define TOKEN_RING_CACHE_LINE 64
+
+/**
+ * A token already scanned, with everything the parser needs from it: its
+ * kind, its semantic value (e.g., the value of an integer, or the name of an
+ * identifier, which lives in an arena), and the line where it was found.
+ */
+typedef struct {
+	union SemanticValue semanticValue;
+	Token token;
+	unsigned int line;
+} RingToken;
+
+/**
+ * A bounded queue of tokens between exactly one producer (the lexer thread)
+ * and one consumer (the parser thread), without locks: each end only writes
+ * its own index, and publishes it with release semantics, so the other end
+ * sees the tokens before the index that covers them. Each end also keeps a
+ * private copy of the index of the other, and only reads the shared one when
+ * the copy says that the ring is full (or empty), so both threads don't
+ * contend for the same cache line on every token. An end that waits spins
+ * for a while, and then yields the processor.
+ */
+typedef struct {
+	// The next token to pop, and what the consumer knows of the tail.
+	_Alignas(TOKEN_RING_CACHE_LINE) atomic_size_t head;
+	size_t cachedTail;
+
+	// The line of the last token popped (only for the consumer).
+	unsigned int line;
+
+	// The next slot to push into, and what the producer knows of the head.
+	_Alignas(TOKEN_RING_CACHE_LINE) atomic_size_t tail;
+	size_t cachedHead;
+
+	// If true, the consumer stopped popping, so the producer must stop too.
+	_Alignas(TOKEN_RING_CACHE_LINE) atomic_bool closed;
+
+	// The capacity of the ring minus one (the capacity is a power of 2).
+	size_t mask;
+
+	RingToken * tokens;
+} TokenRing;
+
+/**
+ * Creates an empty ring with room for the specified amount of tokens (rounded
+ * up to a power of 2). Returns NULL if there is no memory left.
+ */
+TokenRing * createTokenRing(const size_t capacity);
+
+/**
+ * Destroys a ring, and the tokens it still holds.
+ */
+void destroyTokenRing(TokenRing * tokenRing);
+
+/**
+ * Signals the producer that the consumer will not pop any other token (e.g.,
+ * because the parser found a syntax error before the end of the input). Only
+ * for the consumer.
+ */
+void closeTokenRing(TokenRing * tokenRing);
+
+/**
+ * Removes the oldest token of the ring, waiting for it if the ring is empty.
+ * Only for the consumer.
+ */
+void popToken(TokenRing * tokenRing, RingToken * ringToken);
+
+/**
+ * Appends a token to the ring, waiting for room if it's full. Returns false
+ * if the consumer closed the ring, so the token will never be popped. Only
+ * for the producer.
+ */
+boolean pushToken(TokenRing * tokenRing, const RingToken * ringToken);
+
+#endif
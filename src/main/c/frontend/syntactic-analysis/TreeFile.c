@@ -0,0 +1,464 @@
+#include "TreeFile.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * The first bytes of every tree file, and a number whose bytes reveal the
+ * byte order of the compiler that wrote it.
+ */
+static const char _magic[8] = "CALCAST";
+static const uint32_t _byteOrder = 0x01020304;
+
+/**
+ * The sizes that a tree file must record, in the order of its header.
+ */
+static const uint16_t _sizes[4] = {
+	sizeof(void *),
+	sizeof(Integer),
+	sizeof(BigInteger),
+	sizeof(Expression)
+};
+
+/**
+ * Every node (and the Program) starts at a multiple of this alignment.
+ */
+static const size_t _alignment = 8;
+
+static Logger * _logger = NULL;
+
+void initializeTreeFileModule() {
+	_logger = createLogger("TreeFile");
+}
+
+void shutdownTreeFileModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PRIVATE FUNCTIONS */
+
+/**
+ * A pending node while the tree is written. A node is expanded once its
+ * children are pending too, so it's written after them.
+ */
+typedef struct {
+	const Expression * expression;
+	boolean expanded;
+} TreeStep;
+
+/**
+ * The nodes already written, and their offsets, in an open-addressing hash
+ * table keyed on their addresses (so a shared node is written once).
+ */
+typedef struct {
+	const void * node;
+	uint64_t offset;
+} WrittenNode;
+
+typedef struct {
+	Writer * writer;
+
+	// The offsets of the pointers written (as uint64_t).
+	Stack * relocations;
+
+	WrittenNode * writtenNodes;
+	size_t capacity;
+	size_t length;
+
+	// If false, the system ran out of memory.
+	boolean succeed;
+} TreeWriter;
+
+static boolean _findNode(const TreeWriter * treeWriter, const void * node, uint64_t * offset);
+static void _invalid(const char * path, const char * reason);
+static boolean _isBefore(const char * bytes, const void * pointer, const size_t length, const void * holder);
+static void _keepNode(TreeWriter * treeWriter, const void * node, const uint64_t offset);
+static uint64_t _nextOffset(const TreeWriter * treeWriter);
+static size_t _nodeSlot(const WrittenNode * writtenNodes, const size_t capacity, const void * node);
+static void * _offsetOf(TreeWriter * treeWriter, const uint64_t nodeOffset, const size_t fieldOffset, const void * child);
+static boolean _pushStep(TreeWriter * treeWriter, Stack * steps, const Expression * expression, const boolean expanded);
+static Program * _relocate(MappedFile * mappedFile, const char * path);
+static boolean _validate(const char * bytes, const uint64_t end, const Program * program, const char * path);
+static uint64_t _writeAligned(TreeWriter * treeWriter, const void * bytes, const size_t length);
+static void _writeExpression(TreeWriter * treeWriter, const Expression * expression);
+
+/**
+ * Finds the offset of a node already written. Returns false if it was not
+ * written yet.
+ */
+static boolean _findNode(const TreeWriter * treeWriter, const void * node, uint64_t * offset) {
+	if (treeWriter->length == 0) {
+		return false;
+	}
+	const WrittenNode * writtenNode = treeWriter->writtenNodes + _nodeSlot(treeWriter->writtenNodes, treeWriter->capacity, node);
+	if (writtenNode->node == NULL) {
+		return false;
+	}
+	*offset = writtenNode->offset;
+	return true;
+}
+
+/**
+ * Logs the reason why a tree file cannot be loaded.
+ */
+static void _invalid(const char * path, const char * reason) {
+	logError(_logger, "The tree file \"%s\" cannot be loaded: %s.", path, reason);
+}
+
+/**
+ * Returns true if a pointer of a loaded node (or of the program) refers to an
+ * aligned range of the specified length, after the header and before the
+ * node that holds it. Since every node is written after the ones it refers
+ * to, any other pointer is corrupted, lacks its relocation, or forms a cycle.
+ */
+static boolean _isBefore(const char * bytes, const void * pointer, const size_t length, const void * holder) {
+	const uintptr_t address = (uintptr_t) pointer;
+	return (uintptr_t) bytes + sizeof(TreeFileHeader) <= address && address % _alignment == 0
+		&& address < (uintptr_t) holder && length <= (uintptr_t) holder - address;
+}
+
+/**
+ * Keeps the offset of a node just written. If the table can't grow, the
+ * writing fails.
+ */
+static void _keepNode(TreeWriter * treeWriter, const void * node, const uint64_t offset) {
+	if (treeWriter->capacity <= 2 * (treeWriter->length + 1)) {
+		const size_t capacity = treeWriter->capacity == 0 ? 1024 : 2 * treeWriter->capacity;
+		WrittenNode * writtenNodes = allocateZeroedMemory(capacity, sizeof(WrittenNode));
+		if (writtenNodes == NULL) {
+			treeWriter->succeed = false;
+			return;
+		}
+		for (size_t k = 0; k < treeWriter->capacity; ++k) {
+			if (treeWriter->writtenNodes[k].node != NULL) {
+				writtenNodes[_nodeSlot(writtenNodes, capacity, treeWriter->writtenNodes[k].node)] = treeWriter->writtenNodes[k];
+			}
+		}
+		releaseMemory(treeWriter->writtenNodes);
+		treeWriter->writtenNodes = writtenNodes;
+		treeWriter->capacity = capacity;
+	}
+	WrittenNode * writtenNode = treeWriter->writtenNodes + _nodeSlot(treeWriter->writtenNodes, treeWriter->capacity, node);
+	writtenNode->node = node;
+	writtenNode->offset = offset;
+	treeWriter->length += 1;
+}
+
+/**
+ * Returns the offset where the next aligned write begins.
+ */
+static uint64_t _nextOffset(const TreeWriter * treeWriter) {
+	const size_t writtenBytes = treeWriter->writer->writtenBytes;
+	return writtenBytes + (_alignment - writtenBytes % _alignment) % _alignment;
+}
+
+/**
+ * Returns the slot of a node in the table (which is not full), or of the
+ * empty one where it should be.
+ */
+static size_t _nodeSlot(const WrittenNode * writtenNodes, const size_t capacity, const void * node) {
+	size_t slot = (size_t) (((uintptr_t) node * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & (capacity - 1);
+	while (writtenNodes[slot].node != NULL && writtenNodes[slot].node != node) {
+		slot = (slot + 1) & (capacity - 1);
+	}
+	return slot;
+}
+
+/**
+ * Returns the pointer to store in a field of a node about to be written:
+ * the offset of its child (already written), and keeps the offset of the
+ * field as a relocation. A NULL child stays NULL, without relocation.
+ */
+static void * _offsetOf(TreeWriter * treeWriter, const uint64_t nodeOffset, const size_t fieldOffset, const void * child) {
+	uint64_t offset = 0;
+	if (child == NULL || !_findNode(treeWriter, child, &offset)) {
+		return NULL;
+	}
+	const uint64_t relocation = nodeOffset + fieldOffset;
+	if (!pushStack(treeWriter->relocations, &relocation)) {
+		treeWriter->succeed = false;
+	}
+	return (void *) (uintptr_t) offset;
+}
+
+/**
+ * Pushes a new pending node (only while the writing succeeds). Returns false
+ * if the stack couldn't grow.
+ */
+static boolean _pushStep(TreeWriter * treeWriter, Stack * steps, const Expression * expression, const boolean expanded) {
+	TreeStep step = {
+		.expanded = expanded,
+		.expression = expression
+	};
+	treeWriter->succeed = treeWriter->succeed && pushStack(steps, &step);
+	return treeWriter->succeed;
+}
+
+/**
+ * Validates a mapped tree file, turns every offset stored in a pointer into
+ * an address inside the mapping, and validates the nodes reachable from the
+ * root. Returns the root of the AST, or NULL if the file is not valid.
+ */
+static Program * _relocate(MappedFile * mappedFile, const char * path) {
+	char * bytes = mappedFile->bytes;
+	const size_t length = mappedFile->length;
+	if (length < sizeof(TreeFileHeader) + sizeof(TreeFileTrailer) || length % _alignment != 0) {
+		_invalid(path, "it's truncated");
+		return NULL;
+	}
+	TreeFileHeader header;
+	memcpy(&header, bytes, sizeof(TreeFileHeader));
+	if (memcmp(header.magic, _magic, sizeof(_magic)) != 0) {
+		_invalid(path, "it's not a tree file");
+		return NULL;
+	}
+	if (header.version != TREE_FILE_VERSION || header.byteOrder != _byteOrder || memcmp(header.sizes, _sizes, sizeof(_sizes)) != 0) {
+		_invalid(path, "it was written by an incompatible compiler");
+		return NULL;
+	}
+	TreeFileTrailer trailer;
+	memcpy(&trailer, bytes + length - sizeof(TreeFileTrailer), sizeof(TreeFileTrailer));
+	// The nodes end where the relocations begin, and these end at the trailer.
+	const uint64_t end = trailer.relocations;
+	const uint64_t relocationsLength = length - sizeof(TreeFileTrailer) - end;
+	if (end < sizeof(TreeFileHeader) || length - sizeof(TreeFileTrailer) < end
+		|| end % _alignment != 0 || relocationsLength / sizeof(uint64_t) != trailer.relocationsCount
+		|| relocationsLength % sizeof(uint64_t) != 0
+		|| trailer.program < sizeof(TreeFileHeader) || end < trailer.program || end - trailer.program < sizeof(Program)
+		|| trailer.program % _alignment != 0) {
+		_invalid(path, "its trailer is corrupted");
+		return NULL;
+	}
+	for (uint64_t k = 0; k < trailer.relocationsCount; ++k) {
+		uint64_t relocation;
+		memcpy(&relocation, bytes + end + k * sizeof(uint64_t), sizeof(uint64_t));
+		if (relocation < sizeof(TreeFileHeader) || end < relocation || end - relocation < sizeof(void *) || relocation % sizeof(void *) != 0) {
+			_invalid(path, "a relocation is out of bounds");
+			return NULL;
+		}
+		uintptr_t * pointer = (uintptr_t *) (bytes + relocation);
+		if (*pointer < sizeof(TreeFileHeader) || end <= *pointer || *pointer % _alignment != 0) {
+			_invalid(path, "a pointer is out of bounds");
+			return NULL;
+		}
+		*pointer += (uintptr_t) bytes;
+	}
+	Program * program = (Program *) (bytes + trailer.program);
+	return _validate(bytes, end, program, path) ? program : NULL;
+}
+
+/**
+ * Visits every node reachable from the root of a relocated tree file once,
+ * and verifies that its type is known, that its pointers were relocated
+ * (and refer to nodes written before it), and that its payload (the limbs of
+ * a big constant, or the name of a variable) ends before it. Returns false
+ * if a node is not valid.
+ */
+static boolean _validate(const char * bytes, const uint64_t end, const Program * program, const char * path) {
+	// A bit per aligned offset, set once its node is verified.
+	uint8_t * visited = allocateZeroedMemory(end / _alignment / 8 + 1, sizeof(uint8_t));
+	Stack * pending = createStack(sizeof(const Expression *), 64);
+	const char * reason = visited == NULL || pending == NULL ? "there is no memory left" : NULL;
+	if (reason == NULL && !_isBefore(bytes, program->expression, sizeof(Expression), program)) {
+		reason = "its root is out of bounds";
+	}
+	else if (reason == NULL && !pushStack(pending, &program->expression)) {
+		reason = "there is no memory left";
+	}
+	while (reason == NULL && !isEmptyStack(pending)) {
+		const Expression * expression;
+		popStack(pending, &expression);
+		const size_t slot = (size_t) ((const char *) expression - bytes) / _alignment;
+		if (visited[slot / 8] & (1 << (slot % 8))) {
+			continue;
+		}
+		visited[slot / 8] |= (uint8_t) (1 << (slot % 8));
+		const BigInteger * big = NULL;
+		switch (expression->type) {
+			case ADDITION:
+			case DIVISION:
+			case MULTIPLICATION:
+			case SUBTRACTION:
+				if (!_isBefore(bytes, expression->leftExpression, sizeof(Expression), expression)
+					|| !_isBefore(bytes, expression->rightExpression, sizeof(Expression), expression)) {
+					reason = "an expression refers to an invalid operand";
+				}
+				else if (!pushStack(pending, &expression->rightExpression) || !pushStack(pending, &expression->leftExpression)) {
+					reason = "there is no memory left";
+				}
+				break;
+			case CONSTANT:
+				big = expression->value.big;
+				if (big != NULL && (!_isBefore(bytes, big, sizeof(BigInteger), expression) || big->length == 0
+					|| (size_t) ((const char *) expression - (const char *) big->limbs) / sizeof(uint32_t) < big->length)) {
+					reason = "a constant is out of bounds";
+				}
+				break;
+			case VARIABLE:
+				if (!_isBefore(bytes, expression->name, 1, expression)
+					|| memchr(expression->name, '\0', (size_t) ((const char *) expression - expression->name)) == NULL) {
+					reason = "a variable name is out of bounds";
+				}
+				break;
+			default:
+				reason = "a node has an unknown type";
+				break;
+		}
+	}
+	if (reason != NULL) {
+		_invalid(path, reason);
+	}
+	if (pending != NULL) {
+		destroyStack(pending);
+	}
+	releaseMemory(visited);
+	return reason == NULL;
+}
+
+/**
+ * Writes a sequence of bytes at the next aligned offset. Returns that offset.
+ */
+static uint64_t _writeAligned(TreeWriter * treeWriter, const void * bytes, const size_t length) {
+	static const char padding[8] = { 0 };
+	const uint64_t offset = _nextOffset(treeWriter);
+	writeBytes(treeWriter->writer, padding, offset - treeWriter->writer->writtenBytes);
+	writeBytes(treeWriter->writer, (const char *) bytes, length);
+	return offset;
+}
+
+/**
+ * Writes a node, whose children were already written, and keeps its offset.
+ * The node is copied field by field, so its padding is always zero, and the
+ * pointers become the offsets of the children. The digits of a big constant
+ * and the name of a variable are written right before their nodes.
+ */
+static void _writeExpression(TreeWriter * treeWriter, const Expression * expression) {
+	uint64_t offset = 0;
+	const BigInteger * big = expression->type == CONSTANT ? expression->value.big : NULL;
+	if (big != NULL && !_findNode(treeWriter, big, &offset)) {
+		BigInteger bigCopy;
+		memset(&bigCopy, 0, sizeof(BigInteger));
+		bigCopy.length = big->length;
+		bigCopy.negative = big->negative;
+		_keepNode(treeWriter, big, _writeAligned(treeWriter, &bigCopy, sizeof(BigInteger)));
+		writeBytes(treeWriter->writer, (const char *) big->limbs, big->length * sizeof(uint32_t));
+	}
+	if (expression->type == VARIABLE && !_findNode(treeWriter, expression->name, &offset)) {
+		_keepNode(treeWriter, expression->name, _writeAligned(treeWriter, expression->name, strlen(expression->name) + 1));
+	}
+	offset = _nextOffset(treeWriter);
+	Expression copy;
+	memset(&copy, 0, sizeof(Expression));
+	switch (expression->type) {
+		case CONSTANT:
+			copy.value.big = _offsetOf(treeWriter, offset, offsetof(Expression, value) + offsetof(Integer, big), big);
+			copy.value.small = expression->value.small;
+			break;
+		case VARIABLE:
+			copy.name = _offsetOf(treeWriter, offset, offsetof(Expression, name), expression->name);
+			break;
+		default:
+			copy.leftExpression = _offsetOf(treeWriter, offset, offsetof(Expression, leftExpression), expression->leftExpression);
+			copy.rightExpression = _offsetOf(treeWriter, offset, offsetof(Expression, rightExpression), expression->rightExpression);
+			break;
+	}
+	copy.parentheses = expression->parentheses;
+	copy.shared = expression->shared;
+	copy.type = expression->type;
+	_writeAligned(treeWriter, &copy, sizeof(Expression));
+	_keepNode(treeWriter, expression, offset);
+}
+
+/* PUBLIC FUNCTIONS */
+
+TreeFile * createTreeFile(const char * path) {
+	MappedFile * mappedFile = createMappedFile(path);
+	if (mappedFile == NULL) {
+		_invalid(path, strerror(errno));
+		return NULL;
+	}
+	Program * program = _relocate(mappedFile, path);
+	TreeFile * treeFile = program == NULL ? NULL : allocateZeroedMemory(1, sizeof(TreeFile));
+	if (treeFile == NULL) {
+		if (program != NULL) {
+			_invalid(path, "there is no memory left");
+		}
+		destroyMappedFile(mappedFile);
+		return NULL;
+	}
+	treeFile->mappedFile = mappedFile;
+	treeFile->program = program;
+	return treeFile;
+}
+
+void destroyTreeFile(TreeFile * treeFile) {
+	if (treeFile != NULL) {
+		destroyMappedFile(treeFile->mappedFile);
+		releaseMemory(treeFile);
+	}
+}
+
+boolean writeTreeFile(FILE * stream, const Program * program) {
+	TreeWriter treeWriter = {
+		.capacity = 0,
+		.length = 0,
+		.relocations = createStack(sizeof(uint64_t), 1024),
+		.succeed = true,
+		.writer = createWriter(stream, WRITER_DEFAULT_CAPACITY, false),
+		.writtenNodes = NULL
+	};
+	Stack * steps = createStack(sizeof(TreeStep), 64);
+	TreeFileHeader header;
+	memset(&header, 0, sizeof(TreeFileHeader));
+	memcpy(header.magic, _magic, sizeof(_magic));
+	header.version = TREE_FILE_VERSION;
+	header.byteOrder = _byteOrder;
+	memcpy(header.sizes, _sizes, sizeof(_sizes));
+	writeBytes(treeWriter.writer, (const char *) &header, sizeof(TreeFileHeader));
+
+	// The nodes are written in post-order, so every pointer refers to a node
+	// already written (i.e., to a known offset).
+	_pushStep(&treeWriter, steps, program->expression, false);
+	while (treeWriter.succeed && !isEmptyStack(steps)) {
+		TreeStep step;
+		popStack(steps, &step);
+		uint64_t offset;
+		if (_findNode(&treeWriter, step.expression, &offset)) {
+			continue;
+		}
+		const Expression * expression = step.expression;
+		if (!step.expanded && expression->type != CONSTANT && expression->type != VARIABLE) {
+			if (_pushStep(&treeWriter, steps, expression, true)) {
+				_pushStep(&treeWriter, steps, expression->rightExpression, false);
+				_pushStep(&treeWriter, steps, expression->leftExpression, false);
+			}
+		}
+		else {
+			_writeExpression(&treeWriter, expression);
+		}
+	}
+	destroyStack(steps);
+
+	TreeFileTrailer trailer = {
+		.program = 0,
+		.relocations = 0,
+		.relocationsCount = 0
+	};
+	if (treeWriter.succeed) {
+		trailer.program = _nextOffset(&treeWriter);
+		Program copy = {
+			.expression = _offsetOf(&treeWriter, trailer.program, offsetof(Program, expression), program->expression)
+		};
+		_writeAligned(&treeWriter, &copy, sizeof(Program));
+		trailer.relocationsCount = treeWriter.relocations->size;
+		trailer.relocations = _writeAligned(&treeWriter, treeWriter.relocations->elements, treeWriter.relocations->size * sizeof(uint64_t));
+		writeBytes(treeWriter.writer, (const char *) &trailer, sizeof(TreeFileTrailer));
+	}
+	if (!treeWriter.succeed) {
+		logError(_logger, "The tree cannot be written (out of memory).");
+	}
+	destroyStack(treeWriter.relocations);
+	releaseMemory(treeWriter.writtenNodes);
+	return destroyWriter(treeWriter.writer) && treeWriter.succeed;
+}
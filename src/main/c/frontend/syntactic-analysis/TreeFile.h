@@ -0,0 +1,90 @@
+#ifndef TREE_FILE_HEADER
+#define TREE_FILE_HEADER
+
+#include "../../shared/Integer.h"
+#include "../../shared/Logger.h"
+#include "../../shared/MappedFile.h"
+#include "../../shared/Memory.h"
+#include "../../shared/Stack.h"
+#include "../../shared/Type.h"
+#include "../../shared/Writer.h"
+#include "AbstractSyntaxTree.h"
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeTreeFileModule();
+
+/** Shutdown module's internal state. */
+void shutdownTreeFileModule();
+
+/**
+ * The version of the format of the tree files. It must change with every
+ * change of the format (e.g., a new kind of node).
+ */
+#define TREE_FILE_VERSION 2
+
+/**
+ * The beginning of a tree file. Besides the version, it records the byte
+ * order and the sizes of the nodes of the compiler that wrote it, since the
+ * nodes are stored exactly as they are in memory, so only a compatible
+ * compiler can load them.
+ */
+typedef struct {
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrder;
+	uint16_t sizes[4];
+} TreeFileHeader;
+
+/**
+ * The end of a tree file: where the root and the relocations are, as offsets
+ * from the beginning of the file.
+ */
+typedef struct {
+	uint64_t program;
+	uint64_t relocations;
+	uint64_t relocationsCount;
+} TreeFileTrailer;
+
+/**
+ * An AST loaded from a tree file. The file is a header, the nodes (children
+ * first, each one once, even if it's shared), the relocations and a trailer.
+ * Every pointer between nodes is stored as an offset from the beginning of
+ * the file (so the file doesn't depend on where it was written), and the
+ * relocations are the offsets of those pointers. The file is mapped in
+ * memory (privately), and each relocation adds the address of the mapping
+ * to its pointer, so the nodes are used in place, without allocating any of
+ * them. Only the pages with pointers are copied (on write), by the kernel.
+ */
+typedef struct {
+	MappedFile * mappedFile;
+
+	// The root of the loaded AST, inside the mapping.
+	Program * program;
+} TreeFile;
+
+/**
+ * Loads the AST of a tree file. Returns NULL if the file cannot be mapped,
+ * or if it's not a valid tree file of a compatible compiler (the reason is
+ * logged).
+ */
+TreeFile * createTreeFile(const char * path);
+
+/**
+ * Unmaps the file, and destroys the tree-file structure (and the AST).
+ */
+void destroyTreeFile(TreeFile * treeFile);
+
+/**
+ * Writes an AST into a stream, in the format of the tree files (the shared
+ * subtrees are written once). Returns false if the stream could not be
+ * written completely, or if the system ran out of memory.
+ */
+boolean writeTreeFile(FILE * stream, const Program * program);
+
+#endif
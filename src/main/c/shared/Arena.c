@@ -0,0 +1,131 @@
+#include "Arena.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * A type with the strictest alignment needed by the allocations served.
+ */
+typedef union {
+	void * pointer;
+	long long integer;
+	double real;
+} _Alignment;
+
+static const size_t _alignment = sizeof(_Alignment);
+
+/* PRIVATE FUNCTIONS */
+
+static size_t _align(const size_t size);
+static ArenaBlock * _createBlock(Arena * arena, const size_t capacity);
+static char * _dataOf(ArenaBlock * block);
+
+/**
+ * Rounds up the size to the next multiple of the alignment.
+ */
+static size_t _align(const size_t size) {
+	return (size + _alignment - 1) & ~(_alignment - 1);
+}
+
+/**
+ * Reserves a new block with the specified capacity, and pushes it in front
+ * of the chain of blocks of the arena.
+ */
+static ArenaBlock * _createBlock(Arena * arena, const size_t capacity) {
+	const size_t headerSize = _align(sizeof(ArenaBlock));
+	ArenaBlock * block = allocateMemory(headerSize + capacity);
+	if (block == NULL) {
+		return NULL;
+	}
+	block->capacity = capacity;
+	block->used = 0;
+	block->next = arena->block;
+	arena->block = block;
+	arena->reservedBytes += headerSize + capacity;
+	return block;
+}
+
+/**
+ * The usable memory of a block, just after its header.
+ */
+static char * _dataOf(ArenaBlock * block) {
+	return ((char *) block) + _align(sizeof(ArenaBlock));
+}
+
+/* PUBLIC FUNCTIONS */
+
+Arena * createArena(const size_t blockSize) {
+	Arena * arena = allocateZeroedMemory(1, sizeof(Arena));
+	arena->blockSize = _align(blockSize);
+	return arena;
+}
+
+void destroyArena(Arena * arena) {
+	if (arena != NULL) {
+		ArenaBlock * block = arena->block;
+		while (block != NULL) {
+			ArenaBlock * next = block->next;
+			releaseMemory(block);
+			block = next;
+		}
+		releaseMemory(arena);
+	}
+}
+
+void * allocateInArena(Arena * arena, const size_t size) {
+	const size_t alignedSize = _align(size);
+	ArenaBlock * block = arena->block;
+	if (block == NULL || block->capacity - block->used < alignedSize) {
+		const size_t capacity = arena->blockSize < alignedSize ? alignedSize : arena->blockSize;
+		block = _createBlock(arena, capacity);
+		if (block == NULL) {
+			return NULL;
+		}
+	}
+	void * memory = _dataOf(block) + block->used;
+	block->used += alignedSize;
+	arena->allocations += 1;
+	arena->allocatedBytes += alignedSize;
+	memset(memory, 0, alignedSize);
+	return memory;
+}
+
+void mergeArena(Arena * arena, Arena * source) {
+	ArenaBlock * block = source->block;
+	if (block != NULL) {
+		// The oldest block of the source, whose next is the rest of the arena.
+		ArenaBlock * oldest = block;
+		while (oldest->next != NULL) {
+			oldest = oldest->next;
+		}
+		if (arena->block == NULL) {
+			arena->block = block;
+		}
+		else {
+			oldest->next = arena->block->next;
+			arena->block->next = block;
+		}
+	}
+	arena->allocations += source->allocations;
+	arena->allocatedBytes += source->allocatedBytes;
+	arena->reservedBytes += source->reservedBytes;
+	source->block = NULL;
+	source->allocations = 0;
+	source->allocatedBytes = 0;
+	source->reservedBytes = 0;
+}
+
+void resetArena(Arena * arena) {
+	ArenaBlock * block = arena->block;
+	while (block != NULL && block->next != NULL) {
+		ArenaBlock * next = block->next;
+		arena->reservedBytes -= _align(sizeof(ArenaBlock)) + block->capacity;
+		releaseMemory(block);
+		block = next;
+	}
+	if (block != NULL) {
+		block->used = 0;
+	}
+	arena->block = block;
+	arena->allocations = 0;
+	arena->allocatedBytes = 0;
+}
@@ -0,0 +1,84 @@
+#ifndef ARENA_HEADER
+#define ARENA_HEADER
+
+#include "Memory.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The default size of every block reserved by an arena, in bytes. Bigger
+ * requests get a dedicated block.
+ */
+#define ARENA_DEFAULT_BLOCK_SIZE (1024 * 1024)
+
+/**
+ * This typedefs allows self-referencing types.
+ */
+
+typedef struct ArenaBlock ArenaBlock;
+
+/**
+ * A contiguous chunk of memory owned by an arena. Blocks are chained from the
+ * newest to the oldest, and the usable memory starts right after the header.
+ */
+struct ArenaBlock {
+	ArenaBlock * next;
+	size_t capacity;
+	size_t used;
+};
+
+/**
+ * A region-based allocator: memory is carved linearly from big blocks and
+ * released at once, instead of node by node. It also keeps track of the
+ * allocations requested, to measure the memory footprint of a compilation.
+ */
+typedef struct {
+	// The block in use (the newest one).
+	ArenaBlock * block;
+
+	// The size of every regular block.
+	size_t blockSize;
+
+	// The amount of allocations served since the last reset.
+	size_t allocations;
+
+	// The amount of bytes requested since the last reset (with padding).
+	size_t allocatedBytes;
+
+	// The amount of bytes reserved from the system, including headers.
+	size_t reservedBytes;
+} Arena;
+
+/**
+ * Creates a new empty arena that reserves memory in blocks of the specified
+ * size. No memory is reserved until the first allocation.
+ */
+Arena * createArena(const size_t blockSize);
+
+/**
+ * Destroy an arena and every block of memory it owns, invalidating all the
+ * allocations served.
+ */
+void destroyArena(Arena * arena);
+
+/**
+ * Allocates zero-initialized memory inside the arena, aligned for any
+ * pointer or integer type. The memory cannot be freed individually.
+ */
+void * allocateInArena(Arena * arena, const size_t size);
+
+/**
+ * Moves every block of the source arena into the arena, so its allocations
+ * live (and die) with it, and the source becomes empty, but still usable. The
+ * block in use of the arena keeps serving the following allocations.
+ */
+void mergeArena(Arena * arena, Arena * source);
+
+/**
+ * Invalidates all the allocations served, but keeps the oldest block to
+ * serve the following ones. Resets the counters too.
+ */
+void resetArena(Arena * arena);
+
+#endif
@@ -1,7 +1,11 @@
 #ifndef COMPILER_STATE_HEADER
 #define COMPILER_STATE_HEADER
 
+#include "Arena.h"
+#include "Integer.h"
+#include "Telemetry.h"
 #include "Type.h"
+#include <stdio.h>
 
 /**
  * The general status of a compilation.
@@ -11,24 +15,89 @@ typedef enum {
 	FAILED = 1
 } CompilationStatus;
 
+/**
+ * What a compilation must produce.
+ */
+typedef enum {
+	// Builds the AST, computes its value and generates the final output.
+	GENERATION_MODE = 0,
+
+	// Computes the value while parsing (without building the AST), and
+	// outputs only that value.
+	EVALUATION_MODE = 1,
+
+	// Computes the value while parsing, as the evaluation mode, but spills the
+	// tree while it's parsed, and generates the final output from it, so the
+	// AST is never built in memory.
+	STREAMING_MODE = 2
+} CompilationMode;
+
 /**
  * The global state of the compiler. Should transport every data structure
  * needed across the different phases of a compilation.
  */
 typedef struct {
+	// The program to compile, as a sequence of bytes in memory. If it's NULL,
+	// the program is read from the input stream instead.
+	const char * source;
+	size_t sourceLength;
+
+	// If true, the source is writable and followed by two null bytes, so the
+	// scanner can use it in place, instead of copying it (e.g., a file mapped
+	// in memory).
+	boolean scanInPlace;
+
+	// The stream with the program to compile (the standard input, if NULL).
+	FILE * input;
+
+	// The stream where the final output is generated (if NULL, the final
+	// output is not generated at all).
+	FILE * output;
+
+	// The reentrant lexical-analyzer (a Flex scanner), only while parsing.
+	// With a pipelined frontend, it scans on a thread of its own, so the
+	// parser can only inspect it after the end of the input.
+	void * scanner;
+
+	// The tokens scanned ahead by the lexer thread, only while parsing with a
+	// pipelined frontend (otherwise, NULL).
+	void * tokenRing;
+
 	// The root node of the AST.
 	void * abstractSyntaxtTree;
 
+	// The memory where every node of the AST is allocated.
+	Arena * arena;
+
+	// The table that shares the identical nodes of the AST (a.k.a.,
+	// hash-consing), only while parsing. If NULL, every node is allocated.
+	void * nodeTable;
+
+	// The tree spilled while parsing, only in streaming mode (otherwise,
+	// NULL).
+	void * spilledTree;
+
 	// A flag that indicates the current state of the compilation so far.
 	boolean succeed;
 
+	// What the compilation must produce.
+	CompilationMode mode;
+
 	// TODO: Add an stack to handle nested scopes.
 	// TODO: Add a symbol table.
 	// TODO: Add configuration.
 	// TODO: ...
 
-	// The computed value of the entire program (only for the calculator).
-	int value;
+	// The computed value of the entire program (only for the calculator). If
+	// it's big, it lives in the arena.
+	Integer value;
+
+	// A flag that indicates if the value was computed successfully (while
+	// parsing, in evaluation mode).
+	boolean computed;
+
+	// The measurements of the compilation (if NULL, nothing is measured).
+	Telemetry * telemetry;
 } CompilerState;
 
 #endif
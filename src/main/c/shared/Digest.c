@@ -0,0 +1,114 @@
+#include "Digest.h"
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * The first 32 bits of the fractional parts of the cube roots of the first
+ * 64 primes.
+ */
+static const uint32_t _roundConstants[64] = {
+	0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+	0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+	0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+	0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+	0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+	0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+	0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+	0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+/* PRIVATE FUNCTIONS */
+
+static void _digestBlock(Digest * digest, const uint8_t * block);
+static uint32_t _rotate(const uint32_t word, const unsigned int bits);
+
+/**
+ * Mixes a block of 64 bytes into the state of the digest.
+ */
+static void _digestBlock(Digest * digest, const uint8_t * block) {
+	uint32_t schedule[64];
+	for (unsigned int k = 0; k < 16; ++k) {
+		schedule[k] = (uint32_t) block[4 * k] << 24 | (uint32_t) block[4 * k + 1] << 16 | (uint32_t) block[4 * k + 2] << 8 | block[4 * k + 3];
+	}
+	for (unsigned int k = 16; k < 64; ++k) {
+		const uint32_t s0 = _rotate(schedule[k - 15], 7) ^ _rotate(schedule[k - 15], 18) ^ (schedule[k - 15] >> 3);
+		const uint32_t s1 = _rotate(schedule[k - 2], 17) ^ _rotate(schedule[k - 2], 19) ^ (schedule[k - 2] >> 10);
+		schedule[k] = schedule[k - 16] + s0 + schedule[k - 7] + s1;
+	}
+	uint32_t a = digest->state[0], b = digest->state[1], c = digest->state[2], d = digest->state[3];
+	uint32_t e = digest->state[4], f = digest->state[5], g = digest->state[6], h = digest->state[7];
+	for (unsigned int k = 0; k < 64; ++k) {
+		const uint32_t t1 = h + (_rotate(e, 6) ^ _rotate(e, 11) ^ _rotate(e, 25)) + ((e & f) ^ (~e & g)) + _roundConstants[k] + schedule[k];
+		const uint32_t t2 = (_rotate(a, 2) ^ _rotate(a, 13) ^ _rotate(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+		h = g;
+		g = f;
+		f = e;
+		e = d + t1;
+		d = c;
+		c = b;
+		b = a;
+		a = t1 + t2;
+	}
+	digest->state[0] += a;
+	digest->state[1] += b;
+	digest->state[2] += c;
+	digest->state[3] += d;
+	digest->state[4] += e;
+	digest->state[5] += f;
+	digest->state[6] += g;
+	digest->state[7] += h;
+}
+
+static uint32_t _rotate(const uint32_t word, const unsigned int bits) {
+	return (word >> bits) | (word << (32 - bits));
+}
+
+/* PUBLIC FUNCTIONS */
+
+void finishDigest(Digest * digest, char hexadecimal[DIGEST_HEXADECIMAL_LENGTH + 1]) {
+	// Appends a single 1 bit, the zeroes that align the block to 56 bytes,
+	// and the length of the message in bits (big-endian).
+	const uint64_t bits = 8 * digest->length;
+	uint8_t padding[72] = { 0x80 };
+	const size_t paddingLength = (digest->blockLength < 56 ? 56 : 120) - digest->blockLength;
+	for (unsigned int k = 0; k < 8; ++k) {
+		padding[paddingLength + k] = (uint8_t) (bits >> (56 - 8 * k));
+	}
+	updateDigest(digest, padding, paddingLength + 8);
+	for (unsigned int k = 0; k < 8; ++k) {
+		sprintf(hexadecimal + 8 * k, "%08x", digest->state[k]);
+	}
+}
+
+void resetDigest(Digest * digest) {
+	static const uint32_t initialState[8] = {
+		0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+	};
+	memcpy(digest->state, initialState, sizeof(initialState));
+	digest->blockLength = 0;
+	digest->length = 0;
+}
+
+void updateDigest(Digest * digest, const void * bytes, const size_t length) {
+	const uint8_t * next = bytes;
+	const uint8_t * end = next + length;
+	digest->length += length;
+	if (0 < digest->blockLength) {
+		const size_t missing = 64 - digest->blockLength;
+		const size_t copied = length < missing ? length : missing;
+		memcpy(digest->block + digest->blockLength, next, copied);
+		digest->blockLength += copied;
+		next += copied;
+		if (digest->blockLength < 64) {
+			return;
+		}
+		_digestBlock(digest, digest->block);
+		digest->blockLength = 0;
+	}
+	// The complete blocks are digested in place, without copying them.
+	for (; 64 <= end - next; next += 64) {
+		_digestBlock(digest, next);
+	}
+	memcpy(digest->block, next, end - next);
+	digest->blockLength = end - next;
+}
@@ -0,0 +1,47 @@
+#ifndef DIGEST_HEADER
+#define DIGEST_HEADER
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * The length of a digest, in bytes, and of its hexadecimal representation
+ * (without the null terminator).
+ */
+#define DIGEST_LENGTH 32
+#define DIGEST_HEXADECIMAL_LENGTH (2 * DIGEST_LENGTH)
+
+/**
+ * A SHA-256 digest in progress (FIPS 180-4), to address the content of a
+ * sequence of bytes that arrives in pieces. Lives on the stack.
+ */
+typedef struct {
+	uint32_t state[8];
+
+	// The pending bytes of an incomplete block, and the amount of them.
+	uint8_t block[64];
+	size_t blockLength;
+
+	// The amount of bytes digested so far.
+	uint64_t length;
+} Digest;
+
+/**
+ * Finishes the digest, and writes it in hexadecimal (followed by a null
+ * terminator). The digest must be reset before reusing it.
+ */
+void finishDigest(Digest * digest, char hexadecimal[DIGEST_HEXADECIMAL_LENGTH + 1]);
+
+/**
+ * Starts a new empty digest.
+ */
+void resetDigest(Digest * digest);
+
+/**
+ * Digests a sequence of bytes of the specified length.
+ */
+void updateDigest(Digest * digest, const void * bytes, const size_t length);
+
+#endif
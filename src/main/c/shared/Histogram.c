@@ -0,0 +1,66 @@
+#include "Histogram.h"
+
+/* PRIVATE FUNCTIONS */
+
+static size_t _bucket(const uint64_t value);
+static uint64_t _upperBound(const size_t bucket);
+
+/**
+ * The values below 2 * HISTOGRAM_SUB_BUCKETS have a bucket each. Above, the
+ * bucket is given by the position of the highest bit (the power of 2), and by
+ * the next bits below it (the sub-bucket).
+ */
+static size_t _bucket(const uint64_t value) {
+	if (value < 2 * HISTOGRAM_SUB_BUCKETS) {
+		return (size_t) value;
+	}
+	const unsigned int power = 63 - (unsigned int) __builtin_clzll(value);
+	const unsigned int shift = power - 4;
+	return (size_t) (power - 3) * HISTOGRAM_SUB_BUCKETS + (size_t) ((value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+/**
+ * The highest value of a bucket.
+ */
+static uint64_t _upperBound(const size_t bucket) {
+	if (bucket < 2 * HISTOGRAM_SUB_BUCKETS) {
+		return (uint64_t) bucket;
+	}
+	const unsigned int power = (unsigned int) (bucket / HISTOGRAM_SUB_BUCKETS) + 3;
+	const uint64_t subBucket = bucket % HISTOGRAM_SUB_BUCKETS;
+	const unsigned int shift = power - 4;
+	return ((HISTOGRAM_SUB_BUCKETS + subBucket + 1) << shift) - 1;
+}
+
+/* PUBLIC FUNCTIONS */
+
+uint64_t histogramPercentile(const Histogram * histogram, const double percentage) {
+	if (histogram->length == 0) {
+		return 0;
+	}
+	// The rank of the value, from 1 to the amount of values.
+	uint64_t rank = (uint64_t) (percentage / 100.0 * histogram->length + 0.5);
+	rank = rank < 1 ? 1 : histogram->length < rank ? histogram->length : rank;
+	uint64_t seen = 0;
+	for (size_t k = 0; k < HISTOGRAM_BUCKETS; ++k) {
+		seen += histogram->counts[k];
+		if (rank <= seen) {
+			const uint64_t upperBound = _upperBound(k);
+			return upperBound < histogram->maximum ? upperBound : histogram->maximum;
+		}
+	}
+	return histogram->maximum;
+}
+
+void recordHistogram(Histogram * histogram, const uint64_t value) {
+	histogram->counts[_bucket(value)] += 1;
+	histogram->length += 1;
+	histogram->sum += value;
+	if (histogram->maximum < value) {
+		histogram->maximum = value;
+	}
+}
+
+void resetHistogram(Histogram * histogram) {
+	memset(histogram, 0, sizeof(Histogram));
+}
@@ -0,0 +1,49 @@
+#ifndef HISTOGRAM_HEADER
+#define HISTOGRAM_HEADER
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * The amount of buckets per power of 2. The relative error of a percentile is
+ * below 1/HISTOGRAM_SUB_BUCKETS.
+ */
+#define HISTOGRAM_SUB_BUCKETS 16
+
+/**
+ * The amount of buckets that cover every 64-bit value.
+ */
+#define HISTOGRAM_BUCKETS ((64 - 3) * HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * A histogram of non-negative values with log-linear buckets (i.e., every
+ * power of 2 is split into equal buckets), so its memory is fixed and its
+ * percentiles keep the same relative precision from nanoseconds to hours.
+ * Lives on the stack, or inside another structure.
+ */
+typedef struct {
+	uint64_t counts[HISTOGRAM_BUCKETS];
+	uint64_t length;
+	uint64_t maximum;
+	uint64_t sum;
+} Histogram;
+
+/**
+ * Returns the value below which is the specified percentage of the recorded
+ * values (an upper bound of it, within the precision of the buckets), or 0 if
+ * the histogram is empty.
+ */
+uint64_t histogramPercentile(const Histogram * histogram, const double percentage);
+
+/**
+ * Records a value.
+ */
+void recordHistogram(Histogram * histogram, const uint64_t value);
+
+/**
+ * Removes every recorded value.
+ */
+void resetHistogram(Histogram * histogram);
+
+#endif
@@ -0,0 +1,373 @@
+#include "Integer.h"
+
+/* PRIVATE FUNCTIONS */
+
+/**
+ * An integer seen as a sign and a magnitude, whatever its representation.
+ * The limbs of a small integer live in the buffer of the view itself, so a
+ * view cannot be copied.
+ */
+typedef struct {
+	boolean negative;
+	size_t length;
+	const uint32_t * limbs;
+	uint32_t buffer[2];
+} IntegerView;
+
+static BigInteger * _allocateBigInteger(Arena * arena, const size_t length);
+static int _compareMagnitudes(const IntegerView * left, const IntegerView * right);
+static void _divideMagnitudes(const uint32_t * dividend, const size_t dividendLength, const uint32_t * divisor, const size_t divisorLength, uint32_t * quotient, uint32_t * scratch);
+static uint32_t _divideMagnitudeBySmall(uint32_t * limbs, const size_t length, const uint32_t divisor);
+static Integer _normalize(BigInteger * bigInteger);
+static boolean _sumOrDifference(Arena * arena, const Integer left, const Integer right, const boolean subtraction, Integer * result);
+static void _view(const Integer integer, IntegerView * view);
+
+/**
+ * Allocates an uninitialized big integer with room for the specified amount
+ * of limbs, or returns NULL if there is no memory left.
+ */
+static BigInteger * _allocateBigInteger(Arena * arena, const size_t length) {
+	BigInteger * bigInteger = allocateInArena(arena, sizeof(BigInteger) + length * sizeof(uint32_t));
+	if (bigInteger != NULL) {
+		bigInteger->length = length;
+	}
+	return bigInteger;
+}
+
+/**
+ * Compares the magnitudes of two integers (ignoring their signs), and returns
+ * a negative number, zero or a positive number, as "strcmp".
+ */
+static int _compareMagnitudes(const IntegerView * left, const IntegerView * right) {
+	if (left->length != right->length) {
+		return left->length < right->length ? -1 : +1;
+	}
+	for (size_t k = left->length; 0 < k; --k) {
+		if (left->limbs[k - 1] != right->limbs[k - 1]) {
+			return left->limbs[k - 1] < right->limbs[k - 1] ? -1 : +1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Divides two magnitudes with the long division of Knuth (algorithm D, from
+ * "The Art of Computer Programming", vol. 2, section 4.3.1), as presented in
+ * "Hacker's Delight" (2nd edition, section 9.2). The dividend must be at least
+ * as long as the divisor, which must have two limbs or more. The quotient has
+ * room for "dividendLength - divisorLength + 1" limbs, and the scratch for
+ * "dividendLength + divisorLength + 1" limbs.
+ */
+static void _divideMagnitudes(const uint32_t * dividend, const size_t dividendLength, const uint32_t * divisor, const size_t divisorLength, uint32_t * quotient, uint32_t * scratch) {
+	const size_t m = dividendLength;
+	const size_t n = divisorLength;
+	uint32_t * u = scratch;
+	uint32_t * v = scratch + m + 1;
+
+	// Normalizes the operands, so the divisor has its most significant bit set.
+	const unsigned int shift = __builtin_clz(divisor[n - 1]);
+	for (size_t k = n - 1; 0 < k; --k) {
+		v[k] = (divisor[k] << shift) | (uint32_t) ((uint64_t) divisor[k - 1] >> (32 - shift));
+	}
+	v[0] = divisor[0] << shift;
+	u[m] = (uint32_t) ((uint64_t) dividend[m - 1] >> (32 - shift));
+	for (size_t k = m - 1; 0 < k; --k) {
+		u[k] = (dividend[k] << shift) | (uint32_t) ((uint64_t) dividend[k - 1] >> (32 - shift));
+	}
+	u[0] = dividend[0] << shift;
+
+	for (size_t j = m - n + 1; 0 < j--;) {
+		// Estimates the next limb of the quotient, which is at most 2 too big.
+		const uint64_t numerator = ((uint64_t) u[j + n] << 32) | u[j + n - 1];
+		uint64_t estimate = numerator / v[n - 1];
+		uint64_t remainder = numerator % v[n - 1];
+		while (estimate >> 32 != 0 || estimate * v[n - 2] > ((remainder << 32) | u[j + n - 2])) {
+			--estimate;
+			remainder += v[n - 1];
+			if (remainder >> 32 != 0) {
+				break;
+			}
+		}
+
+		// Multiplies and subtracts.
+		int64_t borrow = 0;
+		int64_t difference;
+		for (size_t k = 0; k < n; ++k) {
+			const uint64_t product = estimate * v[k];
+			difference = u[k + j] - borrow - (int64_t) (product & 0xFFFFFFFF);
+			u[k + j] = (uint32_t) difference;
+			borrow = (int64_t) (product >> 32) - (difference >> 32);
+		}
+		difference = u[j + n] - borrow;
+		u[j + n] = (uint32_t) difference;
+
+		// Adds back if the estimate was still too big (which is rare).
+		quotient[j] = (uint32_t) estimate;
+		if (difference < 0) {
+			quotient[j] -= 1;
+			uint64_t carry = 0;
+			for (size_t k = 0; k < n; ++k) {
+				const uint64_t sum = (uint64_t) u[k + j] + v[k] + carry;
+				u[k + j] = (uint32_t) sum;
+				carry = sum >> 32;
+			}
+			u[j + n] += (uint32_t) carry;
+		}
+	}
+}
+
+/**
+ * Divides a magnitude in place by a single limb, and returns the remainder.
+ */
+static uint32_t _divideMagnitudeBySmall(uint32_t * limbs, const size_t length, const uint32_t divisor) {
+	uint64_t remainder = 0;
+	for (size_t k = length; 0 < k; --k) {
+		const uint64_t current = (remainder << 32) | limbs[k - 1];
+		limbs[k - 1] = (uint32_t) (current / divisor);
+		remainder = current % divisor;
+	}
+	return (uint32_t) remainder;
+}
+
+/**
+ * Removes the leading zero limbs of a big integer, and converts it into a
+ * small integer if it fits in 64 bits.
+ */
+static Integer _normalize(BigInteger * bigInteger) {
+	while (0 < bigInteger->length && bigInteger->limbs[bigInteger->length - 1] == 0) {
+		--bigInteger->length;
+	}
+	Integer integer = {
+		.big = bigInteger,
+		.small = 0
+	};
+	if (bigInteger->length <= 2) {
+		const uint64_t magnitude = bigInteger->length == 0 ? 0
+			: bigInteger->length == 1 ? bigInteger->limbs[0]
+			: ((uint64_t) bigInteger->limbs[1] << 32) | bigInteger->limbs[0];
+		if (magnitude <= (uint64_t) INT64_MAX) {
+			integer.big = NULL;
+			integer.small = bigInteger->negative ? -(int64_t) magnitude : (int64_t) magnitude;
+		}
+		else if (bigInteger->negative && magnitude == (uint64_t) INT64_MAX + 1) {
+			integer.big = NULL;
+			integer.small = INT64_MIN;
+		}
+	}
+	return integer;
+}
+
+/**
+ * Adds or subtracts two integers: the magnitudes are added if the (effective)
+ * signs are equal, and otherwise the smallest is subtracted from the biggest.
+ */
+static boolean _sumOrDifference(Arena * arena, const Integer left, const Integer right, const boolean subtraction, Integer * result) {
+	IntegerView leftView;
+	IntegerView rightView;
+	_view(left, &leftView);
+	_view(right, &rightView);
+	rightView.negative = rightView.negative != subtraction;
+	const IntegerView * biggest = &leftView;
+	const IntegerView * smallest = &rightView;
+	if (_compareMagnitudes(&leftView, &rightView) < 0) {
+		biggest = &rightView;
+		smallest = &leftView;
+	}
+	BigInteger * bigInteger = _allocateBigInteger(arena, biggest->length + 1);
+	if (bigInteger == NULL) {
+		return false;
+	}
+	bigInteger->negative = biggest->negative;
+	if (leftView.negative == rightView.negative) {
+		uint64_t carry = 0;
+		for (size_t k = 0; k < biggest->length; ++k) {
+			const uint64_t sum = (uint64_t) biggest->limbs[k] + (k < smallest->length ? smallest->limbs[k] : 0) + carry;
+			bigInteger->limbs[k] = (uint32_t) sum;
+			carry = sum >> 32;
+		}
+		bigInteger->limbs[biggest->length] = (uint32_t) carry;
+	}
+	else {
+		int64_t borrow = 0;
+		for (size_t k = 0; k < biggest->length; ++k) {
+			const int64_t difference = (int64_t) biggest->limbs[k] - (k < smallest->length ? smallest->limbs[k] : 0) - borrow;
+			bigInteger->limbs[k] = (uint32_t) difference;
+			borrow = difference < 0 ? 1 : 0;
+		}
+		bigInteger->limbs[biggest->length] = 0;
+	}
+	*result = _normalize(bigInteger);
+	return true;
+}
+
+/**
+ * Builds the view of an integer.
+ */
+static void _view(const Integer integer, IntegerView * view) {
+	if (integer.big != NULL) {
+		view->negative = integer.big->negative;
+		view->length = integer.big->length;
+		view->limbs = integer.big->limbs;
+		return;
+	}
+	const uint64_t magnitude = integer.small < 0 ? -(uint64_t) integer.small : (uint64_t) integer.small;
+	view->negative = integer.small < 0;
+	view->buffer[0] = (uint32_t) magnitude;
+	view->buffer[1] = (uint32_t) (magnitude >> 32);
+	view->length = magnitude == 0 ? 0 : view->buffer[1] == 0 ? 1 : 2;
+	view->limbs = view->buffer;
+}
+
+/* PUBLIC FUNCTIONS */
+
+boolean addBigIntegers(Arena * arena, const Integer leftAddend, const Integer rightAddend, Integer * sum) {
+	return _sumOrDifference(arena, leftAddend, rightAddend, false, sum);
+}
+
+boolean divideBigIntegers(Arena * arena, const Integer dividend, const Integer divisor, Integer * quotient) {
+	IntegerView dividendView;
+	IntegerView divisorView;
+	_view(dividend, &dividendView);
+	_view(divisor, &divisorView);
+	if (_compareMagnitudes(&dividendView, &divisorView) < 0) {
+		quotient->big = NULL;
+		quotient->small = 0;
+		return true;
+	}
+	const size_t length = dividendView.length - divisorView.length + 1;
+	BigInteger * bigInteger = _allocateBigInteger(arena, length);
+	if (bigInteger == NULL) {
+		return false;
+	}
+	bigInteger->negative = dividendView.negative != divisorView.negative;
+	if (divisorView.length == 1) {
+		memcpy(bigInteger->limbs, dividendView.limbs, dividendView.length * sizeof(uint32_t));
+		_divideMagnitudeBySmall(bigInteger->limbs, length, divisorView.limbs[0]);
+	}
+	else {
+		uint32_t * scratch = allocateMemory((dividendView.length + divisorView.length + 1) * sizeof(uint32_t));
+		if (scratch == NULL) {
+			return false;
+		}
+		_divideMagnitudes(dividendView.limbs, dividendView.length, divisorView.limbs, divisorView.length, bigInteger->limbs, scratch);
+		releaseMemory(scratch);
+	}
+	*quotient = _normalize(bigInteger);
+	return true;
+}
+
+boolean multiplyBigIntegers(Arena * arena, const Integer multiplicand, const Integer multiplier, Integer * product) {
+	IntegerView multiplicandView;
+	IntegerView multiplierView;
+	_view(multiplicand, &multiplicandView);
+	_view(multiplier, &multiplierView);
+	BigInteger * bigInteger = _allocateBigInteger(arena, multiplicandView.length + multiplierView.length);
+	if (bigInteger == NULL) {
+		return false;
+	}
+	bigInteger->negative = multiplicandView.negative != multiplierView.negative;
+	for (size_t i = 0; i < multiplicandView.length; ++i) {
+		uint64_t carry = 0;
+		for (size_t j = 0; j < multiplierView.length; ++j) {
+			const uint64_t partial = (uint64_t) multiplicandView.limbs[i] * multiplierView.limbs[j] + bigInteger->limbs[i + j] + carry;
+			bigInteger->limbs[i + j] = (uint32_t) partial;
+			carry = partial >> 32;
+		}
+		bigInteger->limbs[i + multiplierView.length] = (uint32_t) carry;
+	}
+	*product = _normalize(bigInteger);
+	return true;
+}
+
+boolean subtractBigIntegers(Arena * arena, const Integer minuend, const Integer subtrahend, Integer * difference) {
+	return _sumOrDifference(arena, minuend, subtrahend, true, difference);
+}
+
+boolean equalIntegers(const Integer left, const Integer right) {
+	if (left.big == NULL || right.big == NULL) {
+		return left.big == right.big && left.small == right.small;
+	}
+	return left.big->negative == right.big->negative
+		&& left.big->length == right.big->length
+		&& memcmp(left.big->limbs, right.big->limbs, left.big->length * sizeof(uint32_t)) == 0;
+}
+
+boolean parseInteger(Arena * arena, const char * digits, const size_t length, Integer * integer) {
+	// Up to 18 digits always fit in 64 bits.
+	if (length <= 18) {
+		int64_t value = 0;
+		for (size_t k = 0; k < length; ++k) {
+			value = 10 * value + (digits[k] - '0');
+		}
+		integer->big = NULL;
+		integer->small = value;
+		return true;
+	}
+	// Otherwise, the magnitude grows by chunks of 9 digits (each one fits in a
+	// single limb).
+	BigInteger * bigInteger = _allocateBigInteger(arena, length / 9 + 2);
+	if (bigInteger == NULL) {
+		return false;
+	}
+	bigInteger->length = 0;
+	for (size_t k = 0; k < length;) {
+		const size_t chunkLength = k == 0 && length % 9 != 0 ? length % 9 : 9;
+		uint32_t chunk = 0;
+		uint32_t scale = 1;
+		for (size_t end = k + chunkLength; k < end; ++k) {
+			chunk = 10 * chunk + (digits[k] - '0');
+			scale *= 10;
+		}
+		uint64_t carry = chunk;
+		for (size_t l = 0; l < bigInteger->length; ++l) {
+			const uint64_t partial = (uint64_t) bigInteger->limbs[l] * scale + carry;
+			bigInteger->limbs[l] = (uint32_t) partial;
+			carry = partial >> 32;
+		}
+		if (carry != 0) {
+			bigInteger->limbs[bigInteger->length++] = (uint32_t) carry;
+		}
+	}
+	*integer = _normalize(bigInteger);
+	return true;
+}
+
+char * integerToString(const Integer integer) {
+	if (integer.big == NULL) {
+		char * string = allocateMemory(21);
+		if (string != NULL) {
+			snprintf(string, 21, "%" PRId64, integer.small);
+		}
+		return string;
+	}
+	// Every limb takes less than 10 digits, which are extracted 9 at a time.
+	const BigInteger * bigInteger = integer.big;
+	const size_t capacity = 10 * bigInteger->length + 2;
+	char * string = allocateMemory(capacity);
+	uint32_t * limbs = allocateMemory(bigInteger->length * sizeof(uint32_t));
+	if (string == NULL || limbs == NULL) {
+		releaseMemory(string);
+		releaseMemory(limbs);
+		return NULL;
+	}
+	memcpy(limbs, bigInteger->limbs, bigInteger->length * sizeof(uint32_t));
+	size_t length = bigInteger->length;
+	size_t k = capacity;
+	string[--k] = '\0';
+	while (0 < length) {
+		uint32_t chunk = _divideMagnitudeBySmall(limbs, length, 1000000000);
+		while (0 < length && limbs[length - 1] == 0) {
+			--length;
+		}
+		for (unsigned int digit = 0; digit < 9 && (0 < length || 0 < chunk); ++digit) {
+			string[--k] = '0' + (chunk % 10);
+			chunk /= 10;
+		}
+	}
+	if (bigInteger->negative) {
+		string[--k] = '-';
+	}
+	memmove(string, string + k, capacity - k);
+	releaseMemory(limbs);
+	return string;
+}
@@ -0,0 +1,111 @@
+#ifndef INTEGER_HEADER
+#define INTEGER_HEADER
+
+#include "Arena.h"
+#include "Memory.h"
+#include "Type.h"
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * An arbitrary-precision integer: a sign and a magnitude in base 2^32, with
+ * the least significant limb first and without leading zero limbs.
+ */
+typedef struct {
+	boolean negative;
+	size_t length;
+	uint32_t limbs[];
+} BigInteger;
+
+/**
+ * An integer of any size. While it fits in 64 bits, it's a plain machine
+ * integer ("small"), and "big" is NULL. Otherwise, "big" holds the value,
+ * inside the arena of the computation that produced it. Every operation
+ * returns a small integer whenever the result fits, so a value never has
+ * two representations.
+ */
+typedef struct {
+	const BigInteger * big;
+	int64_t small;
+} Integer;
+
+/**
+ * The slow paths of the arithmetic operations, used when an operand is big,
+ * or when the result overflows 64 bits. Every result is allocated in the
+ * arena. They return false if there is no memory left.
+ */
+
+boolean addBigIntegers(Arena * arena, const Integer leftAddend, const Integer rightAddend, Integer * sum);
+boolean divideBigIntegers(Arena * arena, const Integer dividend, const Integer divisor, Integer * quotient);
+boolean multiplyBigIntegers(Arena * arena, const Integer multiplicand, const Integer multiplier, Integer * product);
+boolean subtractBigIntegers(Arena * arena, const Integer minuend, const Integer subtrahend, Integer * difference);
+
+/**
+ * Arithmetic operations. They run on 64-bit integers with checked builtins,
+ * and only promote to arbitrary-precision when an operand is already big, or
+ * when the result overflows. They return false if there is no memory left.
+ * The division truncates toward zero, and its divisor cannot be zero.
+ */
+
+static inline boolean addIntegers(Arena * arena, const Integer leftAddend, const Integer rightAddend, Integer * sum) {
+	if (leftAddend.big == NULL && rightAddend.big == NULL && !__builtin_add_overflow(leftAddend.small, rightAddend.small, &sum->small)) {
+		sum->big = NULL;
+		return true;
+	}
+	return addBigIntegers(arena, leftAddend, rightAddend, sum);
+}
+
+static inline boolean divideIntegers(Arena * arena, const Integer dividend, const Integer divisor, Integer * quotient) {
+	if (dividend.big == NULL && divisor.big == NULL && !(dividend.small == INT64_MIN && divisor.small == -1)) {
+		quotient->big = NULL;
+		quotient->small = dividend.small / divisor.small;
+		return true;
+	}
+	return divideBigIntegers(arena, dividend, divisor, quotient);
+}
+
+static inline boolean multiplyIntegers(Arena * arena, const Integer multiplicand, const Integer multiplier, Integer * product) {
+	if (multiplicand.big == NULL && multiplier.big == NULL && !__builtin_mul_overflow(multiplicand.small, multiplier.small, &product->small)) {
+		product->big = NULL;
+		return true;
+	}
+	return multiplyBigIntegers(arena, multiplicand, multiplier, product);
+}
+
+static inline boolean subtractIntegers(Arena * arena, const Integer minuend, const Integer subtrahend, Integer * difference) {
+	if (minuend.big == NULL && subtrahend.big == NULL && !__builtin_sub_overflow(minuend.small, subtrahend.small, &difference->small)) {
+		difference->big = NULL;
+		return true;
+	}
+	return subtractBigIntegers(arena, minuend, subtrahend, difference);
+}
+
+/**
+ * Returns true if both integers have the same value.
+ */
+boolean equalIntegers(const Integer left, const Integer right);
+
+/**
+ * Returns true if the integer is zero.
+ */
+static inline boolean isZeroInteger(const Integer integer) {
+	return integer.big == NULL && integer.small == 0;
+}
+
+/**
+ * Converts a length-delimited sequence of decimal digits into an integer, of
+ * any length (the big ones are allocated in the arena). Returns false if
+ * there is no memory left.
+ */
+boolean parseInteger(Arena * arena, const char * digits, const size_t length, Integer * integer);
+
+/**
+ * Formats an integer in decimal, in a new null-terminated string (which must
+ * be freed), or returns NULL if there is no memory left.
+ */
+char * integerToString(const Integer integer);
+
+#endif
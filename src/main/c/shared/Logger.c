@@ -1,5 +1,8 @@
 #include "Logger.h"
 
+// The function must exist even if the macro removes its calls.
+#undef logDebugging
+
 /* PRIVATE FUNCTIONS */
 
 static void _log(const Logger * logger, const LoggingLevel loggingLevel, const char * const format, va_list arguments);
@@ -8,20 +11,20 @@ static void _logInStream(FILE * const stream, const char * const format, va_list
 static const char * _toContextString(const LoggingLevel loggingLevel);
 
 /**
- * Logs a new message at the specified level, using a format string.
+ * Logs a new message at the specified level, using a format string. The
+ * caller must check the level before, to avoid setting up the arguments of a
+ * message that's not visible.
  */
 static void _log(const Logger * logger, const LoggingLevel loggingLevel, const char * const format, va_list arguments) {
-	if (logger->loggingLevel <= loggingLevel) {
-		const char * context = _toContextString(loggingLevel);
-		char * effectiveFormat = concatenate(6, context, "[", logger->name, "] ", format, "\n");
-		if (ERROR <= loggingLevel) {
-			_logInStream(stderr, effectiveFormat, arguments);
-		}
-		else {
-			_logInStream(stdout, effectiveFormat, arguments);
-		}
-		free(effectiveFormat);
+	const char * context = _toContextString(loggingLevel);
+	char * effectiveFormat = concatenate(6, context, "[", logger->name, "] ", format, "\n");
+	if (ERROR <= loggingLevel) {
+		_logInStream(stderr, effectiveFormat, arguments);
 	}
+	else {
+		_logInStream(stdout, effectiveFormat, arguments);
+	}
+	releaseMemory(effectiveFormat);
 }
 
 /**
@@ -69,9 +72,9 @@ static const char * _toContextString(const LoggingLevel loggingLevel) {
 /* PUBLIC FUNCTIONS */
 
 Logger * createLogger(char * name) {
-	Logger * logger = calloc(1, sizeof(Logger));
+	Logger * logger = allocateZeroedMemory(1, sizeof(Logger));
 	logger->loggingLevel = _loggingLevelFromString(getStringOrDefault("LOGGING_LEVEL", "INFORMATION"));
-	logger->name = calloc(1 + strlen(name), sizeof(char));
+	logger->name = allocateZeroedMemory(1 + strlen(name), sizeof(char));
 	strcpy(logger->name, name);
 	return logger;
 }
@@ -79,43 +82,53 @@ Logger * createLogger(char * name) {
 void destroyLogger(Logger * logger) {
 	if (logger != NULL) {
 		if (logger->name != NULL) {
-			free(logger->name);
+			releaseMemory(logger->name);
 		}
-		free(logger);
+		releaseMemory(logger);
 	}
 }
 
 void logCritical(const Logger * logger, const char * const format, ...) {
-	va_list arguments;
-	va_start(arguments, format);
-	_log(logger, CRITICAL, format, arguments);
-	va_end(arguments);
+	if (isLoggingEnabled(logger, CRITICAL)) {
+		va_list arguments;
+		va_start(arguments, format);
+		_log(logger, CRITICAL, format, arguments);
+		va_end(arguments);
+	}
 }
 
 void logDebugging(const Logger * logger, const char * const format, ...) {
-	va_list arguments;
-	va_start(arguments, format);
-	_log(logger, DEBUGGING, format, arguments);
-	va_end(arguments);
+	if (isLoggingEnabled(logger, DEBUGGING)) {
+		va_list arguments;
+		va_start(arguments, format);
+		_log(logger, DEBUGGING, format, arguments);
+		va_end(arguments);
+	}
 }
 
 void logError(const Logger * logger, const char * const format, ...) {
-	va_list arguments;
-	va_start(arguments, format);
-	_log(logger, ERROR, format, arguments);
-	va_end(arguments);
+	if (isLoggingEnabled(logger, ERROR)) {
+		va_list arguments;
+		va_start(arguments, format);
+		_log(logger, ERROR, format, arguments);
+		va_end(arguments);
+	}
 }
 
 void logInformation(const Logger * logger, const char * const format, ...) {
-	va_list arguments;
-	va_start(arguments, format);
-	_log(logger, INFORMATION, format, arguments);
-	va_end(arguments);
+	if (isLoggingEnabled(logger, INFORMATION)) {
+		va_list arguments;
+		va_start(arguments, format);
+		_log(logger, INFORMATION, format, arguments);
+		va_end(arguments);
+	}
 }
 
 void logWarning(const Logger * logger, const char * const format, ...) {
-	va_list arguments;
-	va_start(arguments, format);
-	_log(logger, WARNING, format, arguments);
-	va_end(arguments);
+	if (isLoggingEnabled(logger, WARNING)) {
+		va_list arguments;
+		va_start(arguments, format);
+		_log(logger, WARNING, format, arguments);
+		va_end(arguments);
+	}
 }
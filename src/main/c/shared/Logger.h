@@ -2,7 +2,9 @@
 #define LOGGER_HEADER
 
 #include "Environment.h"
+#include "Memory.h"
 #include "String.h"
+#include "Type.h"
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -86,6 +88,21 @@ Logger * createLogger(char * name);
  */
 void destroyLogger(Logger * logger);
 
+/**
+ * Returns true if a message at the specified level would be visible with this
+ * logger. Use it to avoid any formatting or escaping work when it's not. If
+ * DISABLE_DEBUGGING_LOGS is defined at compile-time, the DEBUGGING level is
+ * never visible.
+ */
+static inline boolean isLoggingEnabled(const Logger * logger, const LoggingLevel loggingLevel) {
+#ifdef DISABLE_DEBUGGING_LOGS
+	if (loggingLevel <= DEBUGGING) {
+		return false;
+	}
+#endif
+	return logger->loggingLevel <= loggingLevel;
+}
+
 /** Logs at CRITICAL level. */
 void logCritical(const Logger * logger, const char * const format, ...);
 
@@ -101,4 +118,12 @@ void logInformation(const Logger * logger, const char * const format, ...);
 /** Logs at WARNING level. */
 void logWarning(const Logger * logger, const char * const format, ...);
 
+/**
+ * Removes every DEBUGGING log at compile-time, including the evaluation of
+ * its arguments.
+ */
+#ifdef DISABLE_DEBUGGING_LOGS
+#define logDebugging(logger, ...) ((void) 0)
+#endif
+
 #endif
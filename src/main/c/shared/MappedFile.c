@@ -0,0 +1,63 @@
+#include "MappedFile.h"
+
+/* PUBLIC FUNCTIONS */
+
+MappedFile * createMappedFile(const char * path) {
+	// Only a regular file has a size, and can be mapped. Any other one is not
+	// even opened, because opening a pipe waits for (and pairs with) a writer,
+	// which would be lost for the stream that reads it afterwards.
+	struct stat status;
+	if (stat(path, &status) == 0 && !S_ISREG(status.st_mode)) {
+		errno = S_ISDIR(status.st_mode) ? EISDIR : ENODEV;
+		return NULL;
+	}
+	const int file = open(path, O_RDONLY);
+	if (file < 0) {
+		return NULL;
+	}
+	if (fstat(file, &status) != 0) {
+		const int error = errno;
+		close(file);
+		errno = error;
+		return NULL;
+	}
+	// Reserves zeroed anonymous memory for the file and the padding, and then
+	// maps the file over its beginning. This way the padding is always there,
+	// even when the file ends exactly at the end of a page.
+	const size_t length = (size_t) status.st_size;
+	const size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+	const size_t mappingLength = (length + MAPPED_FILE_PADDING + pageSize - 1) / pageSize * pageSize;
+	char * bytes = mmap(NULL, mappingLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (bytes == MAP_FAILED) {
+		const int error = errno;
+		close(file);
+		errno = error;
+		return NULL;
+	}
+	if (0 < length && mmap(bytes, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, file, 0) == MAP_FAILED) {
+		const int error = errno;
+		munmap(bytes, mappingLength);
+		close(file);
+		errno = error;
+		return NULL;
+	}
+	close(file);
+	madvise(bytes, mappingLength, MADV_SEQUENTIAL);
+	MappedFile * mappedFile = allocateZeroedMemory(1, sizeof(MappedFile));
+	if (mappedFile == NULL) {
+		munmap(bytes, mappingLength);
+		errno = ENOMEM;
+		return NULL;
+	}
+	mappedFile->bytes = bytes;
+	mappedFile->length = length;
+	mappedFile->mappingLength = mappingLength;
+	return mappedFile;
+}
+
+void destroyMappedFile(MappedFile * mappedFile) {
+	if (mappedFile != NULL) {
+		munmap(mappedFile->bytes, mappedFile->mappingLength);
+		releaseMemory(mappedFile);
+	}
+}
@@ -0,0 +1,48 @@
+#ifndef MAPPED_FILE_HEADER
+#define MAPPED_FILE_HEADER
+
+#include "Memory.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * The amount of null bytes that always follow the content of a mapped file.
+ * Flex needs two of them at the end of a buffer to scan it in place.
+ */
+#define MAPPED_FILE_PADDING 2
+
+/**
+ * A file mapped in memory, instead of being read into a buffer. The mapping
+ * is private and writable: the content can be modified in place (e.g., by the
+ * scanner), but the changes never reach the file.
+ */
+typedef struct {
+	// The content of the file, followed by the padding.
+	char * bytes;
+
+	// The length of the file, in bytes (without the padding).
+	size_t length;
+
+	// The length of the entire mapping, a multiple of the page size.
+	size_t mappingLength;
+} MappedFile;
+
+/**
+ * Maps an entire file in memory, followed by the padding. Returns NULL if the
+ * file cannot be mapped (the reason is in "errno"). Only a regular file can be
+ * mapped: for any other one but a directory (e.g., a pipe or a terminal),
+ * "errno" is ENODEV, and the file must be read as a stream instead.
+ */
+MappedFile * createMappedFile(const char * path);
+
+/**
+ * Unmaps the file, and destroys the mapped-file structure.
+ */
+void destroyMappedFile(MappedFile * mappedFile);
+
+#endif
@@ -0,0 +1,270 @@
+#include "Memory.h"
+
+#ifdef ALLOCATION_TRACKING
+
+/* MODULE INTERNAL STATE */
+
+/**
+ * The maximum amount of call sites (a power of 2) and of modules. The call
+ * sites that don't fit are counted together, in an extra one.
+ */
+#define MEMORY_SITES 4096
+#define MEMORY_MODULES 128
+
+/**
+ * What precedes every tracked block: its size and its call site. Its size
+ * keeps the alignment of the block.
+ */
+typedef union {
+	struct {
+		size_t size;
+		uint32_t site;
+	};
+	long double alignment;
+} BlockHeader;
+
+/**
+ * The counters of a phase, a module or a call site. The live bytes of a phase
+ * are the ones of the entire process, so only their peak is kept.
+ */
+typedef struct {
+	size_t allocations;
+	size_t releases;
+	size_t allocatedBytes;
+	size_t liveBlocks;
+	size_t liveBytes;
+	size_t peakBytes;
+} MemoryCounters;
+
+typedef struct {
+	// The source file (a string literal, so it's compared by address), and
+	// the line.
+	const char * file;
+	unsigned int line;
+
+	unsigned int module;
+	MemoryCounters counters;
+} MemorySite;
+
+typedef struct {
+	// The name of the source file, without its directory and its extension.
+	const char * name;
+	size_t nameLength;
+
+	MemoryCounters counters;
+} MemoryModule;
+
+static const char * _phaseNames[MEMORY_PHASES] = { "driver", "parsing", "computation", "generation", "release" };
+
+static pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
+static MemoryModule _modules[MEMORY_MODULES];
+static unsigned int _modulesCount = 0;
+static MemoryCounters _phases[MEMORY_PHASES];
+static MemorySite _sites[MEMORY_SITES + 1];
+static unsigned int _sitesCount = 0;
+static MemoryCounters _total;
+
+/**
+ * The phase of the calling thread.
+ */
+static __thread MemoryPhase _phase = DRIVER_PHASE;
+
+/* PRIVATE FUNCTIONS */
+
+static int _compareModules(const void * left, const void * right);
+static void _countAllocation(MemoryCounters * memoryCounters, const size_t size);
+static void _countRelease(MemoryCounters * memoryCounters, const size_t size);
+static unsigned int _findModule(const char * file);
+static uint32_t _findSite(const char * file, const unsigned int line);
+static void * _track(BlockHeader * blockHeader, const size_t size, const char * file, const unsigned int line);
+static void _untrack(const BlockHeader * blockHeader);
+
+/**
+ * Orders the modules by name, for the report.
+ */
+static int _compareModules(const void * left, const void * right) {
+	const MemoryModule * leftModule = left;
+	const MemoryModule * rightModule = right;
+	const size_t length = leftModule->nameLength < rightModule->nameLength ? leftModule->nameLength : rightModule->nameLength;
+	const int comparison = strncmp(leftModule->name, rightModule->name, length);
+	return comparison != 0 ? comparison : (int) leftModule->nameLength - (int) rightModule->nameLength;
+}
+
+/**
+ * Counts an allocation of the specified size.
+ */
+static void _countAllocation(MemoryCounters * memoryCounters, const size_t size) {
+	memoryCounters->allocations += 1;
+	memoryCounters->allocatedBytes += size;
+	memoryCounters->liveBlocks += 1;
+	memoryCounters->liveBytes += size;
+	if (memoryCounters->peakBytes < memoryCounters->liveBytes) {
+		memoryCounters->peakBytes = memoryCounters->liveBytes;
+	}
+}
+
+/**
+ * Counts the release of a block of the specified size.
+ */
+static void _countRelease(MemoryCounters * memoryCounters, const size_t size) {
+	memoryCounters->releases += 1;
+	memoryCounters->liveBlocks -= 1;
+	memoryCounters->liveBytes -= size;
+}
+
+/**
+ * Returns the module of a source file, and registers it if it's new (the
+ * last module takes the ones that don't fit). Must run inside the mutex.
+ */
+static unsigned int _findModule(const char * file) {
+	const char * name = strrchr(file, '/');
+	name = name == NULL ? file : name + 1;
+	const char * extension = strrchr(name, '.');
+	const size_t nameLength = extension == NULL ? strlen(name) : (size_t) (extension - name);
+	for (unsigned int k = 0; k < _modulesCount; ++k) {
+		if (_modules[k].nameLength == nameLength && strncmp(_modules[k].name, name, nameLength) == 0) {
+			return k;
+		}
+	}
+	if (_modulesCount == MEMORY_MODULES) {
+		return MEMORY_MODULES - 1;
+	}
+	_modules[_modulesCount].name = name;
+	_modules[_modulesCount].nameLength = nameLength;
+	return _modulesCount++;
+}
+
+/**
+ * Returns the call site of a source file and a line, in an open-addressing
+ * hash table, and registers it if it's new. Must run inside the mutex.
+ */
+static uint32_t _findSite(const char * file, const unsigned int line) {
+	uint32_t slot = (uint32_t) ((((uintptr_t) file + line) * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & (MEMORY_SITES - 1);
+	while (_sites[slot].file != NULL) {
+		if (_sites[slot].file == file && _sites[slot].line == line) {
+			return slot;
+		}
+		slot = (slot + 1) & (MEMORY_SITES - 1);
+	}
+	if (MEMORY_SITES / 4 * 3 <= _sitesCount) {
+		_sites[MEMORY_SITES].file = "(other)";
+		_sites[MEMORY_SITES].module = _findModule("(other)");
+		return MEMORY_SITES;
+	}
+	_sites[slot].file = file;
+	_sites[slot].line = line;
+	_sites[slot].module = _findModule(file);
+	_sitesCount += 1;
+	return slot;
+}
+
+/**
+ * Fills the header of a new block, counts it, and returns the block.
+ */
+static void * _track(BlockHeader * blockHeader, const size_t size, const char * file, const unsigned int line) {
+	pthread_mutex_lock(&_mutex);
+	const uint32_t site = _findSite(file, line);
+	blockHeader->site = site;
+	blockHeader->size = size;
+	_countAllocation(&_sites[site].counters, size);
+	_countAllocation(&_modules[_sites[site].module].counters, size);
+	_countAllocation(&_total, size);
+	MemoryCounters * phase = &_phases[_phase];
+	phase->allocations += 1;
+	phase->allocatedBytes += size;
+	if (phase->peakBytes < _total.liveBytes) {
+		phase->peakBytes = _total.liveBytes;
+	}
+	pthread_mutex_unlock(&_mutex);
+	return blockHeader + 1;
+}
+
+/**
+ * Counts the release of a block (which is not released yet).
+ */
+static void _untrack(const BlockHeader * blockHeader) {
+	pthread_mutex_lock(&_mutex);
+	const MemorySite * site = &_sites[blockHeader->site];
+	_countRelease(&_sites[blockHeader->site].counters, blockHeader->size);
+	_countRelease(&_modules[site->module].counters, blockHeader->size);
+	_countRelease(&_total, blockHeader->size);
+	_phases[_phase].releases += 1;
+	pthread_mutex_unlock(&_mutex);
+}
+
+/* PUBLIC FUNCTIONS */
+
+void * trackedAllocateMemory(const size_t size, const boolean zeroed, const char * file, const unsigned int line) {
+	BlockHeader * blockHeader = zeroed ? calloc(1, sizeof(BlockHeader) + size) : malloc(sizeof(BlockHeader) + size);
+	return blockHeader == NULL ? NULL : _track(blockHeader, size, file, line);
+}
+
+void * trackedAllocateZeroedMemory(const size_t count, const size_t size, const char * file, const unsigned int line) {
+	if (size != 0 && SIZE_MAX / size - sizeof(BlockHeader) < count) {
+		return NULL;
+	}
+	return trackedAllocateMemory(count * size, true, file, line);
+}
+
+void * trackedReallocateMemory(void * pointer, const size_t size, const char * file, const unsigned int line) {
+	if (pointer == NULL) {
+		return trackedAllocateMemory(size, false, file, line);
+	}
+	// The block is counted as released, and allocated again at this site.
+	BlockHeader * blockHeader = ((BlockHeader *) pointer) - 1;
+	const BlockHeader previous = *blockHeader;
+	BlockHeader * reallocated = realloc(blockHeader, sizeof(BlockHeader) + size);
+	if (reallocated == NULL) {
+		return NULL;
+	}
+	_untrack(&previous);
+	return _track(reallocated, size, file, line);
+}
+
+void trackedReleaseMemory(void * pointer) {
+	if (pointer != NULL) {
+		BlockHeader * blockHeader = ((BlockHeader *) pointer) - 1;
+		_untrack(blockHeader);
+		free(blockHeader);
+	}
+}
+
+void trackedReportMemory(FILE * stream) {
+	pthread_mutex_lock(&_mutex);
+	fprintf(stream, "Memory by phase:\n");
+	fprintf(stream, "    %-16s %12s %12s %16s %16s\n", "phase", "allocations", "releases", "allocated bytes", "peak live bytes");
+	for (unsigned int k = 0; k < MEMORY_PHASES; ++k) {
+		fprintf(stream, "    %-16s %12zu %12zu %16zu %16zu\n", _phaseNames[k],
+			_phases[k].allocations, _phases[k].releases, _phases[k].allocatedBytes, _phases[k].peakBytes);
+	}
+	fprintf(stream, "Memory by module:\n");
+	fprintf(stream, "    %-24s %12s %12s %16s %16s %16s\n", "module", "allocations", "releases", "allocated bytes", "live bytes", "peak live bytes");
+	MemoryModule modules[MEMORY_MODULES];
+	memcpy(modules, _modules, _modulesCount * sizeof(MemoryModule));
+	qsort(modules, _modulesCount, sizeof(MemoryModule), _compareModules);
+	for (unsigned int k = 0; k < _modulesCount; ++k) {
+		const MemoryCounters * counters = &modules[k].counters;
+		fprintf(stream, "    %-24.*s %12zu %12zu %16zu %16zu %16zu\n", (int) modules[k].nameLength, modules[k].name,
+			counters->allocations, counters->releases, counters->allocatedBytes, counters->liveBytes, counters->peakBytes);
+	}
+	fprintf(stream, "Memory leaks (%zu blocks, %zu bytes):\n", _total.liveBlocks, _total.liveBytes);
+	for (unsigned int k = 0; k <= MEMORY_SITES; ++k) {
+		if (_sites[k].file != NULL && 0 < _sites[k].counters.liveBlocks) {
+			fprintf(stream, "    %s:%u, %zu blocks, %zu bytes\n", _sites[k].file, _sites[k].line,
+				_sites[k].counters.liveBlocks, _sites[k].counters.liveBytes);
+		}
+	}
+	fprintf(stream, "Peak live memory: %zu bytes.\n", _total.peakBytes);
+	pthread_mutex_unlock(&_mutex);
+}
+
+void trackedSetMemoryPhase(const MemoryPhase phase) {
+	pthread_mutex_lock(&_mutex);
+	_phase = phase;
+	if (_phases[phase].peakBytes < _total.liveBytes) {
+		_phases[phase].peakBytes = _total.liveBytes;
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef MEMORY_HEADER
+#define MEMORY_HEADER
+
+#include "Type.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The phases of a compilation that the allocations are attributed to. The
+ * driver phase is everything else (e.g., the start-up, reading the programs,
+ * and the shutdown).
+ */
+typedef enum {
+	DRIVER_PHASE = 0,
+	PARSING_PHASE = 1,
+	COMPUTATION_PHASE = 2,
+	GENERATION_PHASE = 3,
+	RELEASE_PHASE = 4
+} MemoryPhase;
+
+#define MEMORY_PHASES 5
+
+/**
+ * The heap-memory of every module is allocated and released through these
+ * macros. If ALLOCATION_TRACKING is defined at compile-time, they count the
+ * allocations, the releases, and the live and peak bytes by phase (of the
+ * calling thread), by module (i.e., source file) and by call site, and the
+ * report lists the blocks still alive by the call site that allocated them.
+ * Otherwise, they are the functions of the standard library, and they cost
+ * nothing.
+ *
+ * A block must be released by the same layer that allocated it: the memory
+ * allocated by the standard library (e.g., "strdup" or "open_memstream")
+ * must be released with "free".
+ */
+#ifdef ALLOCATION_TRACKING
+
+#define allocateMemory(size) trackedAllocateMemory(size, false, __FILE__, __LINE__)
+#define allocateZeroedMemory(count, size) trackedAllocateZeroedMemory(count, size, __FILE__, __LINE__)
+#define reallocateMemory(pointer, size) trackedReallocateMemory(pointer, size, __FILE__, __LINE__)
+#define releaseMemory(pointer) trackedReleaseMemory(pointer)
+#define reportMemory(stream) trackedReportMemory(stream)
+#define setMemoryPhase(phase) trackedSetMemoryPhase(phase)
+
+void * trackedAllocateMemory(const size_t size, const boolean zeroed, const char * file, const unsigned int line);
+void * trackedAllocateZeroedMemory(const size_t count, const size_t size, const char * file, const unsigned int line);
+void * trackedReallocateMemory(void * pointer, const size_t size, const char * file, const unsigned int line);
+void trackedReleaseMemory(void * pointer);
+void trackedReportMemory(FILE * stream);
+void trackedSetMemoryPhase(const MemoryPhase phase);
+
+#else
+
+#define allocateMemory(size) malloc(size)
+#define allocateZeroedMemory(count, size) calloc(count, size)
+#define reallocateMemory(pointer, size) realloc(pointer, size)
+#define releaseMemory(pointer) free(pointer)
+#define reportMemory(stream) ((void) 0)
+#define setMemoryPhase(phase) ((void) 0)
+
+#endif
+
+#endif
@@ -0,0 +1,45 @@
+#include "Stack.h"
+
+/* PUBLIC FUNCTIONS */
+
+Stack * createStack(const size_t elementSize, const size_t initialCapacity) {
+	Stack * stack = allocateZeroedMemory(1, sizeof(Stack));
+	stack->capacity = 0 < initialCapacity ? initialCapacity : 1;
+	stack->elements = allocateMemory(stack->capacity * elementSize);
+	stack->elementSize = elementSize;
+	return stack;
+}
+
+void destroyStack(Stack * stack) {
+	if (stack != NULL) {
+		if (stack->elements != NULL) {
+			releaseMemory(stack->elements);
+		}
+		releaseMemory(stack);
+	}
+}
+
+boolean isEmptyStack(const Stack * stack) {
+	return stack->size == 0 ? true : false;
+}
+
+void popStack(Stack * stack, void * element) {
+	stack->size -= 1;
+	if (element != NULL) {
+		memcpy(element, stack->elements + stack->size * stack->elementSize, stack->elementSize);
+	}
+}
+
+boolean pushStack(Stack * stack, const void * element) {
+	if (stack->size == stack->capacity) {
+		char * elements = reallocateMemory(stack->elements, 2 * stack->capacity * stack->elementSize);
+		if (elements == NULL) {
+			return false;
+		}
+		stack->elements = elements;
+		stack->capacity *= 2;
+	}
+	memcpy(stack->elements + stack->size * stack->elementSize, element, stack->elementSize);
+	stack->size += 1;
+	return true;
+}
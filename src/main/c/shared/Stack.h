@@ -0,0 +1,49 @@
+#ifndef STACK_HEADER
+#define STACK_HEADER
+
+#include "Memory.h"
+#include "Type.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A LIFO stack of fixed-size elements, stored contiguously in heap-memory.
+ * It grows on demand, so its depth is only limited by the available memory.
+ * Use it to replace native recursion over deep structures.
+ */
+typedef struct {
+	char * elements;
+	size_t elementSize;
+	size_t capacity;
+	size_t size;
+} Stack;
+
+/**
+ * Creates a new empty stack for elements of the specified size, with room
+ * for the specified amount of them before growing.
+ */
+Stack * createStack(const size_t elementSize, const size_t initialCapacity);
+
+/**
+ * Destroy a stack and its resources.
+ */
+void destroyStack(Stack * stack);
+
+/**
+ * Returns true if the stack has no elements.
+ */
+boolean isEmptyStack(const Stack * stack);
+
+/**
+ * Removes the element on top of the stack, and copies it into the specified
+ * location (if not NULL). The stack must not be empty.
+ */
+void popStack(Stack * stack, void * element);
+
+/**
+ * Copies an element on top of the stack. Returns false if the stack couldn't
+ * grow (i.e., the system ran out of memory).
+ */
+boolean pushStack(Stack * stack, const void * element);
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef STRING_HEADER
 #define STRING_HEADER
 
+#include "Memory.h"
 #include <ctype.h>
 #include <stdarg.h>
 #include <stdlib.h>
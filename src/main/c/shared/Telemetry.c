@@ -0,0 +1,122 @@
+#include "Telemetry.h"
+
+/* MODULE INTERNAL STATE */
+
+static boolean _enabled = false;
+static const char * _path = NULL;
+static Logger * _logger = NULL;
+
+void initializeTelemetryModule() {
+	_logger = createLogger("Telemetry");
+	_enabled = getBooleanOrDefault("TELEMETRY", false);
+	_path = getStringOrDefault("TELEMETRY_FILE", NULL);
+}
+
+void shutdownTelemetryModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+Telemetry * createTelemetry() {
+	if (!_enabled) {
+		return NULL;
+	}
+	Telemetry * telemetry = allocateZeroedMemory(1, sizeof(Telemetry));
+	if (telemetry == NULL) {
+		logWarning(_logger, "The telemetry cannot be created (out of memory).");
+	}
+	return telemetry;
+}
+
+void destroyTelemetry(Telemetry * telemetry) {
+	releaseMemory(telemetry);
+}
+
+void mergeTelemetry(Telemetry * telemetry, const Telemetry * other) {
+	telemetry->programs += other->programs;
+	telemetry->sourceBytes += other->sourceBytes;
+	telemetry->parsingSeconds += other->parsingSeconds;
+	telemetry->computationSeconds += other->computationSeconds;
+	telemetry->generationSeconds += other->generationSeconds;
+	telemetry->releaseSeconds += other->releaseSeconds;
+	telemetry->tokens.additions += other->tokens.additions;
+	telemetry->tokens.closeParentheses += other->tokens.closeParentheses;
+	telemetry->tokens.divisions += other->tokens.divisions;
+	telemetry->tokens.identifiers += other->tokens.identifiers;
+	telemetry->tokens.integers += other->tokens.integers;
+	telemetry->tokens.multiplications += other->tokens.multiplications;
+	telemetry->tokens.openParentheses += other->tokens.openParentheses;
+	telemetry->tokens.subtractions += other->tokens.subtractions;
+	telemetry->tokens.unknowns += other->tokens.unknowns;
+	telemetry->nodes.constants += other->nodes.constants;
+	telemetry->nodes.expressions += other->nodes.expressions;
+	telemetry->nodes.parentheses += other->nodes.parentheses;
+	telemetry->nodes.programs += other->nodes.programs;
+	telemetry->nodes.variables += other->nodes.variables;
+	telemetry->hashConsing.nodes += other->hashConsing.nodes;
+	telemetry->hashConsing.sharedNodes += other->hashConsing.sharedNodes;
+	telemetry->hashConsing.savedBytes += other->hashConsing.savedBytes;
+	if (telemetry->hashConsing.tableBytes < other->hashConsing.tableBytes) {
+		telemetry->hashConsing.tableBytes = other->hashConsing.tableBytes;
+	}
+	if (telemetry->maximumDepth < other->maximumDepth) {
+		telemetry->maximumDepth = other->maximumDepth;
+	}
+	telemetry->emittedBytes += other->emittedBytes;
+}
+
+void reportTelemetry(const Telemetry * telemetry) {
+	FILE * stream = _path == NULL ? stderr : fopen(_path, "a");
+	if (stream == NULL) {
+		logError(_logger, "The telemetry cannot be written into \"%s\": %s.", _path, strerror(errno));
+		return;
+	}
+	fprintf(stream,
+		"{\"programs\":%zu,\"sourceBytes\":%zu,"
+		"\"seconds\":{\"parsing\":%.9f,\"computation\":%.9f,\"generation\":%.9f,\"release\":%.9f},"
+		"\"tokens\":{\"ADD\":%zu,\"CLOSE_PARENTHESIS\":%zu,\"DIV\":%zu,\"IDENTIFIER\":%zu,\"INTEGER\":%zu,\"MUL\":%zu,\"OPEN_PARENTHESIS\":%zu,\"SUB\":%zu,\"UNKNOWN\":%zu},"
+		"\"nodes\":{\"Constant\":%zu,\"Expression\":%zu,\"Parentheses\":%zu,\"Program\":%zu,\"Variable\":%zu},"
+		"\"hashConsing\":{\"nodes\":%zu,\"sharedNodes\":%zu,\"ratio\":%.3f,\"savedBytes\":%zu,\"tableBytes\":%zu},"
+		"\"maximumDepth\":%zu,\"emittedBytes\":%zu}\n",
+		telemetry->programs,
+		telemetry->sourceBytes,
+		telemetry->parsingSeconds,
+		telemetry->computationSeconds,
+		telemetry->generationSeconds,
+		telemetry->releaseSeconds,
+		telemetry->tokens.additions,
+		telemetry->tokens.closeParentheses,
+		telemetry->tokens.divisions,
+		telemetry->tokens.identifiers,
+		telemetry->tokens.integers,
+		telemetry->tokens.multiplications,
+		telemetry->tokens.openParentheses,
+		telemetry->tokens.subtractions,
+		telemetry->tokens.unknowns,
+		telemetry->nodes.constants,
+		telemetry->nodes.expressions,
+		telemetry->nodes.parentheses,
+		telemetry->nodes.programs,
+		telemetry->nodes.variables,
+		telemetry->hashConsing.nodes,
+		telemetry->hashConsing.sharedNodes,
+		telemetry->hashConsing.sharedNodes < telemetry->hashConsing.nodes
+			? (double) telemetry->hashConsing.nodes / (telemetry->hashConsing.nodes - telemetry->hashConsing.sharedNodes)
+			: 1.0,
+		telemetry->hashConsing.savedBytes,
+		telemetry->hashConsing.tableBytes,
+		telemetry->maximumDepth,
+		telemetry->emittedBytes);
+	if (stream != stderr && fclose(stream) != 0) {
+		logError(_logger, "The telemetry cannot be written into \"%s\": %s.", _path, strerror(errno));
+	}
+}
+
+double telemetrySeconds() {
+	struct timespec timespec;
+	clock_gettime(CLOCK_MONOTONIC, &timespec);
+	return timespec.tv_sec + timespec.tv_nsec / 1e9;
+}
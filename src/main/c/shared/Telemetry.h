@@ -0,0 +1,118 @@
+#ifndef TELEMETRY_HEADER
+#define TELEMETRY_HEADER
+
+#include "Environment.h"
+#include "Logger.h"
+#include "Memory.h"
+#include "Type.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** Initialize module's internal state. */
+void initializeTelemetryModule();
+
+/** Shutdown module's internal state. */
+void shutdownTelemetryModule();
+
+/**
+ * The amount of tokens of each kind, as returned to the parser.
+ */
+typedef struct {
+	size_t additions;
+	size_t closeParentheses;
+	size_t divisions;
+	size_t identifiers;
+	size_t integers;
+	size_t multiplications;
+	size_t openParentheses;
+	size_t subtractions;
+	size_t unknowns;
+} TokenCounters;
+
+/**
+ * The amount of nodes in the AST (every node is an expression, besides the
+ * program), of the ones that are constants or variables, and of the pairs of
+ * parentheses kept in them.
+ */
+typedef struct {
+	size_t constants;
+	size_t expressions;
+	size_t parentheses;
+	size_t programs;
+	size_t variables;
+} NodeCounters;
+
+/**
+ * The effect of sharing the identical nodes of the AST (hash-consing): the
+ * nodes requested by the parser, the ones shared instead of allocated, the
+ * bytes that they would have taken, and the peak size of the table.
+ */
+typedef struct {
+	size_t nodes;
+	size_t sharedNodes;
+	size_t savedBytes;
+	size_t tableBytes;
+} HashConsingCounters;
+
+/**
+ * The measurements of one or more compilations, to attribute their latency
+ * without a profiler. The timings are taken from a monotonic clock, and the
+ * ones of many compilations are added up.
+ */
+typedef struct {
+	// The amount of programs compiled, and of bytes in their sources.
+	size_t programs;
+	size_t sourceBytes;
+
+	// The time spent in each phase, in seconds (in evaluation mode, the value
+	// is computed while parsing).
+	double parsingSeconds;
+	double computationSeconds;
+	double generationSeconds;
+	double releaseSeconds;
+
+	TokenCounters tokens;
+	NodeCounters nodes;
+	HashConsingCounters hashConsing;
+
+	// The depth of the deepest AST, in nodes.
+	size_t maximumDepth;
+
+	// The amount of bytes emitted by the generator.
+	size_t emittedBytes;
+} Telemetry;
+
+/**
+ * Creates an empty telemetry, or returns NULL if the telemetry is disabled
+ * (i.e., unless the "TELEMETRY" variable is "true"), so the compilation can
+ * skip every measurement.
+ */
+Telemetry * createTelemetry();
+
+/**
+ * Destroys a telemetry (which can be NULL).
+ */
+void destroyTelemetry(Telemetry * telemetry);
+
+/**
+ * Adds up the measurements of another telemetry (e.g., the one of a worker
+ * of a batch) into this one.
+ */
+void mergeTelemetry(Telemetry * telemetry, const Telemetry * other);
+
+/**
+ * Writes the telemetry as a single JSON line, at the end of the file in the
+ * "TELEMETRY_FILE" variable, or into the standard error if it's undefined.
+ */
+void reportTelemetry(const Telemetry * telemetry);
+
+/**
+ * Reads a monotonic clock, in seconds. Only the difference between two
+ * readings is meaningful.
+ */
+double telemetrySeconds();
+
+#endif
@@ -0,0 +1,110 @@
+#include "Writer.h"
+
+/* PRIVATE FUNCTIONS */
+
+static void _send(Writer * writer, const char * bytes, const size_t length);
+
+/**
+ * Sends the bytes to the underlying stream, bypassing the buffer.
+ */
+static void _send(Writer * writer, const char * bytes, const size_t length) {
+	if (0 < length && fwrite(bytes, sizeof(char), length, writer->stream) < length) {
+		writer->failed = true;
+	}
+}
+
+/* PUBLIC FUNCTIONS */
+
+Writer * createWriter(FILE * stream, const size_t capacity, const boolean flushEveryLine) {
+	Writer * writer = allocateZeroedMemory(1, sizeof(Writer));
+	writer->stream = stream;
+	writer->buffer = allocateZeroedMemory(capacity, sizeof(char));
+	writer->capacity = capacity;
+	writer->flushEveryLine = flushEveryLine;
+	return writer;
+}
+
+boolean destroyWriter(Writer * writer) {
+	boolean succeed = true;
+	if (writer != NULL) {
+		succeed = flushWriter(writer);
+		if (writer->buffer != NULL) {
+			releaseMemory(writer->buffer);
+		}
+		releaseMemory(writer);
+	}
+	return succeed;
+}
+
+boolean flushWriter(Writer * writer) {
+	_send(writer, writer->buffer, writer->length);
+	writer->length = 0;
+	if (fflush(writer->stream) != 0) {
+		writer->failed = true;
+	}
+	return writer->failed ? false : true;
+}
+
+void writeBytes(Writer * writer, const char * bytes, const size_t length) {
+	writer->writtenBytes += length;
+	if (writer->capacity - writer->length < length) {
+		_send(writer, writer->buffer, writer->length);
+		writer->length = 0;
+	}
+	if (writer->capacity < length) {
+		_send(writer, bytes, length);
+	}
+	else {
+		memcpy(writer->buffer + writer->length, bytes, length);
+		writer->length += length;
+	}
+	if (writer->flushEveryLine && 0 < length && bytes[length - 1] == '\n') {
+		flushWriter(writer);
+	}
+}
+
+void writeCharacter(Writer * writer, const char character) {
+	writeBytes(writer, &character, 1);
+}
+
+void writeInteger(Writer * writer, const int integer) {
+	char digits[3 * sizeof(int) + 1];
+	unsigned int magnitude = integer < 0 ? -((unsigned int) integer) : (unsigned int) integer;
+	unsigned int k = sizeof(digits);
+	do {
+		digits[--k] = '0' + (magnitude % 10);
+		magnitude /= 10;
+	} while (0 < magnitude);
+	if (integer < 0) {
+		digits[--k] = '-';
+	}
+	writeBytes(writer, digits + k, sizeof(digits) - k);
+}
+
+void writeLargeInteger(Writer * writer, const Integer integer) {
+	if (integer.big != NULL) {
+		char * digits = integerToString(integer);
+		if (digits == NULL) {
+			writer->failed = true;
+			return;
+		}
+		writeString(writer, digits);
+		releaseMemory(digits);
+		return;
+	}
+	char digits[3 * sizeof(int64_t) + 1];
+	uint64_t magnitude = integer.small < 0 ? -((uint64_t) integer.small) : (uint64_t) integer.small;
+	unsigned int k = sizeof(digits);
+	do {
+		digits[--k] = '0' + (magnitude % 10);
+		magnitude /= 10;
+	} while (0 < magnitude);
+	if (integer.small < 0) {
+		digits[--k] = '-';
+	}
+	writeBytes(writer, digits + k, sizeof(digits) - k);
+}
+
+void writeString(Writer * writer, const char * string) {
+	writeBytes(writer, string, strlen(string));
+}
@@ -0,0 +1,83 @@
+#ifndef WRITER_HEADER
+#define WRITER_HEADER
+
+#include "Integer.h"
+#include "Memory.h"
+#include "Type.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The default size of the buffer of a writer, in bytes.
+ */
+#define WRITER_DEFAULT_CAPACITY (64 * 1024)
+
+/**
+ * A buffered output sink. The bytes are accumulated in memory and sent to the
+ * underlying stream in large chunks, only when the buffer is full or when the
+ * writer is flushed (or after every line, if requested, for debugging).
+ */
+typedef struct {
+	// The destination of the bytes.
+	FILE * stream;
+
+	// The pending bytes, and the amount of them.
+	char * buffer;
+	size_t capacity;
+	size_t length;
+
+	// If true, flushes the writer after every line.
+	boolean flushEveryLine;
+
+	// If true, at least one write to the stream failed.
+	boolean failed;
+
+	// The amount of bytes written so far (including the pending ones).
+	size_t writtenBytes;
+} Writer;
+
+/**
+ * Creates a new writer over the specified stream, with a buffer of the
+ * specified capacity.
+ */
+Writer * createWriter(FILE * stream, const size_t capacity, const boolean flushEveryLine);
+
+/**
+ * Flushes the writer, and destroys it and its resources. The stream is not
+ * closed. Returns false if any write to the stream failed.
+ */
+boolean destroyWriter(Writer * writer);
+
+/**
+ * Sends the pending bytes to the stream, and flushes the stream. Returns false
+ * if any write to the stream failed.
+ */
+boolean flushWriter(Writer * writer);
+
+/**
+ * Writes a sequence of bytes of the specified length.
+ */
+void writeBytes(Writer * writer, const char * bytes, const size_t length);
+
+/**
+ * Writes a single character.
+ */
+void writeCharacter(Writer * writer, const char character);
+
+/**
+ * Writes a decimal integer, without any formatting.
+ */
+void writeInteger(Writer * writer, const int integer);
+
+/**
+ * Writes a decimal integer of any size, without any formatting.
+ */
+void writeLargeInteger(Writer * writer, const Integer integer);
+
+/**
+ * Writes a null-terminated string.
+ */
+void writeString(Writer * writer, const char * string);
+
+#endif
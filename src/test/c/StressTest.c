@@ -0,0 +1,289 @@
+#include "../../main/c/backend/code-generation/Generator.h"
+#include "../../main/c/backend/domain-specific/Calculator.h"
+#include "../../main/c/backend/native-code/NativeCode.h"
+#include "../../main/c/backend/virtual-machine/Bytecode.h"
+#include "../../main/c/backend/virtual-machine/VirtualMachine.h"
+#include "../../main/c/driver/Compilation.h"
+#include "../../main/c/frontend/lexical-analysis/FlexActions.h"
+#include "../../main/c/frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../main/c/frontend/syntactic-analysis/BisonActions.h"
+#include "../../main/c/frontend/syntactic-analysis/SyntacticAnalyzer.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The amount of programs generated at random, besides the ones provided in the
+ * arguments, and the amount of times every thread compiles all of them.
+ */
+#define GENERATED_PROGRAMS 64
+#define ITERATIONS 8
+
+/**
+ * A program and the result of compiling it in a single thread, which every
+ * concurrent compilation must reproduce exactly (the values are kept in
+ * decimal, because they can be bigger than 64 bits).
+ */
+typedef struct {
+	char * source;
+	size_t length;
+	CompilationStatus status[3];
+	char * value[3];
+	char * output[3];
+	size_t outputLength[3];
+} TestProgram;
+
+/**
+ * The state of a single thread of the test.
+ */
+typedef struct {
+	pthread_t thread;
+	unsigned int index;
+	TestProgram * programs;
+	unsigned int programsCount;
+	unsigned int compilations;
+	unsigned int mismatches;
+} Worker;
+
+/* PRIVATE FUNCTIONS */
+
+static void _append(char ** buffer, size_t * length, size_t * capacity, const char * string);
+static CompilationStatus _compile(const TestProgram * program, const CompilationMode mode, char ** value, char ** output, size_t * outputLength);
+static void _generateExpression(char ** buffer, size_t * length, size_t * capacity, unsigned int * seed, const unsigned int depth);
+static char * _generateProgram(unsigned int seed, size_t * length);
+static unsigned int _random(unsigned int * seed);
+static char * _readFile(const char * path, size_t * length);
+static void * _work(void * argument);
+
+/**
+ * Appends a null-terminated string to a growable buffer.
+ */
+static void _append(char ** buffer, size_t * length, size_t * capacity, const char * string) {
+	const size_t stringLength = strlen(string);
+	while (*capacity < *length + stringLength + 1) {
+		*capacity = *capacity == 0 ? 256 : 2 * *capacity;
+		*buffer = realloc(*buffer, *capacity);
+	}
+	memcpy(*buffer + *length, string, stringLength + 1);
+	*length += stringLength;
+}
+
+/**
+ * Compiles a program from memory, with an arena of its own, and captures its
+ * final output in memory too (and its value in decimal, if it succeeds).
+ */
+static CompilationStatus _compile(const TestProgram * program, const CompilationMode mode, char ** value, char ** output, size_t * outputLength) {
+	*output = NULL;
+	*outputLength = 0;
+	CompilerState compilerState = {
+		.abstractSyntaxtTree = NULL,
+		.arena = createArena(ARENA_DEFAULT_BLOCK_SIZE),
+		.computed = false,
+		.input = NULL,
+		.mode = mode,
+		.nodeTable = NULL,
+		.output = open_memstream(output, outputLength),
+		.scanInPlace = false,
+		.scanner = NULL,
+		.source = program->source,
+		.sourceLength = program->length,
+		.spilledTree = NULL,
+		.succeed = false,
+		.telemetry = NULL,
+		.tokenRing = NULL,
+		.value = {
+			.big = NULL,
+			.small = 0
+		}
+	};
+	const CompilationStatus compilationStatus = compile(&compilerState);
+	fclose(compilerState.output);
+	*value = compilationStatus == SUCCEED ? integerToString(compilerState.value) : NULL;
+	destroyArena(compilerState.arena);
+	return compilationStatus;
+}
+
+/**
+ * Generates a random expression, with comments, and with a nesting depth up
+ * to the specified one.
+ */
+static void _generateExpression(char ** buffer, size_t * length, size_t * capacity, unsigned int * seed, const unsigned int depth) {
+	static const char * operators[] = { " + ", " - ", " * ", " / " };
+	char integer[16];
+	if (depth == 0 || _random(seed) % 4 == 0) {
+		snprintf(integer, sizeof(integer), "%u", _random(seed) % 100);
+		_append(buffer, length, capacity, integer);
+		return;
+	}
+	_append(buffer, length, capacity, "(");
+	_generateExpression(buffer, length, capacity, seed, depth - 1);
+	_append(buffer, length, capacity, operators[_random(seed) % 4]);
+	if (_random(seed) % 8 == 0) {
+		_append(buffer, length, capacity, "/* a comment\n across lines */ ");
+	}
+	_generateExpression(buffer, length, capacity, seed, depth - 1);
+	_append(buffer, length, capacity, ")");
+}
+
+/**
+ * Generates a random program from a seed (some of them divide by zero, so
+ * they are rejected).
+ */
+static char * _generateProgram(unsigned int seed, size_t * length) {
+	char * buffer = NULL;
+	size_t capacity = 0;
+	*length = 0;
+	_generateExpression(&buffer, length, &capacity, &seed, 8);
+	return buffer;
+}
+
+/**
+ * A tiny pseudo-random generator (xorshift), so every run generates the same
+ * programs.
+ */
+static unsigned int _random(unsigned int * seed) {
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 17;
+	*seed ^= *seed << 5;
+	return *seed;
+}
+
+/**
+ * Reads an entire file into memory, or returns NULL if it cannot be read.
+ */
+static char * _readFile(const char * path, size_t * length) {
+	FILE * file = fopen(path, "rb");
+	if (file == NULL) {
+		return NULL;
+	}
+	char * buffer = NULL;
+	size_t capacity = 0;
+	*length = 0;
+	do {
+		capacity = capacity == 0 ? 4096 : 2 * capacity;
+		buffer = realloc(buffer, capacity);
+		*length += fread(buffer + *length, 1, capacity - *length, file);
+	} while (*length == capacity);
+	fclose(file);
+	return buffer;
+}
+
+/**
+ * Compiles every program many times, in every mode, starting at a different
+ * program in each thread, and compares the results with the reference ones.
+ */
+static void * _work(void * argument) {
+	Worker * worker = argument;
+	for (unsigned int iteration = 0; iteration < ITERATIONS; ++iteration) {
+		for (unsigned int k = 0; k < worker->programsCount; ++k) {
+			const TestProgram * program = &worker->programs[(k + worker->index) % worker->programsCount];
+			for (unsigned int mode = GENERATION_MODE; mode <= STREAMING_MODE; ++mode) {
+				char * value = NULL;
+				char * output = NULL;
+				size_t outputLength = 0;
+				const CompilationStatus status = _compile(program, mode, &value, &output, &outputLength);
+				if (status != program->status[mode]
+					|| (value == NULL) != (program->value[mode] == NULL)
+					|| (value != NULL && strcmp(value, program->value[mode]) != 0)
+					|| outputLength != program->outputLength[mode]
+					|| memcmp(output, program->output[mode], outputLength) != 0) {
+					++worker->mismatches;
+				}
+				++worker->compilations;
+				free(output);
+				releaseMemory(value);
+			}
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Compiles the same programs in many threads at once, and checks that every
+ * result is identical to the one obtained without concurrency. The arguments
+ * are the amount of threads, and the paths of extra programs to compile.
+ */
+int main(const int count, const char ** arguments) {
+	setenv("LOGGING_LEVEL", "CRITICAL", 0);
+	initializeFlexActionsModule();
+	initializeBisonActionsModule();
+	initializeSyntacticAnalyzerModule();
+	initializeAbstractSyntaxTreeModule();
+	initializeCalculatorModule();
+	initializeBytecodeModule();
+	initializeVirtualMachineModule();
+	initializeNativeCodeModule();
+	initializeGeneratorModule();
+	initializeCompilationModule();
+
+	const unsigned int threads = count < 2 ? 8 : (unsigned int) atoi(arguments[1]);
+	const unsigned int filesCount = count < 3 ? 0 : count - 2;
+	const unsigned int programsCount = filesCount + GENERATED_PROGRAMS;
+	TestProgram * programs = calloc(programsCount, sizeof(TestProgram));
+	int status = 0;
+	for (unsigned int k = 0; k < programsCount; ++k) {
+		TestProgram * program = &programs[k];
+		if (k < filesCount) {
+			program->source = _readFile(arguments[k + 2], &program->length);
+			if (program->source == NULL) {
+				fprintf(stderr, "The program \"%s\" cannot be read.\n", arguments[k + 2]);
+				status = 1;
+				program->source = calloc(1, sizeof(char));
+			}
+		}
+		else {
+			program->source = _generateProgram(k + 1, &program->length);
+		}
+		for (unsigned int mode = GENERATION_MODE; mode <= STREAMING_MODE; ++mode) {
+			program->status[mode] = _compile(program, mode, &program->value[mode], &program->output[mode], &program->outputLength[mode]);
+		}
+		// The streamed output must be the one generated from the AST.
+		if (program->status[STREAMING_MODE] != program->status[GENERATION_MODE]
+			|| program->outputLength[STREAMING_MODE] != program->outputLength[GENERATION_MODE]
+			|| memcmp(program->output[STREAMING_MODE], program->output[GENERATION_MODE], program->outputLength[GENERATION_MODE]) != 0) {
+			fprintf(stderr, "The program %u is streamed differently than it's generated.\n", k);
+			status = 1;
+		}
+	}
+
+	Worker * workers = calloc(threads, sizeof(Worker));
+	for (unsigned int k = 0; k < threads; ++k) {
+		workers[k].index = k;
+		workers[k].programs = programs;
+		workers[k].programsCount = programsCount;
+		pthread_create(&workers[k].thread, NULL, _work, &workers[k]);
+	}
+	unsigned int compilations = 0;
+	unsigned int mismatches = 0;
+	for (unsigned int k = 0; k < threads; ++k) {
+		pthread_join(workers[k].thread, NULL);
+		compilations += workers[k].compilations;
+		mismatches += workers[k].mismatches;
+	}
+	fprintf(stdout, "%u threads, %u compilations, %u mismatches.\n", threads, compilations, mismatches);
+	if (0 < mismatches) {
+		status = 1;
+	}
+
+	for (unsigned int k = 0; k < programsCount; ++k) {
+		free(programs[k].source);
+		for (unsigned int mode = GENERATION_MODE; mode <= STREAMING_MODE; ++mode) {
+			free(programs[k].output[mode]);
+			releaseMemory(programs[k].value[mode]);
+		}
+	}
+	free(programs);
+	free(workers);
+	shutdownCompilationModule();
+	shutdownGeneratorModule();
+	shutdownNativeCodeModule();
+	shutdownVirtualMachineModule();
+	shutdownBytecodeModule();
+	shutdownCalculatorModule();
+	shutdownAbstractSyntaxTreeModule();
+	shutdownSyntacticAnalyzerModule();
+	shutdownBisonActionsModule();
+	shutdownFlexActionsModule();
+	return status;
+}